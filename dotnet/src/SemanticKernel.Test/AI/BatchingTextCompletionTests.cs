@@ -0,0 +1,189 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text.Json;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.Text;
+using Xunit;
+
+namespace SemanticKernelTests.AI;
+
+public class BatchingTextCompletionTests
+{
+    [Fact]
+    public async Task ItCoalescesConcurrentRequestsAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient();
+        using var target = new BatchingTextCompletion(client, 10, TimeSpan.FromMilliseconds(50));
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        string[] results = await Task.WhenAll(Enumerable.Range(0, 4).Select(x => target.CompleteAsync($"prompt {x}", settings)));
+
+        // Assert
+        Assert.Equal(new[] { "PROMPT 0", "PROMPT 1", "PROMPT 2", "PROMPT 3" }, results);
+        Assert.Equal(new[] { 4 }, client.BatchSizes);
+    }
+
+    [Fact]
+    public async Task ItSendsFullBatchesWithoutWaitingAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient();
+        using var target = new BatchingTextCompletion(client, 2, TimeSpan.FromMinutes(10));
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        string[] results = await Task.WhenAll(Enumerable.Range(0, 4).Select(x => target.CompleteAsync($"prompt {x}", settings)));
+
+        // Assert
+        Assert.Equal(4, results.Length);
+        Assert.Equal(new[] { 2, 2 }, client.BatchSizes);
+    }
+
+    [Fact]
+    public async Task ItDoesNotMixRequestsWithDifferentSettingsAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient();
+        using var target = new BatchingTextCompletion(client, 10, TimeSpan.FromMilliseconds(50));
+
+        // Act
+        await Task.WhenAll(
+            target.CompleteAsync("a", new CompleteRequestSettings { MaxTokens = 10 }),
+            target.CompleteAsync("b", new CompleteRequestSettings { MaxTokens = 10 }),
+            target.CompleteAsync("c", new CompleteRequestSettings { MaxTokens = 20 }));
+
+        // Assert
+        Assert.Equal(new[] { 1, 2 }, client.BatchSizes.OrderBy(x => x));
+    }
+
+    [Fact]
+    public async Task ItFailsAllTheRequestsOfAFailedBatchAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient { Error = new AIException(AIException.ErrorCodes.Throttling, "slow down") };
+        using var target = new BatchingTextCompletion(client, 10, TimeSpan.FromMilliseconds(10));
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        Task<string> first = target.CompleteAsync("a", settings);
+        Task<string> second = target.CompleteAsync("b", settings);
+
+        // Assert
+        await Assert.ThrowsAsync<AIException>(() => first);
+        await Assert.ThrowsAsync<AIException>(() => second);
+    }
+
+    [Fact]
+    public async Task ItRemovesCancelledRequestsFromPendingBatchesAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient();
+        using var target = new BatchingTextCompletion(client, 10, TimeSpan.FromMilliseconds(50));
+        var settings = new CompleteRequestSettings();
+        using var cancel = new CancellationTokenSource();
+
+        // Act
+        Task<string> cancelled = target.CompleteAsync("a", settings, cancel.Token);
+        Task<string> kept = target.CompleteAsync("b", settings);
+        cancel.Cancel();
+
+        // Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => cancelled);
+        Assert.Equal("B", await kept);
+        Assert.Equal(new[] { 1 }, client.BatchSizes);
+    }
+
+    [Fact]
+    public async Task ItFailsOnlyTheInvalidPromptOfABatchAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient { InvalidPrompt = "bad" };
+        using var target = new BatchingTextCompletion(client, 3, TimeSpan.FromMinutes(10));
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        Task<string> first = target.CompleteAsync("a", settings);
+        Task<string> invalid = target.CompleteAsync("bad", settings);
+        Task<string> last = target.CompleteAsync("c", settings);
+
+        // Assert
+        Assert.Equal("A", await first);
+        Assert.Equal("C", await last);
+        var e = await Assert.ThrowsAsync<AIException>(() => invalid);
+        Assert.Equal(AIException.ErrorCodes.InvalidRequest, e.ErrorCode);
+        Assert.Equal(new[] { 1, 1, 1, 3 }, client.BatchSizes.OrderBy(x => x));
+    }
+
+    [Fact]
+    public async Task ItValidatesPromptsBeforeBatchingAsync()
+    {
+        // Arrange
+        var client = new FakeBatchCompletionClient();
+        using var target = new BatchingTextCompletion(
+            client, 2, TimeSpan.FromMilliseconds(50), HeuristicTokenizer.Instance, "text-davinci-003");
+        var settings = new CompleteRequestSettings { MaxTokens = 4000 };
+
+        // Act
+        var e = Assert.Throws<AIException>(() => target.CompleteAsync(string.Join(" ", Enumerable.Repeat("word", 500)), settings));
+        string result = await target.CompleteAsync("a", settings);
+
+        // Assert
+        Assert.Equal(AIException.ErrorCodes.InvalidRequest, e.ErrorCode);
+        Assert.Equal("A", result);
+        Assert.Equal(new[] { 1 }, client.BatchSizes);
+    }
+
+    [Fact]
+    public void ItSerializesMultiplePromptsAsArray()
+    {
+        // Act
+        string json = Json.Serialize(new AzureCompletionRequest { Prompt = new List<string> { "a", "b" } });
+
+        // Assert
+        using var document = JsonDocument.Parse(json);
+        JsonElement prompt = document.RootElement.GetProperty("prompt");
+        Assert.Equal(JsonValueKind.Array, prompt.ValueKind);
+        Assert.Equal(new[] { "a", "b" }, prompt.EnumerateArray().Select(x => x.GetString()));
+    }
+
+    private sealed class FakeBatchCompletionClient : ITextBatchCompletionClient
+    {
+        public ConcurrentQueue<int> BatchSizes { get; } = new();
+
+        public Exception? Error { get; set; }
+
+        // Prompt rejected by the service, failing the whole request
+        public string? InvalidPrompt { get; set; }
+
+        public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+        {
+            this.BatchSizes.Enqueue(1);
+            if (this.Error != null) { throw this.Error; }
+
+            if (text == this.InvalidPrompt) { throw new AIException(AIException.ErrorCodes.InvalidRequest, "Invalid prompt"); }
+
+            return Task.FromResult(text.ToUpperInvariant());
+        }
+
+        public Task<IList<string>> CompleteBatchAsync(IList<string> texts, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+        {
+            this.BatchSizes.Enqueue(texts.Count);
+            if (this.Error != null) { throw this.Error; }
+
+            if (texts.Contains(this.InvalidPrompt)) { throw new AIException(AIException.ErrorCodes.InvalidRequest, "Invalid prompt"); }
+
+            IList<string> result = texts.Select(x => x.ToUpperInvariant()).ToList();
+            return Task.FromResult(result);
+        }
+    }
+}
@@ -0,0 +1,144 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.IO;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Caching;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.AI.Caching;
+
+public class CompletionCacheTests
+{
+    [Fact]
+    public async Task ItReturnsCachedCompletionsAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var cache = new CompletionCache();
+        var target = new CachedTextCompletion(client, cache, "backend", "model");
+        var settings = new CompleteRequestSettings { Temperature = 0 };
+
+        // Act
+        string first = await target.CompleteAsync("hello", settings);
+        string second = await target.CompleteAsync("hello", settings);
+        string third = await target.CompleteAsync("world", settings);
+
+        // Assert
+        Assert.Equal("completion 1 of hello", first);
+        Assert.Equal(first, second);
+        Assert.Equal("completion 2 of world", third);
+        Assert.Equal(2, client.Calls);
+
+        CompletionCacheStats stats = cache.GetStats();
+        Assert.Equal(1, stats.Hits);
+        Assert.Equal(2, stats.Misses);
+        Assert.Equal(2, stats.Count);
+        Assert.Equal(1.0 / 3, stats.HitRate, 6);
+    }
+
+    [Fact]
+    public async Task ItDoesNotCacheNonDeterministicRequestsByDefaultAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var target = new CachedTextCompletion(client, new CompletionCache(), "backend", "model");
+        var settings = new CompleteRequestSettings { Temperature = 0.7 };
+
+        // Act
+        await target.CompleteAsync("hello", settings);
+        await target.CompleteAsync("hello", settings);
+
+        // Assert
+        Assert.Equal(2, client.Calls);
+    }
+
+    [Fact]
+    public void ItIncludesBackendAndSettingsInKeys()
+    {
+        // Arrange
+        var settings = new CompleteRequestSettings { MaxTokens = 100 };
+        var otherSettings = new CompleteRequestSettings { MaxTokens = 200 };
+
+        // Act
+        string key = CompletionCache.CreateKey("backend", "model", "prompt", settings);
+
+        // Assert
+        Assert.Equal(key, CompletionCache.CreateKey("backend", "model", "prompt", new CompleteRequestSettings { MaxTokens = 100 }));
+        Assert.NotEqual(key, CompletionCache.CreateKey("backend", "model", "prompt", otherSettings));
+        Assert.NotEqual(key, CompletionCache.CreateKey("other", "model", "prompt", settings));
+        Assert.NotEqual(key, CompletionCache.CreateKey("backend", "other", "prompt", settings));
+        Assert.NotEqual(key, CompletionCache.CreateKey("backend", "model", "prompt ", settings));
+    }
+
+    [Fact]
+    public async Task ItEvictsLeastRecentlyUsedCompletionsAsync()
+    {
+        // Arrange - room for about 3 entries
+        var cache = new CompletionCache(new CompletionCacheOptions { MaxMemorySize = 3 * (128 + (2 * 10)) });
+        await cache.SetAsync("k1", "12345678");
+        await cache.SetAsync("k2", "12345678");
+        await cache.SetAsync("k3", "12345678");
+
+        // Act
+        await cache.TryGetAsync("k1");
+        await cache.SetAsync("k4", "12345678");
+
+        // Assert
+        Assert.NotNull(await cache.TryGetAsync("k1"));
+        Assert.Null(await cache.TryGetAsync("k2"));
+        Assert.NotNull(await cache.TryGetAsync("k3"));
+        Assert.NotNull(await cache.TryGetAsync("k4"));
+        Assert.Equal(1, cache.GetStats().Evictions);
+        Assert.Equal(3, cache.GetStats().Count);
+    }
+
+    [Fact]
+    public async Task ItExpiresCompletionsAsync()
+    {
+        // Arrange
+        var now = new DateTimeOffset(2023, 1, 1, 0, 0, 0, TimeSpan.Zero);
+        var cache = new CompletionCache(new CompletionCacheOptions { TimeToLive = TimeSpan.FromMinutes(5) }, () => now);
+        await cache.SetAsync("key", "value");
+
+        // Act
+        now = now.AddMinutes(4);
+        string? beforeExpiration = await cache.TryGetAsync("key");
+        now = now.AddMinutes(2);
+        string? afterExpiration = await cache.TryGetAsync("key");
+
+        // Assert
+        Assert.Equal("value", beforeExpiration);
+        Assert.Null(afterExpiration);
+        Assert.Equal(0, cache.GetStats().Count);
+    }
+
+    [Fact]
+    public async Task ItPersistsCompletionsInDirectoryAsync()
+    {
+        // Arrange
+        string directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+        try
+        {
+            var options = new CompletionCacheOptions { Directory = directory };
+            var cache = new CompletionCache(options);
+            await cache.SetAsync("key", "value");
+
+            // Act
+            var otherCache = new CompletionCache(options);
+            string? result = await otherCache.TryGetAsync("key");
+
+            // Assert
+            Assert.Equal("value", result);
+            Assert.Equal(1, otherCache.GetStats().StorageHits);
+            Assert.Equal("value", await otherCache.TryGetAsync("key"));
+            Assert.Equal(1, otherCache.GetStats().MemoryHits);
+        }
+        finally
+        {
+            Directory.Delete(directory, true);
+        }
+    }
+}
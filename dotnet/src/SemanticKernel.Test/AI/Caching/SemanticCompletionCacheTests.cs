@@ -0,0 +1,127 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Caching;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.AI.Caching;
+
+public class SemanticCompletionCacheTests
+{
+    [Fact]
+    public async Task ItReusesCompletionsOfSimilarPromptsAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var cache = new SemanticCompletionCache(new FakeEmbeddingGenerator());
+        var target = new SemanticCachedTextCompletion(client, cache, "backend", "model");
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        string first = await target.CompleteAsync("tell me about the cat", settings);
+        string similar = await target.CompleteAsync("Tell me about  the cat ", settings);
+        string different = await target.CompleteAsync("tell me about the dog", settings);
+
+        // Assert
+        Assert.Equal(first, similar);
+        Assert.NotEqual(first, different);
+        Assert.Equal(2, client.Calls);
+        Assert.Equal(1, cache.Hits);
+        Assert.Equal(2, cache.Misses);
+    }
+
+    [Fact]
+    public async Task ItDoesNotReuseCompletionsAcrossSettingsAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var target = new SemanticCachedTextCompletion(client, new SemanticCompletionCache(new FakeEmbeddingGenerator()), "backend", "model");
+
+        // Act
+        await target.CompleteAsync("the cat", new CompleteRequestSettings { MaxTokens = 10 });
+        await target.CompleteAsync("the cat", new CompleteRequestSettings { MaxTokens = 20 });
+
+        // Assert
+        Assert.Equal(2, client.Calls);
+    }
+
+    [Fact]
+    public async Task ItDoesNotCacheNonDeterministicRequestsByDefaultAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var generator = new FakeEmbeddingGenerator();
+        var target = new SemanticCachedTextCompletion(client, new SemanticCompletionCache(generator), "backend", "model");
+        var settings = new CompleteRequestSettings { Temperature = 0.5 };
+
+        // Act
+        await target.CompleteAsync("the cat", settings);
+        await target.CompleteAsync("the cat", settings);
+
+        // Assert
+        Assert.Equal(2, client.Calls);
+        Assert.Equal(0, generator.Calls);
+    }
+
+    [Fact]
+    public async Task ItRemovesTheLeastRecentlyUsedCompletionsAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var cache = new SemanticCompletionCache(new FakeEmbeddingGenerator(), maxEntries: 2);
+        var target = new SemanticCachedTextCompletion(client, cache, "backend", "model");
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        await target.CompleteAsync("cat", settings);
+        await target.CompleteAsync("dog", settings);
+        await target.CompleteAsync("cat", settings);
+        await target.CompleteAsync("car", settings);
+        await target.CompleteAsync("cat", settings);
+        await target.CompleteAsync("dog", settings);
+
+        // Assert - "dog" was the least recently used when "car" was added
+        Assert.Equal(4, client.Calls);
+        Assert.Equal(2, cache.Count);
+    }
+
+    [Fact]
+    public async Task ItExpiresCompletionsAsync()
+    {
+        // Arrange
+        var now = DateTimeOffset.UtcNow;
+        var client = new CountingCompletionClient();
+        var cache = new SemanticCompletionCache(new FakeEmbeddingGenerator(), null, SemanticCompletionCache.DefaultMinSimilarity,
+            false, SemanticCompletionCache.DefaultMaxEntries, TimeSpan.FromMinutes(1), () => now);
+        var target = new SemanticCachedTextCompletion(client, cache, "backend", "model");
+        var settings = new CompleteRequestSettings();
+
+        // Act
+        await target.CompleteAsync("cat", settings);
+        await target.CompleteAsync("cat", settings);
+        now += TimeSpan.FromMinutes(2);
+        await target.CompleteAsync("cat", settings);
+
+        // Assert
+        Assert.Equal(2, client.Calls);
+        Assert.Equal(1, cache.Hits);
+    }
+
+    [Fact]
+    public async Task ItHandlesEmbeddingFailuresAsCacheMissesAsync()
+    {
+        // Arrange
+        var client = new CountingCompletionClient();
+        var target = new SemanticCachedTextCompletion(client, new SemanticCompletionCache(new FailingEmbeddingGenerator()), "backend", "model");
+
+        // Act
+        string result = await target.CompleteAsync("the cat", new CompleteRequestSettings());
+
+        // Assert
+        Assert.Equal("completion 1 of the cat", result);
+        Assert.Equal(1, client.Calls);
+    }
+}
@@ -0,0 +1,88 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Linq;
+using System.Text.Json;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Xunit;
+
+namespace SemanticKernelTests.AI.Embeddings;
+
+public class HalfPrecisionTests
+{
+    [Fact]
+    public void ItConvertsAllFloat16ValuesLikeSystemHalf()
+    {
+        for (int i = 0; i <= ushort.MaxValue; i++)
+        {
+            // Arrange
+            var target = new Float16((ushort)i);
+            float expected = (float)BitConverter.Int16BitsToHalf((short)i);
+
+            // Act
+            float actual = target;
+
+            // Assert
+            if (float.IsNaN(expected))
+            {
+                Assert.True(float.IsNaN(actual));
+            }
+            else
+            {
+                Assert.Equal(BitConverter.SingleToInt32Bits(expected), BitConverter.SingleToInt32Bits(actual));
+            }
+        }
+    }
+
+    [Fact]
+    public void ItRoundsFloatsToFloat16LikeSystemHalf()
+    {
+        // Arrange
+        var random = new Random(11);
+        var values = Enumerable.Range(0, 10000)
+            .Select(_ => BitConverter.Int32BitsToSingle(random.Next(int.MinValue, int.MaxValue)))
+            .Where(x => !float.IsNaN(x))
+            .Concat(new[] { 0F, -0F, 65504F, 65520F, 1e-8F, 6.1e-5F, float.PositiveInfinity, float.NegativeInfinity });
+
+        foreach (float value in values)
+        {
+            // Act
+            var actual = (Float16)value;
+
+            // Assert
+            Assert.Equal(BitConverter.HalfToInt16Bits((Half)value), (short)actual.Bits);
+        }
+    }
+
+    [Fact]
+    public void ItConvertsBFloat16()
+    {
+        // Assert
+        Assert.Equal(1.0F, (float)(BFloat16)1.0F);
+        Assert.Equal(-2.5F, (float)(BFloat16)(-2.5F));
+        Assert.Equal(3.3895314e38F, (float)(BFloat16)3.3895314e38F);
+        Assert.Equal(0x3F80, ((BFloat16)1.00390625F).Bits); // tie, rounds to even
+        Assert.Equal(0x3F82, ((BFloat16)1.01171875F).Bits); // tie, rounds to even
+        Assert.True(float.IsNaN((BFloat16)float.NaN));
+        Assert.True(float.IsPositiveInfinity((BFloat16)float.PositiveInfinity));
+    }
+
+    [Fact]
+    public void ItSerializesHalfPrecisionEmbeddings()
+    {
+        // Arrange
+        var float16 = new Embedding<Float16>(new[] { (Float16)0.5F, (Float16)(-2F) });
+        var bfloat16 = new Embedding<BFloat16>(new[] { (BFloat16)0.5F, (BFloat16)(-2F) });
+
+        // Act
+        string float16Json = JsonSerializer.Serialize(float16);
+        string bfloat16Json = JsonSerializer.Serialize(bfloat16);
+        var float16Copy = JsonSerializer.Deserialize<Embedding<Float16>>(float16Json);
+        var bfloat16Copy = JsonSerializer.Deserialize<Embedding<BFloat16>>(bfloat16Json);
+
+        // Assert
+        Assert.Equal("{\"vector\":[0.5,-2]}", float16Json);
+        Assert.True(float16Copy.Vector.SequenceEqual(float16.Vector));
+        Assert.True(bfloat16Copy.Vector.SequenceEqual(bfloat16.Vector));
+    }
+}
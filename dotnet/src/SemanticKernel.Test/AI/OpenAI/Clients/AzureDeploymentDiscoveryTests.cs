@@ -0,0 +1,123 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging.Abstractions;
+using Microsoft.SemanticKernel.AI.OpenAI.Clients;
+using Xunit;
+
+namespace SemanticKernelTests.AI.OpenAI.Clients;
+
+public class AzureDeploymentDiscoveryTests
+{
+    [Fact]
+    public async Task ItFetchesTheDeploymentsOnceForConcurrentCallersAsync()
+    {
+        // Arrange
+        var now = DateTimeOffset.UtcNow;
+        var target = new AzureDeploymentDiscovery(() => now);
+        var fetch = new TaskCompletionSource<AzureDeploymentDiscovery.Snapshot>();
+        int fetchCount = 0;
+
+        // Act
+        var callers = Enumerable.Range(0, 5).Select(_ => target.GetAsync(() =>
+        {
+            fetchCount++;
+            return fetch.Task;
+        }, NullLogger.Instance)).ToList();
+        fetch.SetResult(CreateSnapshot(now, ("gpt", "text-davinci-003")));
+        await Task.WhenAll(callers);
+
+        // Assert
+        Assert.Equal(1, fetchCount);
+        Assert.All(callers, x => Assert.Same(target.Current, x.Result));
+    }
+
+    [Fact]
+    public async Task ItStopsWaitingWithoutCancellingTheSharedFetchAsync()
+    {
+        // Arrange
+        var now = DateTimeOffset.UtcNow;
+        var target = new AzureDeploymentDiscovery(() => now);
+        var fetch = new TaskCompletionSource<AzureDeploymentDiscovery.Snapshot>();
+        using var cancel = new CancellationTokenSource();
+        var cancelled = target.GetAsync(() => fetch.Task, NullLogger.Instance, cancel.Token);
+        var waiting = target.GetAsync(() => fetch.Task, NullLogger.Instance);
+
+        // Act
+        cancel.Cancel();
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => cancelled);
+        fetch.SetResult(CreateSnapshot(now, ("gpt", "text-davinci-003")));
+
+        // Assert
+        Assert.Same(target.Current, await waiting);
+        Assert.NotNull(target.Current);
+    }
+
+    [Fact]
+    public async Task ItReturnsStaleDeploymentsWhileRefreshingAsync()
+    {
+        // Arrange
+        var now = DateTimeOffset.UtcNow;
+        var target = new AzureDeploymentDiscovery(() => now);
+        var first = CreateSnapshot(now, ("gpt", "text-davinci-003"));
+        await target.GetAsync(() => Task.FromResult(first), NullLogger.Instance);
+        now += AzureDeploymentDiscovery.TimeToLive + TimeSpan.FromSeconds(1);
+        var refresh = new TaskCompletionSource<AzureDeploymentDiscovery.Snapshot>();
+
+        // Act
+        var result = await target.GetAsync(() => refresh.Task, NullLogger.Instance);
+        var second = CreateSnapshot(now, ("gpt", "text-davinci-003"), ("new", "gpt-35-turbo"));
+        refresh.SetResult(second);
+        await target.RefreshAsync(() => Task.FromResult(second));
+
+        // Assert
+        Assert.Same(first, result);
+        Assert.True(target.Current!.TryGetDeployment("gpt-35-turbo", out string deploymentName));
+        Assert.Equal("new", deploymentName);
+    }
+
+    [Fact]
+    public async Task ItLimitsRefreshesCausedByMissingModelsAsync()
+    {
+        // Arrange
+        var now = DateTimeOffset.UtcNow;
+        var target = new AzureDeploymentDiscovery(() => now);
+        var snapshot = await target.GetAsync(() => Task.FromResult(CreateSnapshot(now, ("gpt", "text-davinci-003"))), NullLogger.Instance);
+
+        // Act
+        bool canRefreshNow = target.CanRefresh(snapshot);
+        now += AzureDeploymentDiscovery.MinRefreshInterval;
+        bool canRefreshLater = target.CanRefresh(snapshot);
+
+        // Assert
+        Assert.False(canRefreshNow);
+        Assert.True(canRefreshLater);
+    }
+
+    [Fact]
+    public void ItFindsDeploymentsByNameOrModel()
+    {
+        // Arrange
+        var target = CreateSnapshot(DateTimeOffset.UtcNow, ("gpt", "text-davinci-003"));
+
+        // Act
+        bool byName = target.TryGetDeployment("gpt", out string nameResult);
+        bool byModel = target.TryGetDeployment("text-davinci-003", out string modelResult);
+        bool missing = target.TryGetDeployment("ada", out _);
+
+        // Assert
+        Assert.True(byName);
+        Assert.True(byModel);
+        Assert.False(missing);
+        Assert.Equal("gpt", nameResult);
+        Assert.Equal("gpt", modelResult);
+    }
+
+    private static AzureDeploymentDiscovery.Snapshot CreateSnapshot(DateTimeOffset fetchedAt, params (string Deployment, string Model)[] deployments)
+    {
+        return new AzureDeploymentDiscovery.Snapshot(deployments.ToDictionary(x => x.Deployment, x => x.Model), fetchedAt);
+    }
+}
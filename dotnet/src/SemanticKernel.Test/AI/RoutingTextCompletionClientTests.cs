@@ -0,0 +1,155 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.AI;
+
+public class RoutingTextCompletionClientTests
+{
+    [Fact]
+    public async Task ItSpreadsRequestsAcrossBackendsAsync()
+    {
+        // Arrange
+        var backends = new[] { new FakeCompletionClient("a"), new FakeCompletionClient("b") };
+        using var target = new RoutingTextCompletionClient(backends);
+
+        // Act
+        for (int i = 0; i < 10; i++) { await target.CompleteAsync("prompt", new CompleteRequestSettings()); }
+
+        // Assert
+        Assert.All(backends, x => Assert.True(x.RequestCount > 0));
+    }
+
+    [Fact]
+    public async Task ItPrefersFasterBackendsAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var slow = new FakeCompletionClient("slow") { OnRequest = () => clock.Advance(TimeSpan.FromMilliseconds(500)) };
+        var fast = new FakeCompletionClient("fast") { OnRequest = () => clock.Advance(TimeSpan.FromMilliseconds(50)) };
+        using var target = new RoutingTextCompletionClient(new[] { slow, fast }, 3, null, null, clock.Now);
+
+        // Act
+        for (int i = 0; i < 20; i++) { await target.CompleteAsync("prompt", new CompleteRequestSettings()); }
+
+        // Assert: each backend is measured, then the fast one is used
+        Assert.Equal(1, slow.RequestCount);
+        Assert.Equal(19, fast.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItFailsOverToTheNextBackendAsync()
+    {
+        // Arrange
+        var failing = new FakeCompletionClient("failing") { Error = new AIException(AIException.ErrorCodes.Throttling, "throttled") };
+        var healthy = new FakeCompletionClient("healthy");
+        using var target = new RoutingTextCompletionClient(new[] { failing, healthy });
+
+        // Act
+        string[] results = await Task.WhenAll(Enumerable.Range(0, 4).Select(_ => target.CompleteAsync("prompt", new CompleteRequestSettings())));
+
+        // Assert
+        Assert.All(results, x => Assert.Equal("healthy", x));
+    }
+
+    [Fact]
+    public async Task ItDoesNotFailOverInvalidRequestsAsync()
+    {
+        // Arrange
+        var invalid = new AIException(AIException.ErrorCodes.InvalidRequest, "invalid");
+        var backends = new[] { new FakeCompletionClient("a") { Error = invalid }, new FakeCompletionClient("b") { Error = invalid } };
+        using var target = new RoutingTextCompletionClient(backends);
+
+        // Act
+        await Assert.ThrowsAsync<AIException>(() => target.CompleteAsync("prompt", new CompleteRequestSettings()));
+
+        // Assert
+        Assert.Equal(1, backends.Sum(x => x.RequestCount));
+    }
+
+    [Fact]
+    public async Task ItEjectsFailingBackendsAndProbesThemLaterAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var failing = new FakeCompletionClient("failing") { Error = new AIException(AIException.ErrorCodes.ServiceError, "error") };
+        var healthy = new FakeCompletionClient("healthy");
+        using var target = new RoutingTextCompletionClient(new[] { failing, healthy }, 2, TimeSpan.FromSeconds(30), null, clock.Now);
+
+        // Act
+        for (int i = 0; i < 10; i++) { await target.CompleteAsync("prompt", new CompleteRequestSettings()); }
+
+        int requestsWhileEjected = failing.RequestCount;
+        failing.Error = null;
+        clock.Advance(TimeSpan.FromSeconds(31));
+        for (int i = 0; i < 10; i++) { await target.CompleteAsync("prompt", new CompleteRequestSettings()); }
+
+        // Assert
+        Assert.Equal(2, requestsWhileEjected);
+        Assert.True(failing.RequestCount > requestsWhileEjected);
+        Assert.Equal(0, target.EjectedCount);
+    }
+
+    [Fact]
+    public async Task ItThrowsWhenAllBackendsFailAsync()
+    {
+        // Arrange
+        var error = new AIException(AIException.ErrorCodes.ServiceError, "error");
+        var backends = new[] { new FakeCompletionClient("a") { Error = error }, new FakeCompletionClient("b") { Error = error } };
+        using var target = new RoutingTextCompletionClient(backends);
+
+        // Act
+        var exception = await Assert.ThrowsAsync<AIException>(() => target.CompleteAsync("prompt", new CompleteRequestSettings()));
+
+        // Assert
+        Assert.Equal(AIException.ErrorCodes.ServiceError, exception.ErrorCode);
+        Assert.All(backends, x => Assert.Equal(1, x.RequestCount));
+    }
+
+    [Fact]
+    public async Task ItDoesNotFailOverCancelledRequestsAsync()
+    {
+        // Arrange
+        using var cancel = new CancellationTokenSource();
+        var backends = new[] { new FakeCompletionClient("a"), new FakeCompletionClient("b") };
+        foreach (FakeCompletionClient backend in backends)
+        {
+            backend.OnRequest = () => cancel.Cancel();
+            backend.Error = new OperationCanceledException(cancel.Token);
+        }
+
+        using var target = new RoutingTextCompletionClient(backends, failureThreshold: 1);
+
+        // Act
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => target.CompleteAsync("prompt", new CompleteRequestSettings(), cancel.Token));
+
+        // Assert
+        Assert.Equal(1, backends.Sum(x => x.RequestCount));
+        Assert.Equal(0, target.EjectedCount);
+    }
+
+    #region private ================================================================================
+
+    private sealed class FakeClock
+    {
+        private TimeSpan _now;
+
+        public TimeSpan Now()
+        {
+            return this._now;
+        }
+
+        public void Advance(TimeSpan time)
+        {
+            this._now += time;
+        }
+    }
+
+    #endregion
+}
@@ -0,0 +1,123 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using Xunit;
+
+namespace SemanticKernelTests.AI;
+
+public class SingleFlightTests
+{
+    [Fact]
+    public async Task ItSharesIdenticalOperationsInFlightAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+        var operation = new TaskCompletionSource<string>();
+        int calls = 0;
+
+        // Act
+        Task<string> first = target.RunAsync("key", _ => { calls++; return operation.Task; });
+        Task<string> second = target.RunAsync("key", _ => { calls++; return operation.Task; });
+        operation.SetResult("result");
+
+        // Assert
+        Assert.Equal("result", await first);
+        Assert.Equal("result", await second);
+        Assert.Equal(1, calls);
+    }
+
+    [Fact]
+    public async Task ItDoesNotShareDifferentOperationsAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+
+        // Act
+        string first = await target.RunAsync("a", _ => Task.FromResult("a"));
+        string second = await target.RunAsync("b", _ => Task.FromResult("b"));
+
+        // Assert
+        Assert.Equal("a", first);
+        Assert.Equal("b", second);
+    }
+
+    [Fact]
+    public async Task ItDoesNotKeepCompletedOperationsAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+        int calls = 0;
+
+        // Act
+        await target.RunAsync("key", _ => Task.FromResult($"call {++calls}"));
+        string result = await target.RunAsync("key", _ => Task.FromResult($"call {++calls}"));
+
+        // Assert
+        Assert.Equal("call 2", result);
+        Assert.Equal(0, target.Count);
+    }
+
+    [Fact]
+    public async Task ItPassesErrorsToAllTheCallersAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+        var operation = new TaskCompletionSource<string>();
+
+        // Act
+        Task<string> first = target.RunAsync("key", _ => operation.Task);
+        Task<string> second = target.RunAsync("key", _ => operation.Task);
+        operation.SetException(new InvalidOperationException("failed"));
+
+        // Assert
+        await Assert.ThrowsAsync<InvalidOperationException>(() => first);
+        await Assert.ThrowsAsync<InvalidOperationException>(() => second);
+        Assert.Equal(0, target.Count);
+    }
+
+    [Fact]
+    public async Task ItKeepsTheOperationWhenOnlySomeCallersCancelAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+        var operation = new TaskCompletionSource<string>();
+        using var cancel = new CancellationTokenSource();
+        CancellationToken operationToken = default;
+
+        // Act
+        Task<string> first = target.RunAsync("key", ct => { operationToken = ct; return operation.Task; }, cancel.Token);
+        Task<string> second = target.RunAsync("key", _ => operation.Task, CancellationToken.None);
+        cancel.Cancel();
+
+        // Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => first);
+        Assert.False(operationToken.IsCancellationRequested);
+        operation.SetResult("result");
+        Assert.Equal("result", await second);
+    }
+
+    [Fact]
+    public async Task ItCancelsTheOperationWhenAllTheCallersCancelAsync()
+    {
+        // Arrange
+        var target = new SingleFlight<string>();
+        using var cancelFirst = new CancellationTokenSource();
+        using var cancelSecond = new CancellationTokenSource();
+        CancellationToken operationToken = default;
+
+        // Act
+        Task<string> first = target.RunAsync("key", ct => { operationToken = ct; return Task.Delay(-1, ct).ContinueWith(_ => "never", TaskScheduler.Default); }, cancelFirst.Token);
+        Task<string> second = target.RunAsync("key", _ => Task.FromResult("unused"), cancelSecond.Token);
+        cancelFirst.Cancel();
+        cancelSecond.Cancel();
+
+        // Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => first);
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => second);
+        Assert.True(operationToken.IsCancellationRequested);
+        Assert.Equal(0, target.Count);
+    }
+}
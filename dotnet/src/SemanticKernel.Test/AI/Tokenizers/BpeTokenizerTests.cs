@@ -0,0 +1,133 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Xunit;
+
+namespace SemanticKernelTests.AI.Tokenizers;
+
+public class BpeTokenizerTests
+{
+    // All single bytes, followed by a few merges in order of priority
+    private static readonly string[] s_merges = { "ab", "abc", " a", " abc", "cd", "abcd", "é" };
+
+    [Fact]
+    public void ItMergesPairsInRankOrder()
+    {
+        // Arrange
+        var target = CreateTokenizer();
+
+        // Act
+        var tokens = target.Encode("abcd abcx");
+
+        // Assert: "abcd" is a single token, " abc" beats " a" + "bc"
+        Assert.Equal(new[] { Rank("abcd"), Rank(" abc"), 'x' }, tokens);
+    }
+
+    [Fact]
+    public void ItCountsTheSameTokensItEncodes()
+    {
+        // Arrange
+        var target = CreateTokenizer();
+        const string Text = "abcd, abcab cdcd! 123 é ü \n\n  x";
+
+        // Act
+        int count = target.CountTokens(Text);
+        var tokens = target.Encode(Text);
+
+        // Assert
+        Assert.Equal(tokens.Count, count);
+        Assert.Equal(Text, target.Decode(tokens));
+    }
+
+    [Fact]
+    public void ItHandlesLongPieces()
+    {
+        // Arrange
+        var target = CreateTokenizer();
+        string text = string.Concat(Enumerable.Repeat("abcd", 500));
+
+        // Act
+        int count = target.CountTokens(text);
+
+        // Assert
+        Assert.Equal(500, count);
+        Assert.Equal(text, target.Decode(target.Encode(text)));
+    }
+
+    [Fact]
+    public void ItLoadsTiktokenFiles()
+    {
+        // Arrange
+        var lines = GetVocabulary().Select(x => $"{Convert.ToBase64String(x.Key)} {x.Value}");
+        using var stream = new MemoryStream(Encoding.UTF8.GetBytes(string.Join("\n", lines)));
+
+        // Act
+        var target = BpeTokenizer.FromTiktokenStream(stream, BpeTokenizer.P50KPattern);
+
+        // Assert
+        Assert.Equal(new[] { Rank("abcd") }, target.Encode("abcd"));
+    }
+
+    [Fact]
+    public void ItThrowsOnInvalidTiktokenFiles()
+    {
+        // Arrange
+        using var stream = new MemoryStream(Encoding.UTF8.GetBytes("YWI= x\n"));
+
+        // Act
+        var exception = Assert.Throws<AIException>(() => BpeTokenizer.FromTiktokenStream(stream, BpeTokenizer.P50KPattern));
+
+        // Assert
+        Assert.Equal(AIException.ErrorCodes.InvalidConfiguration, exception.ErrorCode);
+    }
+
+    [Fact]
+    public void ItKeepsEncodingCorrectlyWhenTheCacheIsFull()
+    {
+        // Arrange
+        var target = CreateTokenizer();
+        // Distinct words, each one a separate piece
+        string[] pieces = Enumerable.Range(0, BpeTokenizer.MaxCacheSize + 10)
+            .Select(x => "abcd" + new string(x.ToString("D6", System.Globalization.CultureInfo.InvariantCulture).Select(d => (char)('e' + d - '0')).ToArray()))
+            .ToArray();
+
+        // Act
+        foreach (string piece in pieces) { target.Encode(piece); }
+
+        var first = target.Encode(pieces[0]);
+        var last = target.Encode(pieces[^1]);
+
+        // Assert
+        Assert.Equal(pieces[0], target.Decode(first));
+        Assert.Equal(pieces[^1], target.Decode(last));
+    }
+
+    private static BpeTokenizer CreateTokenizer()
+    {
+        return new BpeTokenizer(GetVocabulary(), BpeTokenizer.Cl100KPattern);
+    }
+
+    private static IEnumerable<KeyValuePair<byte[], int>> GetVocabulary()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            yield return new KeyValuePair<byte[], int>(new[] { (byte)i }, i);
+        }
+
+        for (int i = 0; i < s_merges.Length; i++)
+        {
+            yield return new KeyValuePair<byte[], int>(Encoding.UTF8.GetBytes(s_merges[i]), Rank(s_merges[i]));
+        }
+    }
+
+    private static int Rank(string merge)
+    {
+        return 256 + Array.IndexOf(s_merges, merge);
+    }
+}
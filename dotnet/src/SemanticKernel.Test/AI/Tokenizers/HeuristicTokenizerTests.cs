@@ -0,0 +1,74 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.OpenAI.Services;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Xunit;
+
+namespace SemanticKernelTests.AI.Tokenizers;
+
+public class HeuristicTokenizerTests
+{
+    [Theory]
+    [InlineData("", 0)]
+    [InlineData("Hello, world.", 4)]
+    [InlineData("The quick brown fox jumps over the lazy dog", 9)]
+    [InlineData("1234567", 3)]
+    [InlineData("if (x == 1) { return; }", 10)]
+    [InlineData("你好世界", 4)]
+    [InlineData("a\n\n\n\nb", 3)]
+    public void ItEstimatesTokens(string text, int expected)
+    {
+        // Act
+        int count = HeuristicTokenizer.Instance.CountTokens(text);
+
+        // Assert
+        Assert.Equal(expected, count);
+        Assert.Equal(expected, HeuristicTokenizer.Instance.Encode(text).Count);
+    }
+
+    [Fact]
+    public void ItValidatesCompletionRequests()
+    {
+        // Arrange
+        var settings = new CompleteRequestSettings { MaxTokens = 10 };
+
+        // Act
+        int available = HeuristicTokenizer.Instance.GetAvailableCompletionTokens("one two three", 12);
+        HeuristicTokenizer.Instance.ValidateCompletionRequest("one two", settings, 12);
+        var exception = Assert.Throws<AIException>(() => HeuristicTokenizer.Instance.ValidateCompletionRequest("one two three", settings, 12));
+
+        // Assert
+        Assert.Equal(9, available);
+        Assert.Equal(AIException.ErrorCodes.InvalidRequest, exception.ErrorCode);
+    }
+
+    [Fact]
+    public async Task ItRejectsCompletionRequestsNotFittingTheModelBeforeSendingAsync()
+    {
+        // Arrange
+        using var client = new OpenAITextCompletion("text-davinci-003", "key", tokenizer: HeuristicTokenizer.Instance);
+        var settings = new CompleteRequestSettings { MaxTokens = 4097 };
+
+        // Act
+        var exception = await Assert.ThrowsAsync<AIException>(() => client.CompleteAsync("one two three", settings));
+
+        // Assert
+        Assert.Equal(AIException.ErrorCodes.InvalidRequest, exception.ErrorCode);
+    }
+
+    [Theory]
+    [InlineData("gpt-4-32k-0314", 32768)]
+    [InlineData("gpt-4", 8192)]
+    [InlineData("text-davinci-003", 4097)]
+    public void ItKnowsTheContextWindowOfCommonModels(string modelId, int expected)
+    {
+        // Act
+        bool found = TokenizerExtensions.TryGetContextWindowSize(modelId, out int size);
+
+        // Assert
+        Assert.True(found);
+        Assert.Equal(expected, size);
+    }
+}
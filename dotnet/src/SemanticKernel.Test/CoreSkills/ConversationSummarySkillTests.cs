@@ -0,0 +1,101 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel;
+using Microsoft.SemanticKernel.CoreSkills;
+using Microsoft.SemanticKernel.Orchestration;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.CoreSkills;
+
+public class ConversationSummarySkillTests
+{
+    [Fact]
+    public void ItCanBeImported()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+
+        // Act - Assert no exception occurs e.g. due to reflection
+        _ = kernel.ImportSkill(new ConversationSummarySkill(kernel), "conversation");
+    }
+
+    [Fact]
+    public async Task ItAnalyzesConversationInOnePassAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var skill = new ConversationSummarySkill(kernel);
+        var backend = new FakeCompletionClient(text =>
+            text.Contains("BEGIN SUMMARY", StringComparison.Ordinal) ? "summary"
+            : text.Contains("ACTION ITEMS", StringComparison.Ordinal) ? "action items"
+            : "topics");
+        foreach (var function in kernel.Skills.GetFunctionsView(includeNative: false).SemanticFunctions[nameof(ConversationSummarySkill)])
+        {
+            kernel.Skills.GetSemanticFunction(nameof(ConversationSummarySkill), function.Name).SetAIBackend(() => backend);
+        }
+
+        string transcript = string.Join("\n", Enumerable.Repeat("John: we should ship the release on Friday.", 400));
+
+        // Act
+        SKContext context = await skill.AnalyzeConversationAsync(transcript, kernel.CreateNewContext());
+
+        // Assert
+        Assert.False(context.ErrorOccurred);
+        int chunks = context["summary"].Split('\n').Length;
+        Assert.True(chunks > 1);
+        Assert.Equal(string.Join("\n", Enumerable.Repeat("summary", chunks)), context["summary"]);
+        Assert.Equal(string.Join("\n", Enumerable.Repeat("action items", chunks)), context["actionItems"]);
+        Assert.Equal(string.Join("\n", Enumerable.Repeat("topics", chunks)), context["topics"]);
+        Assert.Equal(context["summary"], context.Result);
+        Assert.Equal(3 * chunks, backend.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItCancelsTheOtherAnalysesWhenOneFailsAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var skill = new ConversationSummarySkill(kernel);
+        int cancelled = 0;
+        var backend = new FakeCompletionClient(async (text, cancel) =>
+        {
+            if (text.Contains("ACTION ITEMS", StringComparison.Ordinal)) { throw new InvalidOperationException("failed"); }
+
+            try
+            {
+                await Task.Delay(TimeSpan.FromSeconds(30), cancel);
+                return "done";
+            }
+            catch (OperationCanceledException)
+            {
+                Interlocked.Increment(ref cancelled);
+                throw;
+            }
+        });
+        foreach (var function in kernel.Skills.GetFunctionsView(includeNative: false).SemanticFunctions[nameof(ConversationSummarySkill)])
+        {
+            kernel.Skills.GetSemanticFunction(nameof(ConversationSummarySkill), function.Name).SetAIBackend(() => backend);
+        }
+
+        string transcript = string.Join("\n", Enumerable.Repeat("John: we should ship the release on Friday.", 400));
+        var stopwatch = Stopwatch.StartNew();
+
+        // Act
+        SKContext context = await skill.AnalyzeConversationAsync(transcript, kernel.CreateNewContext());
+
+        // Assert - the summary and topics requests in progress are cancelled
+        Assert.True(context.ErrorOccurred);
+        Assert.Contains("failed", context.LastErrorDescription, StringComparison.Ordinal);
+        Assert.True(cancelled > 0);
+        Assert.True(stopwatch.Elapsed < TimeSpan.FromSeconds(20));
+    }
+}
@@ -1,6 +1,8 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
 using System;
+using System.Collections.Concurrent;
+using System.Linq;
 using System.Threading.Tasks;
 using Microsoft.SemanticKernel;
 using Microsoft.SemanticKernel.CoreSkills;
@@ -8,6 +10,7 @@ using Microsoft.SemanticKernel.Orchestration;
 using Microsoft.SemanticKernel.Orchestration.Extensions;
 using Microsoft.SemanticKernel.Planning;
 using Microsoft.SemanticKernel.SkillDefinition;
+using SemanticKernelTests.TestHelpers;
 using Xunit;
 using Xunit.Abstractions;
 
@@ -76,6 +79,31 @@ Solve the equation x^2 = 2.
         Assert.StartsWith("<goal>\nSolve the equation x^2 = 2.\n</goal>", plan.PlanString, StringComparison.OrdinalIgnoreCase);
     }
 
+    [Fact]
+    public async Task ItCreatesPlansWhenThePlanCacheFailsAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var planCache = new PlanCache(new FailingEmbeddingGenerator());
+        var planner = kernel.ImportSkill(new PlannerSkill(kernel, planCache: planCache), "planner");
+        var backend = new FakeCompletionClient("<plan>\n  <function.math.simplify input=\"x^2 = 2\" />\n</plan>");
+        foreach (var function in kernel.Skills.GetFunctionsView(includeNative: false).SemanticFunctions["PlannerSkill_Excluded"])
+        {
+            kernel.Skills.GetSemanticFunction("PlannerSkill_Excluded", function.Name).SetAIBackend(() => backend);
+        }
+
+        // Act
+        var context = await kernel.RunAsync(GoalText, planner["CreatePlan"]);
+
+        // Assert
+        Assert.False(context.ErrorOccurred);
+        var plan = context.Variables.ToPlan();
+        Assert.Equal(GoalText, plan.Goal);
+        Assert.Contains("function.math.simplify", plan.PlanString, StringComparison.Ordinal);
+        Assert.Equal(0, planCache.PendingPlansCount);
+    }
+
     [Fact]
     public async Task ItCanExecutePlanTextAsync()
     {
@@ -463,6 +491,181 @@ This is some text
         Assert.Equal("Echo Result: Echo Result: Hello World", plan.Result, true);
     }
 
+    [Theory]
+    [InlineData("Test the functionFlowRunner", @"<goal>Test the functionFlowRunner</goal>
+<plan>
+<function.MockSkill.Echo input=""Hello World"" />
+<function.MockSkill.SplitInput />
+<function.MockSkill.Echo input=""$Second"" setContextVariable=""ECHO_SECOND""/>
+<function.MockSkill.Echo input=""$First"" setContextVariable=""ECHO_FIRST""/>
+<function.MockSkill.Echo input=""$ECHO_SECOND;$ECHO_FIRST"" />
+</plan>")]
+    public async Task RunPlanExecutesAllStepsAsync(string goalText, string planText)
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var plannerSkill = kernel.ImportSkill(new PlannerSkill(kernel));
+        _ = kernel.ImportSkill(new MockSkill(this._testOutputHelper), "MockSkill");
+        Plan createdPlan = new()
+        {
+            Goal = goalText,
+            PlanString = planText
+        };
+
+        // Act
+        var context = await kernel.RunAsync(createdPlan.ToJson(), plannerSkill["RunPlan"]);
+
+        // Assert - same result as executing the steps one at a time
+        var plan = context.Variables.ToPlan();
+        Assert.Equal(goalText, plan.Goal);
+        Assert.True(plan.IsSuccessful);
+        Assert.True(plan.IsComplete);
+        Assert.Equal("Echo Result: Echo Result:  Hello WorldEcho Result: Echo Result", plan.Result, true);
+        Assert.Equal("<goal>Test the functionFlowRunner</goal><plan>\n</plan>", plan.PlanString);
+    }
+
+    [Theory]
+    [InlineData("Test the functionFlowRunner", @"<goal>Test the functionFlowRunner</goal>
+<plan>
+<function.MockSkill.Echo input=""Hello World"" />
+<function.MockSkill.Echo input=""Goodbye"" />
+</plan>")]
+    public async Task RunPlanStopsAfterMaxStepsAsync(string goalText, string planText)
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var plannerSkill = kernel.ImportSkill(new PlannerSkill(kernel));
+        _ = kernel.ImportSkill(new MockSkill(this._testOutputHelper), "MockSkill");
+        var variables = new ContextVariables(new Plan { Goal = goalText, PlanString = planText }.ToJson());
+        variables.Set("maxSteps", "1");
+
+        // Act
+        var context = await kernel.RunAsync(variables, plannerSkill["RunPlan"]);
+
+        // Assert - the plan can be resumed from the remaining steps
+        var plan = context.Variables.ToPlan();
+        Assert.True(plan.IsSuccessful);
+        Assert.False(plan.IsComplete);
+        Assert.Equal("<goal>Test the functionFlowRunner</goal><plan>\n  <function.MockSkill.Echo input=\"Goodbye\" />\n</plan>", plan.PlanString);
+    }
+
+    [Theory]
+    [InlineData("Test the functionFlowRunner", @"<goal>Test the functionFlowRunner</goal>
+<plan>
+<function.MockSkill.Echo input=""Hello"" />
+<function.MockSkill.Fail input=""Hi"" />
+<function.MockSkill.Echo input=""Goodbye"" />
+</plan>")]
+    public async Task RunPlanKeepsTheStepsAfterAFailedStepAsync(string goalText, string planText)
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var plannerSkill = kernel.ImportSkill(new PlannerSkill(kernel));
+        var mockSkill = new MockSkill(this._testOutputHelper);
+        _ = kernel.ImportSkill(mockSkill, "MockSkill");
+
+        // Act
+        var context = await kernel.RunAsync(new Plan { Goal = goalText, PlanString = planText }.ToJson(), plannerSkill["RunPlan"]);
+
+        // Assert - the last step ran with the failed one, and runs again when the plan is resumed
+        var plan = context.Variables.ToPlan();
+        Assert.False(plan.IsSuccessful);
+        Assert.Equal(new[] { "Goodbye", "Hello" }, mockSkill.Echoed.OrderBy(x => x, StringComparer.Ordinal));
+        Assert.Equal("<goal>Test the functionFlowRunner</goal><plan>\n  <function.MockSkill.Fail input=\"Hi\" />\n"
+                     + "  <function.MockSkill.Echo input=\"Goodbye\" />\n</plan>", plan.PlanString);
+    }
+
+    [Fact]
+    public void ItMovesToTheNextStepSkippingUnknownFunctions()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.ImportSkill(new MockSkill(this._testOutputHelper), "MockSkill");
+        var context = kernel.CreateNewContext();
+        var runner = new FunctionFlowRunner(kernel);
+        var plan = runner.Compile(@"<goal>Echo</goal>
+<plan>
+<function.MockSkill.Echo input=""First"" />
+<function.MockSkill.Unknown input=""Skipped"" />
+<function.MockSkill.Echo input=""Last"" />
+</plan>", context);
+
+        // Act
+        var first = plan.NextStep;
+        plan.MarkExecuted(first!);
+        var last = plan.NextStep;
+        plan.MarkExecuted(last!);
+
+        // Assert
+        Assert.Same(plan.Steps[0], first);
+        Assert.Same(plan.Steps[2], last);
+        Assert.Null(plan.NextStep);
+        Assert.Equal(2, plan.ExecutedSteps);
+        Assert.Empty(plan.GetNextSteps(context.Variables, int.MaxValue));
+    }
+
+    [Fact]
+    public void ItGroupsIndependentStepsTogether()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.ImportSkill(new MockSkill(this._testOutputHelper), "MockSkill");
+        var context = kernel.CreateNewContext();
+        var runner = new FunctionFlowRunner(kernel);
+        var plan = runner.Compile(@"<goal>Echo</goal>
+<plan>
+<function.MockSkill.Echo input=""Hi"" setContextVariable=""A"" />
+<function.MockSkill.Echo input=""$A"" setContextVariable=""B"" />
+<function.MockSkill.Echo input=""$A"" setContextVariable=""C"" />
+<function.MockSkill.Echo setContextVariable=""D"" />
+</plan>", context);
+        context.Variables.Set("A", "Hi");
+
+        // Act
+        var steps = plan.GetNextSteps(context.Variables, int.MaxValue);
+
+        // Assert - the first step writes A, the last step reads the input written by the previous steps
+        Assert.Equal(1, steps.Count);
+        plan.MarkExecuted(steps[0]);
+        steps = plan.GetNextSteps(context.Variables, int.MaxValue);
+        Assert.Equal(new[] { "B", "C" }, new[] { steps[0].OutputVariable, steps[1].OutputVariable });
+        Assert.Equal(2, steps.Count);
+    }
+
+    [Theory]
+    [InlineData("Test the functionFlowRunner", @"<goal>Test the functionFlowRunner</goal>
+<plan>
+<function.MockSkill.Echo input=""Hello"" setContextVariable=""GREETING"" />
+<function.MockSkill.Echo input=""$GREETING"" appendToResult=""RESULT__FIRST"" />
+<function.MockSkill.Echo input=""$GREETING"" appendToResult=""RESULT__SECOND"" />
+</plan>")]
+    public async Task RunPlanExecutesIndependentStepsInPlanOrderAsync(string goalText, string planText)
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        _ = kernel.Config.AddOpenAICompletionBackend("test", "test", "test");
+        var plannerSkill = kernel.ImportSkill(new PlannerSkill(kernel));
+        _ = kernel.ImportSkill(new MockSkill(this._testOutputHelper), "MockSkill");
+        Plan createdPlan = new()
+        {
+            Goal = goalText,
+            PlanString = planText
+        };
+
+        // Act
+        var context = await kernel.RunAsync(createdPlan.ToJson(), plannerSkill["RunPlan"]);
+
+        // Assert - results are appended in plan order
+        var plan = context.Variables.ToPlan();
+        Assert.True(plan.IsSuccessful);
+        Assert.True(plan.IsComplete);
+        Assert.Equal("RESULT__FIRST\n\nEcho Result: Echo Result: Hello\n\nRESULT__SECOND\n\nEcho Result: Echo Result: Hello",
+            plan.Result.Replace(Environment.NewLine, "\n", StringComparison.Ordinal));
+    }
+
     public class MockSkill
     {
         private readonly ITestOutputHelper _testOutputHelper;
@@ -488,8 +691,19 @@ This is some text
         public Task<SKContext> EchoAsync(string text, SKContext context)
         {
             this._testOutputHelper.WriteLine(text);
+            this.Echoed.Add(text);
             _ = context.Variables.Update("Echo Result: " + text);
             return Task.FromResult(context);
         }
+
+        [SKFunction("Fail")]
+        [SKFunctionName("Fail")]
+        public Task<SKContext> FailAsync(string text, SKContext context)
+        {
+            context.Fail("Failed: " + text);
+            return Task.FromResult(context);
+        }
+
+        public ConcurrentBag<string> Echoed { get; } = new();
     }
 }
@@ -1,13 +1,22 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Linq;
+using System.Net.Http;
+using System.Text;
+using System.Text.Json;
 using System.Threading;
 using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel;
+using Microsoft.SemanticKernel.AI;
 using Microsoft.SemanticKernel.KernelExtensions;
 using Microsoft.SemanticKernel.Orchestration;
 using Microsoft.SemanticKernel.Orchestration.Extensions;
+using Microsoft.SemanticKernel.Reliability;
+using Microsoft.SemanticKernel.SemanticFunctions;
 using Microsoft.SemanticKernel.SkillDefinition;
 using Xunit;
 
@@ -142,6 +151,133 @@ public class KernelTests
         var exception = Assert.Throws<KernelException>(() => kernel.CreateSemanticFunction(promptTemplate: "Tell me a joke", functionName: "joker", skillName: "jk", description: "Nice fun"));
     }
 
+    [Fact]
+    public async Task ItBatchesRequestsOfFunctionsSharingABackendAsync()
+    {
+        // Arrange
+        var http = new FakeCompletionHandlerFactory();
+        var kernel = KernelBuilder.Create();
+        kernel.Config
+            .AddOpenAICompletionBackend("x", "y", "z")
+            .SetHttpRetryHandlerFactory(http)
+            .SetCompletionBatching(2, TimeSpan.FromSeconds(30));
+
+        var joker = kernel.CreateSemanticFunction("Tell me a joke", functionName: "joker", skillName: "jk");
+        var poet = kernel.CreateSemanticFunction("Write a poem", functionName: "poet", skillName: "jk");
+
+        // Act
+        SKContext[] results = await Task.WhenAll(kernel.RunAsync(joker), kernel.RunAsync(poet));
+
+        // Assert - a single request, sent as soon as the batch is full
+        Assert.Equal(1, http.Requests);
+        Assert.All(results, x => Assert.False(x.ErrorOccurred));
+    }
+
+    [Fact]
+    public async Task ItUsesTheFirstBackendUnlessRoutingIsEnabledAsync()
+    {
+        // Arrange
+        var http = new FakeCompletionHandlerFactory();
+        var kernel = KernelBuilder.Create();
+        kernel.Config
+            .AddOpenAICompletionBackend("a", "model-a", "key")
+            .AddOpenAICompletionBackend("b", "model-b", "key")
+            .SetHttpRetryHandlerFactory(http);
+
+        var config = new PromptTemplateConfig { DefaultBackends = new List<string> { "a", "b" } };
+        var function = kernel.CreateSemanticFunction("Tell me a joke", config, functionName: "joker", skillName: "jk");
+
+        // Act
+        for (int i = 0; i < 5; i++) { await kernel.RunAsync(function); }
+
+        // Assert
+        Assert.Equal(5, http.GetRequests("model-a"));
+        Assert.Equal(0, http.GetRequests("model-b"));
+    }
+
+    [Fact]
+    public async Task ItSharesTheRouterOfFunctionsUsingTheSameBackendsAsync()
+    {
+        // Arrange
+        var http = new FakeCompletionHandlerFactory { FailingModel = "model-a" };
+        var kernel = KernelBuilder.Create();
+        kernel.Config
+            .AddOpenAICompletionBackend("a", "model-a", "key")
+            .AddOpenAICompletionBackend("b", "model-b", "key")
+            .SetHttpRetryHandlerFactory(http);
+
+        var config = new PromptTemplateConfig { DefaultBackends = new List<string> { "a", "b" }, RouteAcrossBackends = true };
+        var joker = kernel.CreateSemanticFunction("Tell me a joke", config, functionName: "joker", skillName: "jk");
+        var poet = kernel.CreateSemanticFunction("Write a poem", config, functionName: "poet", skillName: "jk");
+
+        // Act - the first function fails over until the failing backend is ejected
+        for (int i = 0; i < 20 && http.GetRequests("model-a") < RoutingTextCompletionClient.DefaultFailureThreshold; i++)
+        {
+            Assert.False((await kernel.RunAsync(joker)).ErrorOccurred);
+        }
+
+        SKContext[] results = await Task.WhenAll(Enumerable.Range(0, 10).Select(_ => kernel.RunAsync(poet)));
+
+        // Assert - the second function knows the backend is ejected
+        Assert.Equal(RoutingTextCompletionClient.DefaultFailureThreshold, http.GetRequests("model-a"));
+        Assert.All(results, x => Assert.False(x.ErrorOccurred));
+    }
+
+    private sealed class FakeCompletionHandlerFactory : IDelegatingHandlerFactory
+    {
+        private readonly ConcurrentDictionary<string, int> _requestsByModel = new();
+        private int _requests;
+
+        public int Requests => this._requests;
+
+        public string? FailingModel { get; set; }
+
+        public int GetRequests(string model)
+        {
+            return this._requestsByModel.TryGetValue(model, out int count) ? count : 0;
+        }
+
+        public DelegatingHandler Create(ILogger? log)
+        {
+            return new Handler(this);
+        }
+
+        private sealed class Handler : DelegatingHandler
+        {
+            private readonly FakeCompletionHandlerFactory _factory;
+
+            public Handler(FakeCompletionHandlerFactory factory)
+            {
+                this._factory = factory;
+            }
+
+            protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+            {
+                Interlocked.Increment(ref this._factory._requests);
+
+                // OpenAI URLs end with /engines/{model}/completions
+                string model = request.RequestUri!.Segments[^2].TrimEnd('/');
+                this._factory._requestsByModel.AddOrUpdate(model, 1, (_, count) => count + 1);
+                if (model == this._factory.FailingModel)
+                {
+                    return new HttpResponseMessage(System.Net.HttpStatusCode.InternalServerError);
+                }
+
+                using JsonDocument body = JsonDocument.Parse(await request.Content!.ReadAsStringAsync(cancellationToken));
+                JsonElement prompt = body.RootElement.GetProperty("prompt");
+                int count = prompt.ValueKind == JsonValueKind.Array ? prompt.GetArrayLength() : 1;
+
+                var choices = new List<string>();
+                for (int i = 0; i < count; i++) { choices.Add($"{{\"text\":\"completion {i}\",\"index\":{i}}}"); }
+
+                return new HttpResponseMessage(System.Net.HttpStatusCode.OK)
+                {
+                    Content = new StringContent($"{{\"choices\":[{string.Join(",", choices)}]}}", Encoding.UTF8, "application/json")
+                };
+            }
+        }
+    }
+
     public class MySkill
     {
         [SKFunction("Return any value.")]
@@ -0,0 +1,69 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Linq;
+using Microsoft.SemanticKernel.Memory.Lexical;
+using Xunit;
+
+namespace SemanticKernelTests.Memory.Lexical;
+
+public class BM25IndexTests
+{
+    [Fact]
+    public void ItTokenizesOnNonAlphanumericChars()
+    {
+        // Act
+        var terms = BM25Index.Tokenize("Error ERR-4521: disk/full, retry 3x!").ToList();
+
+        // Assert
+        Assert.Equal(new[] { "error", "err", "4521", "disk", "full", "retry", "3x" }, terms);
+    }
+
+    [Fact]
+    public void ItRanksRareTermsHigher()
+    {
+        // Arrange
+        var index = new BM25Index();
+        index.Upsert("a", "the cat sat on the mat");
+        index.Upsert("b", "the dog sat on the log");
+        index.Upsert("c", "the zebra sat");
+
+        // Act
+        var results = index.Search("the zebra", 10);
+
+        // Assert
+        Assert.Equal(3, results.Count);
+        Assert.Equal("c", results[0].Id);
+        Assert.True(results[0].Score > results[1].Score);
+    }
+
+    [Fact]
+    public void ItReplacesAndRemovesDocuments()
+    {
+        // Arrange
+        var index = new BM25Index();
+        index.Upsert("a", "apple");
+        index.Upsert("b", "banana");
+
+        // Act
+        index.Upsert("a", "cherry");
+        index.Remove("b");
+
+        // Assert
+        Assert.Equal(1, index.Count);
+        Assert.Empty(index.Search("apple", 10));
+        Assert.Empty(index.Search("banana", 10));
+        Assert.Equal("a", index.Search("cherry", 10).Single().Id);
+    }
+
+    [Fact]
+    public void ItReturnsNothingForEmptyQueries()
+    {
+        // Arrange
+        var index = new BM25Index();
+        index.Upsert("a", "apple");
+
+        // Assert
+        Assert.Empty(index.Search(" ,.; ", 10));
+        Assert.Empty(index.Search("apple", 0));
+    }
+}
@@ -0,0 +1,124 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Linq;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Memory;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.Memory;
+
+public class SemanticTextMemoryTests
+{
+    private const string Collection = "test";
+
+    [Fact]
+    public async Task ItFindsKeywordsWithLexicalSearchAsync()
+    {
+        // Arrange
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), new FakeEmbeddingGenerator());
+        await memory.SaveInformationAsync(Collection, "the printer shows error ERR4521", "id1");
+        await memory.SaveInformationAsync(Collection, "the printer is out of paper", "id2");
+        await memory.SaveInformationAsync(Collection, "my cat likes the garden", "id3");
+
+        // Act
+        var results = await memory.SearchAsync(Collection, "ERR4521", MemorySearchMode.Lexical, limit: 3).ToListAsync();
+
+        // Assert
+        Assert.Single(results);
+        Assert.Equal("id1", results[0].Id);
+        Assert.Equal(1.0, results[0].Relevance);
+    }
+
+    [Fact]
+    public async Task ItIndexesRecordsSavedAfterTheFirstSearchAsync()
+    {
+        // Arrange
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), new FakeEmbeddingGenerator());
+        await memory.SaveInformationAsync(Collection, "alpha", "id1");
+        var before = await memory.SearchAsync(Collection, "beta", MemorySearchMode.Lexical).ToListAsync();
+
+        // Act
+        await memory.SaveReferenceAsync(Collection, "some text", "https://beta", "web", description: "beta page");
+        var after = await memory.SearchAsync(Collection, "beta", MemorySearchMode.Lexical).ToListAsync();
+
+        // Assert
+        Assert.Empty(before);
+        Assert.Single(after);
+        Assert.Equal("https://beta", after[0].Id);
+    }
+
+    [Fact]
+    public async Task ItUsesEmbeddingsWithSemanticSearchAsync()
+    {
+        // Arrange
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), new FakeEmbeddingGenerator());
+        await memory.SaveInformationAsync(Collection, "cat cat", "id1");
+        await memory.SaveInformationAsync(Collection, "dog dog", "id2");
+
+        // Act
+        var results = await memory.SearchAsync(Collection, "cat", MemorySearchMode.Semantic, limit: 2).ToListAsync();
+        var expected = await memory.SearchAsync(Collection, "cat", limit: 2).ToListAsync();
+
+        // Assert
+        Assert.Single(results);
+        Assert.Equal("id1", results[0].Id);
+        Assert.Equal(expected.Select(x => x.Id), results.Select(x => x.Id));
+    }
+
+    [Fact]
+    public async Task ItRanksRecordsFoundByBothStrategiesFirstWithHybridSearchAsync()
+    {
+        // Arrange
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), new FakeEmbeddingGenerator());
+        await memory.SaveInformationAsync(Collection, "cat cat", "semantic-only");
+        await memory.SaveInformationAsync(Collection, "cat invoice 1234", "both");
+        await memory.SaveInformationAsync(Collection, "invoice 1234 for the car", "lexical-only");
+
+        // Act
+        var results = await memory.SearchAsync(Collection, "cat invoice", MemorySearchMode.Hybrid, limit: 3, minRelevanceScore: 0.5).ToListAsync();
+
+        // Assert
+        Assert.Equal(3, results.Count);
+        Assert.Equal("both", results[0].Id);
+        Assert.True(results[0].Relevance > results[1].Relevance);
+        Assert.True(results.All(x => x.Relevance is > 0 and <= 1));
+    }
+
+    [Fact]
+    public async Task ItReturnsNothingFromEmptyCollectionsAsync()
+    {
+        // Arrange
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), new FakeEmbeddingGenerator());
+
+        // Act
+        var lexical = await memory.SearchAsync(Collection, "cat", MemorySearchMode.Lexical).ToListAsync();
+        var hybrid = await memory.SearchAsync(Collection, "cat", MemorySearchMode.Hybrid).ToListAsync();
+
+        // Assert
+        Assert.Empty(lexical);
+        Assert.Empty(hybrid);
+    }
+
+    [Fact]
+    public async Task ItSearchesMultipleQueriesInOneBatchAsync()
+    {
+        // Arrange
+        var generator = new FakeEmbeddingGenerator();
+        using var memory = new SemanticTextMemory(new VolatileMemoryStore<float>(), generator);
+        await memory.SaveInformationAsync(Collection, "cat", "id1");
+        await memory.SaveInformationAsync(Collection, "dog", "id2");
+        await memory.SaveInformationAsync(Collection, "car", "id3");
+        int callsBefore = generator.Calls;
+
+        // Act
+        var results = await memory.SearchBatchAsync(Collection, new[] { "car", "cat", "boat" }, limit: 2);
+
+        // Assert
+        Assert.Equal(callsBefore + 1, generator.Calls);
+        Assert.Equal(3, results.Count);
+        Assert.Equal("id3", results[0].Single().Id);
+        Assert.Equal("id1", results[1].Single().Id);
+        Assert.Empty(results[2]);
+    }
+}
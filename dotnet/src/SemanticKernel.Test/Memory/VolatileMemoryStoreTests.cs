@@ -4,6 +4,7 @@ using System;
 using System.Linq;
 using System.Threading.Tasks;
 using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
 using Microsoft.SemanticKernel.Memory;
 using Microsoft.SemanticKernel.Memory.Storage;
 using Xunit;
@@ -248,4 +249,97 @@ public class VolatileMemoryStoreTests
             Assert.True(compare >= 0);
         }
     }
+
+    [Fact]
+    public async Task GetNearestMatchesBatchReturnsSameResultsAsSingleSearchesAsync()
+    {
+        // Arrange
+        string collection = "collection" + Random.Shared.Next();
+        var random = new Random(42);
+        const int Dimensions = 37;
+        for (int i = 0; i < 3000; i++)
+        {
+            var vector = Enumerable.Range(0, Dimensions).Select(_ => random.NextDouble() - 0.5).ToArray();
+            await this._db.PutValueAsync(collection, "key" + i, new DoubleEmbeddingWithBasicMetadata(new Embedding<double>(vector), "key" + i));
+        }
+
+        var queries = Enumerable.Range(0, 7)
+            .Select(_ => new Embedding<double>(Enumerable.Range(0, Dimensions).Select(_ => random.NextDouble() - 0.5)))
+            .ToList();
+
+        // Act
+        var batchResults = await this._db.GetNearestMatchesBatchAsync(collection, queries, limit: 5, minRelevanceScore: 0.1);
+
+        // Assert
+        Assert.Equal(queries.Count, batchResults.Count);
+        for (int q = 0; q < queries.Count; q++)
+        {
+            var expected = this._db.GetNearestMatchesAsync(collection, queries[q], limit: 5, minRelevanceScore: 0.1).ToEnumerable().ToArray();
+            Assert.Equal(5, batchResults[q].Count);
+            for (int i = 0; i < expected.Length; i++)
+            {
+                Assert.Same(expected[i].Item1, batchResults[q][i].Item1);
+                Assert.Equal(queries[q].Vector.ToArray().CosineSimilarity(expected[i].Item1.Embedding.Vector.ToArray()), batchResults[q][i].Item2, 10);
+            }
+        }
+    }
+
+    [Fact]
+    public async Task GetNearestMatchesBatchReturnsEmptyListsForMissingCollectionAsync()
+    {
+        // Arrange
+        var queries = new[] { new Embedding<double>(new double[] { 1, 1, 1 }), new Embedding<double>(new double[] { 1, 2, 3 }) };
+
+        // Act
+        var results = await this._db.GetNearestMatchesBatchAsync("collection" + Random.Shared.Next(), queries, limit: 3);
+
+        // Assert
+        Assert.Equal(2, results.Count);
+        Assert.All(results, Assert.Empty);
+    }
+
+    [Fact]
+    public async Task GetNearestAsyncSupportsRecordsWithTheSameScoreAsync()
+    {
+        // Arrange
+        string collection = "collection" + Random.Shared.Next();
+        await this._db.PutValueAsync(collection, "a", new DoubleEmbeddingWithBasicMetadata(new Embedding<double>(new double[] { 1, 1, 1 }), "a"));
+        await this._db.PutValueAsync(collection, "b", new DoubleEmbeddingWithBasicMetadata(new Embedding<double>(new double[] { 2, 2, 2 }), "b"));
+
+        // Act
+        var results = this._db.GetNearestMatchesAsync(collection, new Embedding<double>(new double[] { 1, 1, 1 }), limit: 3).ToEnumerable().ToArray();
+
+        // Assert
+        Assert.Equal(2, results.Length);
+    }
+
+    [Fact]
+    public async Task GetNearestAsyncSupportsHalfPrecisionEmbeddingsAsync()
+    {
+        // Arrange
+        var db = new VolatileMemoryStore<Float16>();
+        string collection = "collection" + Random.Shared.Next();
+        var near = new Embedding<Float16>(new[] { 1F, 2F, 3F }.Select(x => (Float16)x));
+        var far = new Embedding<Float16>(new[] { -1F, 0F, 1F }.Select(x => (Float16)x));
+        await db.PutValueAsync(collection, "near", new HalfEmbeddingWithBasicMetadata(near));
+        await db.PutValueAsync(collection, "far", new HalfEmbeddingWithBasicMetadata(far));
+
+        // Act
+        var query = new Embedding<Float16>(new[] { 1F, 2F, 2.5F }.Select(x => (Float16)x));
+        var results = db.GetNearestMatchesAsync(collection, query, limit: 2, minRelevanceScore: 0.5).ToEnumerable().ToArray();
+
+        // Assert
+        Assert.Single(results);
+        Assert.Equal(near, results[0].Item1.Embedding);
+    }
+
+    private sealed class HalfEmbeddingWithBasicMetadata : IEmbeddingWithMetadata<Float16>
+    {
+        public Embedding<Float16> Embedding { get; }
+
+        public HalfEmbeddingWithBasicMetadata(Embedding<Float16> embedding)
+        {
+            this.Embedding = embedding;
+        }
+    }
 }
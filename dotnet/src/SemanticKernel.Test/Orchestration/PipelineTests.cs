@@ -0,0 +1,159 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel;
+using Microsoft.SemanticKernel.Orchestration;
+using Microsoft.SemanticKernel.SkillDefinition;
+using Xunit;
+
+namespace SemanticKernelTests.Orchestration;
+
+public class PipelineTests
+{
+    [Fact]
+    public async Task ItRunsIndependentStepsConcurrentlyAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        var skill = new RecallSkill();
+        IDictionary<string, ISKFunction> functions = kernel.ImportSkill(skill, "recall");
+        var pipeline = new Pipeline()
+            .Add(functions["Facts"], "facts", "input")
+            .Add(functions["History"], "history", "input")
+            .Add(functions["Answer"], "answer", "facts", "history");
+
+        // Act
+        Task<SKContext> run = kernel.RunAsync(pipeline, new ContextVariables("cats"));
+        Task bothStarted = Task.WhenAll(skill.FactsStarted.Task, skill.HistoryStarted.Task);
+        bool concurrent = await Task.WhenAny(bothStarted, Task.Delay(TimeSpan.FromSeconds(5))) == bothStarted;
+        skill.Gate.SetResult(true);
+        SKContext result = await run;
+
+        // Assert
+        Assert.True(concurrent);
+        Assert.False(result.ErrorOccurred);
+        Assert.Equal("facts about cats", result["facts"]);
+        Assert.Equal("history of cats", result["history"]);
+        Assert.Equal("facts about cats, history of cats", result["answer"]);
+        Assert.Equal("facts about cats, history of cats", result.Result);
+    }
+
+    [Fact]
+    public async Task ItRunsBlockingStepsConcurrentlyAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        var skill = new RecallSkill();
+        IDictionary<string, ISKFunction> functions = kernel.ImportSkill(skill, "recall");
+        var pipeline = new Pipeline()
+            .Add(functions["BlockingFacts"], "facts", "input")
+            .Add(functions["BlockingHistory"], "history", "input");
+
+        // Act
+        SKContext result = await kernel.RunAsync(pipeline, new ContextVariables("cats"));
+
+        // Assert: each step waits for the other one to start
+        Assert.False(result.ErrorOccurred);
+        Assert.Equal("concurrent", result["facts"]);
+        Assert.Equal("concurrent", result["history"]);
+    }
+
+    [Fact]
+    public async Task ItStopsWhenAStepFailsAsync()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        var skill = new RecallSkill();
+        IDictionary<string, ISKFunction> functions = kernel.ImportSkill(skill, "recall");
+        var pipeline = new Pipeline()
+            .Add(functions["Fail"], "facts", "input")
+            .Add(functions["Answer"], "answer", "facts");
+
+        // Act
+        SKContext result = await kernel.RunAsync(pipeline, new ContextVariables("cats"));
+
+        // Assert
+        Assert.True(result.ErrorOccurred);
+        Assert.IsType<InvalidOperationException>(result.LastException);
+        Assert.False(result.Variables.ContainsKey("answer"));
+        Assert.Equal(0, skill.AnswerCount);
+    }
+
+    [Fact]
+    public void ItRejectsDuplicateOutputVariables()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        IDictionary<string, ISKFunction> functions = kernel.ImportSkill(new RecallSkill(), "recall");
+        var pipeline = new Pipeline().Add(functions["Facts"], "facts", "input");
+
+        // Act
+        var exception = Assert.Throws<KernelException>(() => pipeline.Add(functions["History"], "FACTS", "input"));
+
+        // Assert
+        Assert.Equal(KernelException.ErrorCodes.InvalidPipeline, exception.ErrorCode);
+    }
+
+    private sealed class RecallSkill
+    {
+        public TaskCompletionSource<bool> Gate { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        public TaskCompletionSource<bool> FactsStarted { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        public TaskCompletionSource<bool> HistoryStarted { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        public Barrier Started { get; } = new(2);
+
+        public int AnswerCount { get; private set; }
+
+        [SKFunction("Recall facts")]
+        [SKFunctionName("Facts")]
+        public async Task<string> FactsAsync(string input)
+        {
+            this.FactsStarted.SetResult(true);
+            await this.Gate.Task;
+            return $"facts about {input}";
+        }
+
+        [SKFunction("Recall history")]
+        [SKFunctionName("History")]
+        public async Task<string> HistoryAsync(string input)
+        {
+            this.HistoryStarted.SetResult(true);
+            await this.Gate.Task;
+            return $"history of {input}";
+        }
+
+        [SKFunction("Recall facts, blocking the thread")]
+        [SKFunctionName("BlockingFacts")]
+        public string BlockingFacts(string input)
+        {
+            return this.Started.SignalAndWait(TimeSpan.FromSeconds(5)) ? "concurrent" : "sequential";
+        }
+
+        [SKFunction("Recall history, blocking the thread")]
+        [SKFunctionName("BlockingHistory")]
+        public string BlockingHistory(string input)
+        {
+            return this.Started.SignalAndWait(TimeSpan.FromSeconds(5)) ? "concurrent" : "sequential";
+        }
+
+        [SKFunction("Answer")]
+        [SKFunctionName("Answer")]
+        public string Answer(SKContext context)
+        {
+            this.AnswerCount++;
+            return $"{context["facts"]}, {context["history"]}";
+        }
+
+        [SKFunction("Fail")]
+        [SKFunctionName("Fail")]
+        public Task<string> FailAsync(string input)
+        {
+            return Task.FromException<string>(new InvalidOperationException("recall failed"));
+        }
+    }
+}
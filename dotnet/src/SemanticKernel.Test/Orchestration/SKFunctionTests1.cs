@@ -2,7 +2,11 @@
 
 using System;
 using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging.Abstractions;
 using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.Memory;
 using Microsoft.SemanticKernel.Orchestration;
 using Microsoft.SemanticKernel.SemanticFunctions;
 using Microsoft.SemanticKernel.SkillDefinition;
@@ -78,6 +82,26 @@ public sealed class SKFunctionTests1 : IDisposable
         Assert.Equal(settings.MaxTokens, skFunction.RequestSettings.MaxTokens);
     }
 
+    [Fact]
+    public async Task ItRethrowsCancellationRequestedByTheCallerAsync()
+    {
+        // Arrange
+        using var cancel = new CancellationTokenSource();
+        var client = new Mock<ITextCompletionClient>();
+        client.Setup(x => x.CompleteAsync(It.IsAny<string>(), It.IsAny<CompleteRequestSettings>(), It.IsAny<CancellationToken>()))
+            .Callback(() => cancel.Cancel())
+            .ThrowsAsync(new OperationCanceledException(cancel.Token));
+
+        var functionConfig = new SemanticFunctionConfig(new PromptTemplateConfig(), this._promptTemplate.Object);
+        var skFunction = SKFunction.FromSemanticConfig("sk", "name", functionConfig);
+        skFunction.SetAIBackend(() => client.Object);
+        var context = new SKContext(new ContextVariables(), NullMemory.Instance, null, NullLogger.Instance, cancel.Token);
+
+        // Act + Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => skFunction.InvokeAsync(context));
+        Assert.False(context.ErrorOccurred);
+    }
+
     public void Dispose()
     {
         this._testOutputHelper.Dispose();
@@ -0,0 +1,109 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Planning;
+using Microsoft.SemanticKernel.SkillDefinition;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.Planning;
+
+public class FunctionIndexTests
+{
+    [Fact]
+    public async Task ItReturnsAllTheFunctionsWhenBelowTheLimitAsync()
+    {
+        // Arrange
+        var generator = new FakeEmbeddingGenerator();
+        var target = new FunctionIndex(generator, maxFunctions: 5);
+        var functions = new[] { CreateFunction("Pets", "FeedCat", "feed the cat"), CreateFunction("Pets", "WalkDog", "walk the dog") };
+
+        // Act
+        IList<FunctionView> result = await target.GetRelevantFunctionsAsync("feed the cat", functions);
+
+        // Assert
+        Assert.Equal(2, result.Count);
+        Assert.Empty(generator.Texts);
+    }
+
+    [Fact]
+    public async Task ItReturnsTheMostRelevantFunctionsInOrderAsync()
+    {
+        // Arrange
+        var target = new FunctionIndex(new FakeEmbeddingGenerator(), maxFunctions: 2);
+        var functions = new[]
+        {
+            CreateFunction("Pets", "PetCatAndDog", "pet the cat and the dog"),
+            CreateFunction("Pets", "WalkDog", "walk the dog"),
+            CreateFunction("Garage", "WashCar", "wash the car"),
+            CreateFunction("Pets", "FeedCat", "feed the cat"),
+        };
+
+        // Act
+        IList<FunctionView> result = await target.GetRelevantFunctionsAsync("feed the cat", functions);
+
+        // Assert
+        Assert.Equal(new[] { "PetCatAndDog", "FeedCat" }, result.Select(x => x.Name));
+    }
+
+    [Fact]
+    public async Task ItEmbedsOnlyNewAndChangedFunctionsAsync()
+    {
+        // Arrange
+        var generator = new FakeEmbeddingGenerator();
+        var target = new FunctionIndex(generator, maxFunctions: 1);
+        var cat = CreateFunction("Pets", "FeedCat", "feed the cat");
+        var dog = CreateFunction("Pets", "WalkDog", "walk the dog");
+        var car = CreateFunction("Garage", "WashCar", "wash the car");
+
+        // Act
+        await target.GetRelevantFunctionsAsync("cat", new[] { cat, dog });
+        await target.GetRelevantFunctionsAsync("cat", new[] { cat, dog });
+        dog.Description = "walk the dog twice";
+        await target.GetRelevantFunctionsAsync("cat", new[] { cat, dog, car });
+
+        // Assert - function texts are embedded once per version, and the goal at every search
+        Assert.Equal(7, generator.Texts.Count);
+        Assert.Equal(3, target.Count);
+    }
+
+    [Fact]
+    public async Task ItReusesTheEmbeddingOfTheGoalAsync()
+    {
+        // Arrange
+        var generator = new FakeEmbeddingGenerator();
+        var target = new FunctionIndex(generator, maxFunctions: 1);
+        var functions = new[] { CreateFunction("Pets", "FeedCat", "feed the cat"), CreateFunction("Pets", "WalkDog", "walk the dog") };
+        Embedding<float> goalEmbedding = (await generator.GenerateEmbeddingsAsync(new[] { "feed the cat" }))[0];
+        generator.Texts.Clear();
+
+        // Act
+        IList<FunctionView> result = await target.GetRelevantFunctionsAsync("feed the cat", goalEmbedding, functions);
+
+        // Assert - only the functions are embedded
+        Assert.Equal("FeedCat", result.Single().Name);
+        Assert.Equal(2, generator.Texts.Count);
+    }
+
+    [Fact]
+    public void ItDisposesTheEmbeddingGenerator()
+    {
+        // Arrange
+        var generator = new FakeEmbeddingGenerator();
+        var target = new FunctionIndex(generator);
+
+        // Act
+        target.Dispose();
+
+        // Assert
+        Assert.True(generator.IsDisposed);
+    }
+
+    private static FunctionView CreateFunction(string skillName, string name, string description)
+    {
+        return new FunctionView(name, skillName, description, new List<ParameterView>(), isSemantic: false);
+    }
+}
@@ -0,0 +1,146 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Planning;
+using SemanticKernelTests.TestHelpers;
+using Xunit;
+
+namespace SemanticKernelTests.Planning;
+
+public class PlanCacheTests
+{
+    private const string FunctionsManual = "Skill.Function:\n  description: does something\n";
+
+    [Fact]
+    public async Task ItReusesPlansOfSimilarGoalsAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator());
+        await target.SetAsync("feed the cat", FunctionsManual, "<plan>\n  <function.Skill.Function input=\"feed the cat\" />\n</plan>");
+
+        // Act
+        string? similar = await target.TryGetAsync("Wash the cat", FunctionsManual);
+        string? different = await target.TryGetAsync("walk the dog", FunctionsManual);
+
+        // Assert - the goal used as input is replaced
+        Assert.NotNull(similar);
+        Assert.Contains("input=\"Wash the cat\"", similar, StringComparison.Ordinal);
+        Assert.Null(different);
+        Assert.Equal(1, target.Hits);
+        Assert.Equal(1, target.Misses);
+    }
+
+    [Fact]
+    public async Task ItDoesNotReusePlansWithValuesMissingFromTheGoalAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator());
+        await target.SetAsync("feed the cat at noon", FunctionsManual,
+            "<plan>\n  <function.Skill.Function input=\"the cat\" time=\"noon\" setContextVariable=\"FED\" />\n</plan>");
+
+        // Act
+        string? sameValues = await target.TryGetAsync("wash the cat at noon", FunctionsManual);
+        string? otherValues = await target.TryGetAsync("feed the cat at midnight", FunctionsManual);
+
+        // Assert - the goals are similar, but the plan would feed the cat at noon
+        Assert.NotNull(sameValues);
+        Assert.Null(otherValues);
+        Assert.Equal(1, target.Hits);
+        Assert.Equal(1, target.Misses);
+    }
+
+    [Fact]
+    public async Task ItDoesNotReusePlansWhenFunctionsChangeAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator());
+        await target.SetAsync("feed the cat", FunctionsManual, "<plan>\n</plan>");
+
+        // Act
+        string? result = await target.TryGetAsync("feed the cat", FunctionsManual + "Skill.Other:\n  description: new function\n");
+
+        // Assert
+        Assert.Null(result);
+    }
+
+    [Fact]
+    public async Task ItStoresOnlyPlansExecutedSuccessfullyAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator());
+        string collection = PlanCache.GetCollectionName(FunctionsManual);
+        Embedding<float> catEmbedding = await target.GenerateEmbeddingAsync("feed the cat");
+        Embedding<float> dogEmbedding = await target.GenerateEmbeddingAsync("walk the dog");
+        target.AddPendingPlan("1", collection, "feed the cat", catEmbedding, "<plan>\n</plan>");
+        target.AddPendingPlan("2", collection, "walk the dog", dogEmbedding, "<plan>\n</plan>");
+
+        // Act
+        await target.CompletePlanAsync("1", isSuccessful: true);
+        await target.CompletePlanAsync("2", isSuccessful: false);
+
+        // Assert
+        Assert.NotNull(await target.TryGetAsync("feed the cat", FunctionsManual));
+        Assert.Null(await target.TryGetAsync("walk the dog", FunctionsManual));
+        Assert.Equal(0, target.PendingPlansCount);
+    }
+
+    [Fact]
+    public async Task ItRemovesReusedPlansThatFailAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator());
+        string collection = PlanCache.GetCollectionName(FunctionsManual);
+        await target.SetAsync("feed the cat", FunctionsManual, "<plan>\n</plan>");
+        Embedding<float> embedding = await target.GenerateEmbeddingAsync("wash the cat");
+        (string? plan, string cachedPlanId) = await target.TryGetAsync(collection, "wash the cat", embedding);
+        target.AddPendingPlan("1", collection, "wash the cat", embedding, plan!, cachedPlanId);
+
+        // Act
+        await target.CompletePlanAsync("1", isSuccessful: false);
+
+        // Assert
+        Assert.Null(await target.TryGetAsync("feed the cat", FunctionsManual));
+        Assert.Equal(0, target.Count);
+    }
+
+    [Fact]
+    public async Task ItEvictsTheLeastRecentlyUsedPlansAsync()
+    {
+        // Arrange
+        var target = new PlanCache(new FakeEmbeddingGenerator(), maxEntries: 2);
+        await target.SetAsync("feed the cat", FunctionsManual, "<plan>\n</plan>");
+        await target.SetAsync("walk the dog", FunctionsManual, "<plan>\n</plan>");
+        Assert.NotNull(await target.TryGetAsync("feed the cat", FunctionsManual));
+
+        // Act - plans of functions not available anymore are the least recently used
+        await target.SetAsync("wash the car", FunctionsManual + "Skill.Other:\n  description: new function\n", "<plan>\n</plan>");
+
+        // Assert
+        Assert.Equal(2, target.Count);
+        Assert.NotNull(await target.TryGetAsync("feed the cat", FunctionsManual));
+        Assert.Null(await target.TryGetAsync("walk the dog", FunctionsManual));
+    }
+
+    [Fact]
+    public async Task ItStopsTrackingExpiredPendingPlansAsync()
+    {
+        // Arrange
+        DateTimeOffset now = DateTimeOffset.UtcNow;
+        var target = new PlanCache(new FakeEmbeddingGenerator(), null, PlanCache.DefaultMinSimilarity, PlanCache.DefaultMaxEntries, () => now);
+        string collection = PlanCache.GetCollectionName(FunctionsManual);
+        Embedding<float> catEmbedding = await target.GenerateEmbeddingAsync("feed the cat");
+        Embedding<float> dogEmbedding = await target.GenerateEmbeddingAsync("walk the dog");
+        target.AddPendingPlan("1", collection, "feed the cat", catEmbedding, "<plan>\n</plan>");
+
+        // Act
+        now += PlanCache.s_pendingPlanTimeToLive;
+        target.AddPendingPlan("2", collection, "walk the dog", dogEmbedding, "<plan>\n</plan>");
+        await target.CompletePlanAsync("1", isSuccessful: true);
+
+        // Assert
+        Assert.Equal(1, target.PendingPlansCount);
+        Assert.Null(await target.TryGetAsync("feed the cat", FunctionsManual));
+    }
+}
@@ -0,0 +1,51 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using Microsoft.SemanticKernel;
+using Microsoft.SemanticKernel.CoreSkills;
+using Microsoft.SemanticKernel.Planning;
+using Xunit;
+
+namespace SemanticKernelTests.Planning;
+
+public class SKContextExtensionsTests
+{
+    [Fact]
+    public void ItIncrementsTheSkillCollectionVersion()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        long version = kernel.Skills.Version;
+
+        // Act
+        kernel.ImportSkill(new TextSkill(), "text");
+
+        // Assert
+        Assert.True(kernel.Skills.Version > version);
+    }
+
+    [Fact]
+    public void ItReusesTheFunctionsManualUntilFunctionsChange()
+    {
+        // Arrange
+        var kernel = KernelBuilder.Create();
+        kernel.ImportSkill(new TextSkill(), "text");
+        var context = kernel.CreateNewContext();
+        var excludedFunctions = new List<string> { "Trim" };
+
+        // Act
+        string first = context.GetFunctionsManual(excludedFunctions: excludedFunctions);
+        string second = kernel.CreateNewContext().GetFunctionsManual(excludedFunctions: excludedFunctions);
+        string otherExclusions = context.GetFunctionsManual();
+        kernel.ImportSkill(new TimeSkill(), "time");
+        string afterImport = context.GetFunctionsManual(excludedFunctions: excludedFunctions);
+
+        // Assert
+        Assert.Same(first, second);
+        Assert.DoesNotContain("text.Trim:", first, StringComparison.Ordinal);
+        Assert.Contains("text.Trim:", otherExclusions, StringComparison.Ordinal);
+        Assert.DoesNotContain("time.", first, StringComparison.Ordinal);
+        Assert.Contains("time.", afterImport, StringComparison.Ordinal);
+    }
+}
@@ -0,0 +1,151 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Reliability;
+using Xunit;
+
+namespace SemanticKernelTests.Reliability;
+
+public class AdaptiveConcurrencyLimiterTests
+{
+    [Fact]
+    public async Task ItQueuesRequestsAboveTheLimitAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(2, 1, 10, 2, 0.5, clock.Now);
+        var first = await target.AcquireAsync();
+        await target.AcquireAsync();
+
+        // Act
+        var third = target.AcquireAsync();
+
+        // Assert
+        Assert.False(third.IsCompleted);
+        Assert.Equal(2, target.InFlight);
+        Assert.Equal(1, target.QueueDepth);
+
+        first.Release(AdaptiveConcurrencyLimiter.Outcome.Ignore);
+        await third;
+        Assert.Equal(0, target.QueueDepth);
+    }
+
+    [Fact]
+    public async Task ItGrowsTheLimitWhileLatencyIsStableAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(4, 1, 10, 2, 0.5, clock.Now);
+
+        // Act: rounds of 4 concurrent requests, 100 ms each
+        for (int round = 0; round < 4; round++)
+        {
+            var leases = new List<AdaptiveConcurrencyLimiter.Lease>();
+            for (int i = 0; i < 4; i++) { leases.Add(await target.AcquireAsync()); }
+
+            clock.Advance(TimeSpan.FromMilliseconds(100));
+            leases.ForEach(x => x.Release(AdaptiveConcurrencyLimiter.Outcome.Success));
+        }
+
+        // Assert
+        Assert.True(target.CurrentLimit > 4);
+    }
+
+    [Fact]
+    public async Task ItReducesTheLimitOncePerRoundWhenThrottledAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(8, 1, 10, 2, 0.5, clock.Now);
+        var leases = new List<AdaptiveConcurrencyLimiter.Lease>();
+        for (int i = 0; i < 8; i++) { leases.Add(await target.AcquireAsync()); }
+
+        // Act
+        clock.Advance(TimeSpan.FromMilliseconds(100));
+        leases.ForEach(x => x.Release(AdaptiveConcurrencyLimiter.Outcome.Overload));
+
+        // Assert
+        Assert.Equal(4, target.CurrentLimit);
+    }
+
+    [Fact]
+    public async Task ItReducesTheLimitWhenLatencyGrowsAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(8, 1, 10, 2, 0.5, clock.Now);
+        var lease = await target.AcquireAsync();
+        clock.Advance(TimeSpan.FromMilliseconds(100));
+        lease.Release(AdaptiveConcurrencyLimiter.Outcome.Success);
+        int limit = target.CurrentLimit;
+
+        // Act
+        lease = await target.AcquireAsync();
+        clock.Advance(TimeSpan.FromMilliseconds(500));
+        lease.Release(AdaptiveConcurrencyLimiter.Outcome.Success);
+
+        // Assert
+        Assert.True(target.CurrentLimit < limit);
+    }
+
+    [Fact]
+    public async Task ItNeverGoesBelowTheMinLimitAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(2, 2, 10, 2, 0.5, clock.Now);
+
+        // Act
+        for (int i = 0; i < 5; i++)
+        {
+            var lease = await target.AcquireAsync();
+            clock.Advance(TimeSpan.FromMilliseconds(100));
+            lease.Release(AdaptiveConcurrencyLimiter.Outcome.Overload);
+        }
+
+        // Assert
+        Assert.Equal(2, target.CurrentLimit);
+    }
+
+    [Fact]
+    public async Task ItRemovesCancelledRequestsFromTheQueueAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new AdaptiveConcurrencyLimiter(1, 1, 10, 2, 0.5, clock.Now);
+        var lease = await target.AcquireAsync();
+        using var cts = new CancellationTokenSource();
+        var queued = target.AcquireAsync(cts.Token);
+
+        // Act
+        cts.Cancel();
+
+        // Assert
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => queued);
+        Assert.Equal(0, target.QueueDepth);
+        lease.Release(AdaptiveConcurrencyLimiter.Outcome.Success);
+        Assert.Equal(0, target.InFlight);
+    }
+
+    #region private ================================================================================
+
+    private sealed class FakeClock
+    {
+        private TimeSpan _now;
+
+        public TimeSpan Now()
+        {
+            return this._now;
+        }
+
+        public void Advance(TimeSpan time)
+        {
+            this._now += time;
+        }
+    }
+
+    #endregion
+}
@@ -0,0 +1,84 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Net;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Reliability;
+using Xunit;
+
+namespace SemanticKernelTests.Reliability;
+
+public class ConcurrencyLimitingHandlerTests
+{
+    [Fact]
+    public async Task ItLimitsEachAttemptAndReleasesTheLeaseDuringRetryDelaysAsync()
+    {
+        // Arrange
+        const string Endpoint = "https://concurrency-limiting-handler-test";
+        var limiter = RateLimiterRegistry.SetConcurrencyLimiter(Endpoint, new AdaptiveConcurrencyLimiter(initialLimit: 10));
+        var inner = new FakeHttpHandler(HttpStatusCode.ServiceUnavailable, HttpStatusCode.BadGateway, HttpStatusCode.OK);
+        int inFlightDuringDelays = 0;
+        var retryHandler = new DefaultHttpRetryHandler(new HttpRetryConfig(), null, null,
+            (delay, cancellationToken) =>
+            {
+                inFlightDuringDelays += limiter.InFlight;
+                return Task.CompletedTask;
+            })
+        {
+            InnerHandler = new ConcurrencyLimitingHandler { InnerHandler = inner }
+        };
+
+        try
+        {
+            using var invoker = new HttpMessageInvoker(retryHandler);
+
+            // Act
+            using var response = await invoker.SendAsync(new HttpRequestMessage(HttpMethod.Post, $"{Endpoint}/completions"), CancellationToken.None);
+
+            // Assert - each failed attempt reduced the limit
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            Assert.Equal(3, inner.RequestCount);
+            Assert.Equal(0, inFlightDuringDelays);
+            Assert.Equal(0, limiter.InFlight);
+            Assert.True(limiter.CurrentLimit < 7);
+        }
+        finally
+        {
+            RateLimiterRegistry.RemoveConcurrencyLimiter(Endpoint);
+        }
+    }
+
+    [Theory]
+    [InlineData(HttpStatusCode.OK, AdaptiveConcurrencyLimiter.Outcome.Success)]
+    [InlineData(HttpStatusCode.TooManyRequests, AdaptiveConcurrencyLimiter.Outcome.Overload)]
+    [InlineData(HttpStatusCode.RequestTimeout, AdaptiveConcurrencyLimiter.Outcome.Overload)]
+    [InlineData(HttpStatusCode.InternalServerError, AdaptiveConcurrencyLimiter.Outcome.Overload)]
+    [InlineData(HttpStatusCode.BadGateway, AdaptiveConcurrencyLimiter.Outcome.Overload)]
+    [InlineData(HttpStatusCode.ServiceUnavailable, AdaptiveConcurrencyLimiter.Outcome.Overload)]
+    [InlineData(HttpStatusCode.BadRequest, AdaptiveConcurrencyLimiter.Outcome.Ignore)]
+    public void ItTreatsThrottlingAndServerErrorsAsOverload(HttpStatusCode statusCode, AdaptiveConcurrencyLimiter.Outcome expected)
+    {
+        // Act + Assert
+        Assert.Equal(expected, ConcurrencyLimitingHandler.GetOutcome(statusCode));
+    }
+
+    private sealed class FakeHttpHandler : HttpMessageHandler
+    {
+        private readonly HttpStatusCode[] _statusCodes;
+
+        public FakeHttpHandler(params HttpStatusCode[] statusCodes)
+        {
+            this._statusCodes = statusCodes;
+        }
+
+        public int RequestCount { get; private set; }
+
+        protected override Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+        {
+            int index = this.RequestCount++;
+            return Task.FromResult(new HttpResponseMessage(this._statusCodes[Math.Min(index, this._statusCodes.Length - 1)]));
+        }
+    }
+}
@@ -0,0 +1,268 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Net;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Reliability;
+using Xunit;
+
+namespace SemanticKernelTests.Reliability;
+
+public class DefaultHttpRetryHandlerTests
+{
+    [Fact]
+    public async Task ItRetriesThrottledRequestsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.TooManyRequests, HttpStatusCode.ServiceUnavailable, HttpStatusCode.OK);
+        var delays = new List<TimeSpan>();
+        using var invoker = CreateInvoker(new HttpRetryConfig(), inner, delays);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+        Assert.Equal(3, inner.RequestCount);
+        Assert.Equal(2, delays.Count);
+    }
+
+    [Fact]
+    public async Task ItDoesNotRetryInvalidRequestsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.BadRequest, HttpStatusCode.OK);
+        var delays = new List<TimeSpan>();
+        using var invoker = CreateInvoker(new HttpRetryConfig(), inner, delays);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.BadRequest, response.StatusCode);
+        Assert.Equal(1, inner.RequestCount);
+        Assert.Empty(delays);
+    }
+
+    [Fact]
+    public async Task ItHonorsRetryAfterHeadersAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.TooManyRequests, HttpStatusCode.TooManyRequests, HttpStatusCode.OK);
+        inner.Headers[0] = ("Retry-After", "7");
+        inner.Headers[1] = ("retry-after-ms", "1500");
+        var delays = new List<TimeSpan>();
+        using var invoker = CreateInvoker(new HttpRetryConfig(), inner, delays);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+        Assert.Equal(new[] { TimeSpan.FromSeconds(7), TimeSpan.FromMilliseconds(1500) }, delays);
+    }
+
+    [Fact]
+    public async Task ItUsesDecorrelatedJitterAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.InternalServerError, HttpStatusCode.InternalServerError, HttpStatusCode.OK);
+        var config = new HttpRetryConfig { MinRetryDelay = TimeSpan.FromSeconds(1), MaxRetryDelay = TimeSpan.FromSeconds(5) };
+        var delays = new List<TimeSpan>();
+        using var invoker = CreateInvoker(config, inner, delays, random: () => 1);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert: 1s * 3, then capped to the max delay
+        Assert.Equal(new[] { TimeSpan.FromSeconds(3), TimeSpan.FromSeconds(5) }, delays);
+    }
+
+    [Fact]
+    public async Task ItStopsAfterMaxRetryCountAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.ServiceUnavailable);
+        var config = new HttpRetryConfig { MaxRetryCount = 2 };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.ServiceUnavailable, response.StatusCode);
+        Assert.Equal(3, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItStopsWhenTheRetryWouldExceedTheMaxRetryTimeAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.TooManyRequests, HttpStatusCode.OK);
+        inner.Headers[0] = ("Retry-After", "600");
+        using var invoker = CreateInvoker(new HttpRetryConfig(), inner, new List<TimeSpan>());
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.TooManyRequests, response.StatusCode);
+        Assert.Equal(1, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItStopsRetryingWhenTheBudgetIsExhaustedAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.ServiceUnavailable);
+        var config = new HttpRetryConfig { MaxRetryCount = 5, RetryBudgetRatio = 0, MinRetryBudget = 2 };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+
+        // Act
+        using var first = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+        using var second = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert: 1 request + 2 retries, then 1 request without retries
+        Assert.Equal(4, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItRetriesNetworkErrorsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.OK) { FailuresBeforeResponse = 1 };
+        using var invoker = CreateInvoker(new HttpRetryConfig(), inner, new List<TimeSpan>());
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItRethrowsTheLastErrorWhenTheBudgetIsExhaustedAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.OK) { FailuresBeforeResponse = 10 };
+        var config = new HttpRetryConfig { MaxRetryCount = 5, RetryBudgetRatio = 0, MinRetryBudget = 1 };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+
+        // Act
+        var e = await Assert.ThrowsAsync<HttpRequestException>(() => invoker.SendAsync(CreateRequest(), CancellationToken.None));
+
+        // Assert: 1 request + 1 retry
+        Assert.Equal("connection reset", e.Message);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItRethrowsTheLastErrorWhenTheRetryWouldExceedTheMaxRetryTimeAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.OK) { FailuresBeforeResponse = 10 };
+        var config = new HttpRetryConfig { MinRetryDelay = TimeSpan.FromMinutes(1), MaxTotalRetryTime = TimeSpan.FromSeconds(1) };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+
+        // Act
+        var e = await Assert.ThrowsAsync<HttpRequestException>(() => invoker.SendAsync(CreateRequest(), CancellationToken.None));
+
+        // Assert
+        Assert.Equal("connection reset", e.Message);
+        Assert.Equal(1, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItRetriesAttemptsExceedingTheAttemptTimeoutAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.OK) { HangsBeforeResponse = 1 };
+        var config = new HttpRetryConfig { AttemptTimeout = TimeSpan.FromMilliseconds(50) };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItDoesNotRetryRequestsCancelledByTheCallerAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(HttpStatusCode.OK) { HangsBeforeResponse = 1 };
+        var config = new HttpRetryConfig { AttemptTimeout = TimeSpan.FromSeconds(30) };
+        using var invoker = CreateInvoker(config, inner, new List<TimeSpan>());
+        using var cancel = new CancellationTokenSource(TimeSpan.FromMilliseconds(50));
+
+        // Act
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => invoker.SendAsync(CreateRequest(), cancel.Token));
+
+        // Assert
+        Assert.Equal(1, inner.RequestCount);
+    }
+
+    #region private ================================================================================
+
+    private static HttpMessageInvoker CreateInvoker(
+        HttpRetryConfig config, FakeHttpHandler inner, List<TimeSpan> delays, Func<double>? random = null)
+    {
+        var handler = new DefaultHttpRetryHandler(config, null, null,
+            (delay, cancellationToken) =>
+            {
+                delays.Add(delay);
+                return Task.CompletedTask;
+            },
+            random)
+        {
+            InnerHandler = inner
+        };
+
+        return new HttpMessageInvoker(handler);
+    }
+
+    private static HttpRequestMessage CreateRequest()
+    {
+        return new HttpRequestMessage(HttpMethod.Post, "https://localhost/completions") { Content = new StringContent("{}") };
+    }
+
+    private sealed class FakeHttpHandler : HttpMessageHandler
+    {
+        private readonly HttpStatusCode[] _statusCodes;
+
+        public FakeHttpHandler(params HttpStatusCode[] statusCodes)
+        {
+            this._statusCodes = statusCodes;
+        }
+
+        public int RequestCount { get; private set; }
+
+        public int FailuresBeforeResponse { get; set; }
+
+        public int HangsBeforeResponse { get; set; }
+
+        public Dictionary<int, (string Name, string Value)> Headers { get; } = new();
+
+        protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+        {
+            int index = this.RequestCount++;
+            if (index < this.HangsBeforeResponse) { await Task.Delay(Timeout.Infinite, cancellationToken); }
+
+            if (index < this.FailuresBeforeResponse) { throw new HttpRequestException("connection reset"); }
+
+            index -= this.FailuresBeforeResponse;
+            var response = new HttpResponseMessage(this._statusCodes[Math.Min(index, this._statusCodes.Length - 1)]);
+            if (this.Headers.TryGetValue(index, out var header)) { response.Headers.TryAddWithoutValidation(header.Name, header.Value); }
+
+            return response;
+        }
+    }
+
+    #endregion
+}
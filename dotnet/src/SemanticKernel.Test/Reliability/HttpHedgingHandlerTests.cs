@@ -0,0 +1,252 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Net;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Reliability;
+using Xunit;
+
+namespace SemanticKernelTests.Reliability;
+
+public class HttpHedgingHandlerTests
+{
+    [Fact]
+    public async Task ItSendsADuplicateOfSlowRequestsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromSeconds(30), TimeSpan.Zero);
+        using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20) }, inner);
+        using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert: the duplicate request wins, the slow request is cancelled
+        Assert.Equal("2", response.ReasonPhrase);
+        Assert.Equal(3, inner.RequestCount);
+        await inner.WaitForCancellationAsync(1);
+        Assert.Equal("{\"prompt\":\"test\"}", inner.Bodies[2]);
+    }
+
+    [Fact]
+    public async Task ItDoesNotHedgeWithoutLatencyStatisticsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(TimeSpan.FromMilliseconds(100));
+        using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 5, MinHedgeDelay = TimeSpan.FromMilliseconds(1) }, inner);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal(1, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItDoesNotHedgeWhenTheBudgetIsExhaustedAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromMilliseconds(200));
+        var config = new HttpHedgingConfig
+        {
+            MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20), HedgeBudgetRatio = 0, MinHedgeBudget = 0
+        };
+        using var invoker = CreateInvoker(config, inner);
+        using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Assert
+        Assert.Equal("1", response.ReasonPhrase);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItChargesDuplicatesToTheRateLimiterAsync()
+    {
+        // Arrange: the limiter allows a single request, and is never refilled
+        var limiter = new TokenBucketRateLimiter(6, 0, 1, TimeSpan.FromSeconds(10), () => TimeSpan.Zero, null);
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromSeconds(30), TimeSpan.Zero);
+        using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20) }, inner);
+        using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(limiter: limiter), CancellationToken.None);
+
+        // Assert
+        Assert.Equal("2", response.ReasonPhrase);
+        Assert.Equal(3, inner.RequestCount);
+        Assert.False(limiter.TryAcquire(0));
+    }
+
+    [Fact]
+    public async Task ItDoesNotHedgeWhenTheRateLimitIsReachedAsync()
+    {
+        // Arrange: the limiter allows a single request, already used
+        var limiter = new TokenBucketRateLimiter(6, 0, 1, TimeSpan.FromSeconds(10), () => TimeSpan.Zero, null);
+        Assert.True(limiter.TryAcquire(0));
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromMilliseconds(200));
+        using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20) }, inner);
+        using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest(limiter: limiter), CancellationToken.None);
+
+        // Assert
+        Assert.Equal("1", response.ReasonPhrase);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItTracksLatenciesByOperationAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromMilliseconds(200));
+        using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20) }, inner);
+        using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+        // Act
+        using var response = await invoker.SendAsync(CreateRequest("https://localhost/embeddings"), CancellationToken.None);
+
+        // Assert: no statistics for the embeddings yet, the slow request is not hedged
+        Assert.Equal("1", response.ReasonPhrase);
+        Assert.Equal(2, inner.RequestCount);
+    }
+
+    [Fact]
+    public async Task ItObservesTheFailureOfBothRequestsAsync()
+    {
+        // Arrange
+        var inner = new FakeHttpHandler(TimeSpan.Zero, TimeSpan.FromMilliseconds(100), TimeSpan.Zero) { FailuresFrom = 1 };
+        var unobserved = new List<Exception>();
+        void OnUnobserved(object? sender, UnobservedTaskExceptionEventArgs e)
+        {
+            lock (unobserved) { unobserved.AddRange(e.Exception.InnerExceptions); }
+        }
+
+        TaskScheduler.UnobservedTaskException += OnUnobserved;
+        try
+        {
+            using var invoker = CreateInvoker(new HttpHedgingConfig { MinLatencySamples = 1, MinHedgeDelay = TimeSpan.FromMilliseconds(20) }, inner);
+            using var warmUp = await invoker.SendAsync(CreateRequest(), CancellationToken.None);
+
+            // Act
+            await Assert.ThrowsAsync<HttpRequestException>(() => invoker.SendAsync(CreateRequest(), CancellationToken.None));
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+
+            // Assert
+            Assert.Equal(3, inner.RequestCount);
+            lock (unobserved) { Assert.DoesNotContain(unobserved, x => x.Message.StartsWith("hedging test failure", StringComparison.Ordinal)); }
+        }
+        finally
+        {
+            TaskScheduler.UnobservedTaskException -= OnUnobserved;
+        }
+    }
+
+    [Fact]
+    public void ItRefreshesLatencyPercentilesEveryFewSamples()
+    {
+        // Arrange
+        var target = new LatencyTracker(10, refreshInterval: 5);
+        for (int i = 1; i <= 10; i++) { target.Add(TimeSpan.FromMilliseconds(i)); }
+
+        // Act
+        TimeSpan? initial = target.GetPercentile(1);
+        target.Add(TimeSpan.FromMilliseconds(100));
+        TimeSpan? cached = target.GetPercentile(1);
+        for (int i = 0; i < 4; i++) { target.Add(TimeSpan.FromMilliseconds(1)); }
+
+        TimeSpan? refreshed = target.GetPercentile(1);
+
+        // Assert
+        Assert.Equal(TimeSpan.FromMilliseconds(10), initial);
+        Assert.Equal(TimeSpan.FromMilliseconds(10), cached);
+        Assert.Equal(TimeSpan.FromMilliseconds(100), refreshed);
+    }
+
+    [Fact]
+    public void ItComputesLatencyPercentiles()
+    {
+        // Arrange
+        var target = new LatencyTracker(10);
+
+        // Act
+        for (int i = 1; i <= 20; i++) { target.Add(TimeSpan.FromMilliseconds(i)); }
+
+        // Assert: only the last 10 latencies are tracked
+        Assert.Equal(10, target.Count);
+        Assert.Equal(TimeSpan.FromMilliseconds(11), target.GetPercentile(0));
+        Assert.Equal(TimeSpan.FromMilliseconds(15), target.GetPercentile(0.5));
+        Assert.Equal(TimeSpan.FromMilliseconds(20), target.GetPercentile(1));
+    }
+
+    #region private ================================================================================
+
+    private static HttpMessageInvoker CreateInvoker(HttpHedgingConfig config, FakeHttpHandler inner)
+    {
+        return new HttpMessageInvoker(new HttpHedgingHandler(config) { InnerHandler = inner });
+    }
+
+    private static HttpRequestMessage CreateRequest(string url = "https://localhost/completions", TokenBucketRateLimiter? limiter = null)
+    {
+        var request = new HttpRequestMessage(HttpMethod.Post, url) { Content = new StringContent("{\"prompt\":\"test\"}") };
+        if (limiter != null) { request.Properties[TokenBucketRateLimiter.ChargeProperty] = new TokenBucketRateLimiter.Charge(limiter, 0); }
+
+        return request;
+    }
+
+    private sealed class FakeHttpHandler : HttpMessageHandler
+    {
+        private readonly TimeSpan[] _delays;
+        private readonly Dictionary<int, TaskCompletionSource<bool>> _cancellations = new();
+        private int _requestCount;
+
+        public FakeHttpHandler(params TimeSpan[] delays)
+        {
+            this._delays = delays;
+        }
+
+        public int RequestCount => this._requestCount;
+
+        public int FailuresFrom { get; set; } = int.MaxValue;
+
+        public Dictionary<int, string> Bodies { get; } = new();
+
+        public Task WaitForCancellationAsync(int index)
+        {
+            lock (this._cancellations) { return this._cancellations[index].Task; }
+        }
+
+        protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+        {
+            int index = Interlocked.Increment(ref this._requestCount) - 1;
+            var cancelled = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+            lock (this._cancellations) { this._cancellations[index] = cancelled; }
+
+            string body = await request.Content!.ReadAsStringAsync();
+            lock (this.Bodies) { this.Bodies[index] = body; }
+
+            try
+            {
+                await Task.Delay(this._delays[Math.Min(index, this._delays.Length - 1)], cancellationToken);
+            }
+            catch (OperationCanceledException)
+            {
+                cancelled.SetResult(true);
+                throw;
+            }
+
+            if (index >= this.FailuresFrom) { throw new HttpRequestException($"hedging test failure {index}"); }
+
+            return new HttpResponseMessage(HttpStatusCode.OK) { ReasonPhrase = index.ToString(System.Globalization.CultureInfo.InvariantCulture) };
+        }
+    }
+
+    #endregion
+}
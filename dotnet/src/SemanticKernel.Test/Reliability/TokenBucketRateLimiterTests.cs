@@ -0,0 +1,152 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Reliability;
+using Xunit;
+
+namespace SemanticKernelTests.Reliability;
+
+public class TokenBucketRateLimiterTests
+{
+    [Fact]
+    public async Task ItAllowsBurstsWithinTheQuotaAsync()
+    {
+        // Arrange: 60 RPM and a 10 seconds burst window allow 10 requests at once
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(60, 0, 1, TimeSpan.FromSeconds(10), clock.Now, clock.DelayAsync);
+
+        // Act
+        for (int i = 0; i < 10; i++) { await target.AcquireAsync(100); }
+
+        // Assert
+        Assert.Equal(TimeSpan.Zero, clock.Elapsed);
+    }
+
+    [Fact]
+    public async Task ItWaitsWhenTheRequestQuotaIsUsedAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(60, 0, 1, TimeSpan.FromSeconds(10), clock.Now, clock.DelayAsync);
+        for (int i = 0; i < 10; i++) { await target.AcquireAsync(100); }
+
+        // Act
+        await target.AcquireAsync(100);
+
+        // Assert: one request per second
+        Assert.Equal(TimeSpan.FromSeconds(1), clock.Elapsed);
+    }
+
+    [Fact]
+    public async Task ItWaitsWhenTheTokenQuotaIsUsedAsync()
+    {
+        // Arrange: 6000 TPM, i.e. 100 tokens per second, 1000 tokens in the bucket
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(0, 6000, 1, TimeSpan.FromSeconds(10), clock.Now, clock.DelayAsync);
+        await target.AcquireAsync(1000);
+
+        // Act
+        await target.AcquireAsync(500);
+
+        // Assert
+        Assert.Equal(TimeSpan.FromSeconds(5), clock.Elapsed);
+    }
+
+    [Fact]
+    public async Task ItReconcilesTheActualUsageAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(0, 6000, 1, TimeSpan.FromSeconds(10), clock.Now, clock.DelayAsync);
+        await target.AcquireAsync(1000);
+
+        // Act: the request used only 200 tokens, 800 are returned to the bucket
+        target.Reconcile(1000, 200);
+        await target.AcquireAsync(800);
+
+        // Assert
+        Assert.Equal(TimeSpan.Zero, clock.Elapsed);
+    }
+
+    [Fact]
+    public async Task ItUsesOnlyPartOfTheQuotaAsync()
+    {
+        // Arrange: 90% of 600 RPM, i.e. 9 requests per second, 9 requests in the bucket
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(600, 0, 0.9, TimeSpan.FromSeconds(1), clock.Now, clock.DelayAsync);
+
+        // Act
+        for (int i = 0; i < 18; i++) { await target.AcquireAsync(0); }
+
+        // Assert
+        Assert.True(clock.Elapsed >= TimeSpan.FromSeconds(1));
+        Assert.True(clock.Elapsed < TimeSpan.FromSeconds(1.1));
+    }
+
+    [Fact]
+    public async Task ItServesCallersInOrderAsync()
+    {
+        // Arrange: 1 request every 10 ms, with the real clock
+        var target = new TokenBucketRateLimiter(6000, 0, 1, TimeSpan.FromMilliseconds(10), null, null);
+        var order = new List<int>();
+        await target.AcquireAsync(0);
+
+        // Act
+        var tasks = new List<Task>();
+        for (int i = 0; i < 3; i++)
+        {
+            int id = i;
+            tasks.Add(target.AcquireAsync(0).ContinueWith(_ =>
+            {
+                lock (order) { order.Add(id); }
+            }, TaskScheduler.Default));
+        }
+
+        await Task.WhenAll(tasks);
+
+        // Assert
+        Assert.Equal(new[] { 0, 1, 2 }, order);
+    }
+
+    [Fact]
+    public async Task ItDoesNotBlockTheQueueWhenCancelledAsync()
+    {
+        // Arrange
+        var clock = new FakeClock();
+        var target = new TokenBucketRateLimiter(60, 0, 1, TimeSpan.FromSeconds(1), clock.Now, clock.DelayAsync);
+        await target.AcquireAsync(0);
+        using var cts = new CancellationTokenSource();
+        cts.Cancel();
+
+        // Act
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => target.AcquireAsync(0, cts.Token));
+        await target.AcquireAsync(0);
+
+        // Assert
+        Assert.Equal(TimeSpan.FromSeconds(1), clock.Elapsed);
+    }
+
+    #region private ================================================================================
+
+    private sealed class FakeClock
+    {
+        public TimeSpan Elapsed { get; private set; }
+
+        public TimeSpan Now()
+        {
+            return this.Elapsed;
+        }
+
+        public Task DelayAsync(TimeSpan delay, CancellationToken cancellationToken)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+            this.Elapsed += delay;
+            return Task.CompletedTask;
+        }
+    }
+
+    #endregion
+}
@@ -0,0 +1,259 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Logging.Abstractions;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.Memory;
+using Microsoft.SemanticKernel.Orchestration;
+using Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
+using Microsoft.SemanticKernel.SkillDefinition;
+using Xunit;
+
+namespace SemanticKernelTests.SemanticFunctions.Partitioning;
+
+public class FunctionExtensionsTests
+{
+    [Fact]
+    public async Task ItAggregatesResultsInInputOrderAsync()
+    {
+        // Arrange
+        int running = 0;
+        int maxRunning = 0;
+        var func = new FakeFunction(async context =>
+        {
+            int current = Interlocked.Increment(ref running);
+            InterlockedMax(ref maxRunning, current);
+
+            // Complete the first partitions last
+            await Task.Delay(10 * (10 - int.Parse(context.Variables.Input[1..], System.Globalization.CultureInfo.InvariantCulture)));
+            context.Variables.Update(context.Variables.Input.ToUpperInvariant());
+
+            Interlocked.Decrement(ref running);
+            return context;
+        });
+        var partitions = Enumerable.Range(0, 10).Select(x => $"p{x}").ToList();
+
+        // Act
+        SKContext result = await func.AggregatePartitionedResultsAsync(partitions, CreateContext(), 3);
+
+        // Assert
+        Assert.False(result.ErrorOccurred);
+        Assert.Equal(string.Join("\n", partitions.Select(x => x.ToUpperInvariant())), result.Result);
+        Assert.True(maxRunning > 1);
+        Assert.True(maxRunning <= 3);
+    }
+
+    [Fact]
+    public async Task ItProcessesEachPartitionWithItsOwnVariablesAsync()
+    {
+        // Arrange
+        var func = new FakeFunction(async context =>
+        {
+            await Task.Yield();
+            context.Variables.Update($"{context["style"]}:{context.Variables.Input}");
+            context["style"] = "changed";
+            return context;
+        });
+        SKContext context = CreateContext();
+        context["style"] = "short";
+
+        // Act
+        SKContext result = await func.AggregatePartitionedResultsAsync(new List<string> { "a", "b", "c" }, context, 2);
+
+        // Assert
+        Assert.Equal("short:a\nshort:b\nshort:c", result.Result);
+        Assert.Equal("short", result["style"]);
+    }
+
+    [Fact]
+    public async Task ItStopsProcessingWhenAPartitionFailsAsync()
+    {
+        // Arrange
+        int invocations = 0;
+        var func = new FakeFunction(async context =>
+        {
+            Interlocked.Increment(ref invocations);
+            if (context.Variables.Input == "p1") { return context.Fail("something went wrong"); }
+
+            await Task.Delay(1000, context.CancellationToken);
+            return context;
+        });
+        var partitions = Enumerable.Range(0, 20).Select(x => $"p{x}").ToList();
+
+        // Act
+        SKContext result = await func.AggregatePartitionedResultsAsync(partitions, CreateContext(), 2);
+
+        // Assert
+        Assert.True(result.ErrorOccurred);
+        Assert.Equal("something went wrong", result.LastErrorDescription);
+        Assert.True(invocations < partitions.Count);
+    }
+
+    [Fact]
+    public async Task ItReportsExceptionsAsFailuresAsync()
+    {
+        // Arrange
+        var func = new FakeFunction(context => throw new InvalidOperationException("boom"));
+
+        // Act
+        SKContext result = await func.AggregatePartitionedResultsAsync(new List<string> { "a", "b" }, CreateContext(), 2);
+
+        // Assert
+        Assert.True(result.ErrorOccurred);
+        Assert.IsType<InvalidOperationException>(result.LastException);
+    }
+
+    [Fact]
+    public async Task ItDoesNotReduceResultsFittingTheBudgetAsync()
+    {
+        // Arrange
+        int invocations = 0;
+        var func = new FakeFunction(context =>
+        {
+            Interlocked.Increment(ref invocations);
+            return Task.FromResult(context);
+        });
+
+        // Act
+        SKContext result = await func.ReducePartitionedResultsAsync(
+            new List<string> { "one", "two", "three" }, CreateContext(), HeuristicTokenizer.Instance, 100, 2);
+
+        // Assert
+        Assert.Equal("one\ntwo\nthree", result.Result);
+        Assert.Equal(3, invocations);
+    }
+
+    [Fact]
+    public async Task ItReducesResultsUntilTheyFitTheBudgetAsync()
+    {
+        // Arrange
+        int invocations = 0;
+        var func = new FakeFunction(context =>
+        {
+            Interlocked.Increment(ref invocations);
+
+            // "Summarize" keeping the first 3 words
+            context.Variables.Update(string.Join(" ", context.Variables.Input.Split(new[] { ' ', '\n' }).Take(3)));
+            return Task.FromResult(context);
+        });
+        var partitions = Enumerable.Range(0, 64).Select(x => string.Join(" ", Enumerable.Repeat($"word{x}", 50))).ToList();
+
+        // Act
+        SKContext result = await func.ReducePartitionedResultsAsync(partitions, CreateContext(), HeuristicTokenizer.Instance, 20, 4);
+
+        // Assert
+        Assert.False(result.ErrorOccurred);
+        Assert.True(HeuristicTokenizer.Instance.CountTokens(result.Result) <= 20);
+        Assert.StartsWith("word0 word0", result.Result, StringComparison.Ordinal);
+
+        // 64 partitions, then at most 32 + 16 + 8 + 4 + 2 + 1
+        Assert.True(invocations > 64);
+        Assert.True(invocations <= 127);
+    }
+
+    [Fact]
+    public async Task ItDoesNotExceedTheBudgetWithResultsCloseToTheBudgetAsync()
+    {
+        // Arrange
+        var inputs = new ConcurrentBag<string>();
+        var func = new FakeFunction(context =>
+        {
+            inputs.Add(context.Variables.Input);
+
+            // "Summarize" keeping half of the words, up to 16 words
+            string[] words = context.Variables.Input.Split(new[] { ' ', '\n' });
+            context.Variables.Update(string.Join(" ", words.Take(Math.Min(16, words.Length / 2))));
+            return Task.FromResult(context);
+        });
+        var partitions = Enumerable.Range(0, 4).Select(x => string.Join(" ", Enumerable.Repeat($"word{x}", 40))).ToList();
+
+        // Two results of the first level don't fit together in the budget
+        int maxTokens = HeuristicTokenizer.Instance.CountTokens(string.Join(" ", Enumerable.Repeat("word0", 16))) + 2;
+
+        // Act
+        SKContext result = await func.ReducePartitionedResultsAsync(partitions, CreateContext(), HeuristicTokenizer.Instance, maxTokens, 4);
+
+        // Assert - the inputs of the reduction, i.e. not the partitions, fit the budget
+        Assert.False(result.ErrorOccurred);
+        Assert.True(HeuristicTokenizer.Instance.CountTokens(result.Result) <= maxTokens);
+        Assert.All(inputs.Where(x => !partitions.Contains(x)), x => Assert.True(HeuristicTokenizer.Instance.CountTokens(x) <= maxTokens));
+    }
+
+    private static SKContext CreateContext()
+    {
+        return new SKContext(new ContextVariables(), NullMemory.Instance, null, NullLogger.Instance);
+    }
+
+    private static void InterlockedMax(ref int location, int value)
+    {
+        int current = Volatile.Read(ref location);
+        while (current < value)
+        {
+            int previous = Interlocked.CompareExchange(ref location, value, current);
+            if (previous == current) { return; }
+
+            current = previous;
+        }
+    }
+
+    private sealed class FakeFunction : ISKFunction
+    {
+        private readonly Func<SKContext, Task<SKContext>> _function;
+
+        public FakeFunction(Func<SKContext, Task<SKContext>> function)
+        {
+            this._function = function;
+        }
+
+        public string Name => "fake";
+
+        public string SkillName => "test";
+
+        public string Description => string.Empty;
+
+        public bool IsSemantic => true;
+
+        public CompleteRequestSettings RequestSettings { get; } = new();
+
+        public FunctionView Describe()
+        {
+            return new FunctionView { Name = this.Name, SkillName = this.SkillName, IsSemantic = true };
+        }
+
+        public Task<SKContext> InvokeAsync(
+            string input, SKContext? context = null, CompleteRequestSettings? settings = null, ILogger? log = null, CancellationToken? cancel = null)
+        {
+            context ??= CreateContext();
+            context.Variables.Update(input);
+            return this.InvokeAsync(context, settings, log, cancel);
+        }
+
+        public Task<SKContext> InvokeAsync(
+            SKContext? context = null, CompleteRequestSettings? settings = null, ILogger? log = null, CancellationToken? cancel = null)
+        {
+            return this._function(context ?? CreateContext());
+        }
+
+        public ISKFunction SetDefaultSkillCollection(IReadOnlySkillCollection skills)
+        {
+            return this;
+        }
+
+        public ISKFunction SetAIBackend(Func<ITextCompletionClient> backendFactory)
+        {
+            return this;
+        }
+
+        public ISKFunction SetAIConfiguration(CompleteRequestSettings settings)
+        {
+            return this;
+        }
+    }
+}
@@ -0,0 +1,217 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
+using Xunit;
+
+namespace SemanticKernelTests.SemanticFunctions.Partitioning;
+
+/// <summary>
+/// Compare the span based partitioner with the string based implementation it replaced.
+/// </summary>
+public class SemanticTextPartitionerEquivalenceTests
+{
+    private static readonly string[] s_words =
+    {
+        "The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog.", "Is", "it", "true?", "Yes!",
+        "first;", "second:", "third,", "(note)", "[ref]", "{x}", "well-known", "a", "\n", "\r\n", "\n\n", "你好世界", "x==1",
+    };
+
+    private static IEnumerable<(string Text, int MaxTokens)> Cases()
+    {
+        var random = new Random(42);
+        foreach (int length in new[] { 0, 1, 5, 20, 80, 300 })
+        {
+            foreach (int maxTokens in new[] { 3, 10, 25, 100 })
+            {
+                var text = new StringBuilder();
+                for (int i = 0; i < length; i++)
+                {
+                    text.Append(s_words[random.Next(s_words.Length)]).Append(random.Next(4) == 0 ? string.Empty : " ");
+                }
+
+                yield return (text.ToString(), maxTokens);
+            }
+        }
+    }
+
+    [Fact]
+    public void ItSplitsLinesLikeThePreviousImplementation()
+    {
+        foreach ((string text, int maxTokens) in Cases())
+        {
+            // Act + Assert
+            Assert.Equal(LegacyPartitioner.SplitLines(text, maxTokens, true, false, LegacyPartitioner.Estimate),
+            SemanticTextPartitioner.SplitPlainTextLines(text, maxTokens));
+            Assert.Equal(LegacyPartitioner.SplitLines(text, maxTokens, true, true, LegacyPartitioner.Estimate),
+                SemanticTextPartitioner.SplitMarkDownLines(text, maxTokens));
+            Assert.Equal(LegacyPartitioner.SplitLines(text, maxTokens, true, false, HeuristicTokenizer.Instance.CountTokens),
+                SemanticTextPartitioner.SplitPlainTextLines(text, maxTokens, HeuristicTokenizer.Instance));
+        }
+    }
+
+    [Fact]
+    public void ItSplitsParagraphsLikeThePreviousImplementation()
+    {
+        foreach ((string text, int maxTokens) in Cases())
+        {
+            // Arrange
+            List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(text, maxTokens);
+            List<string> markdownLines = SemanticTextPartitioner.SplitMarkDownLines(text, maxTokens);
+
+            // Act + Assert
+            Assert.Equal(LegacyPartitioner.SplitParagraphs(lines, maxTokens * 3, false),
+                SemanticTextPartitioner.SplitPlainTextParagraphs(lines, maxTokens * 3));
+            Assert.Equal(LegacyPartitioner.SplitParagraphs(markdownLines, maxTokens * 3, true),
+                SemanticTextPartitioner.SplitMarkdownParagraphs(markdownLines, maxTokens * 3));
+        }
+    }
+
+    [Fact]
+    public void ItKeepsParagraphsWithinTheTokenizerBudget()
+    {
+        var tokenizer = HeuristicTokenizer.Instance;
+        foreach ((string text, int maxTokens) in Cases())
+        {
+            // Arrange
+            List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(text, maxTokens, tokenizer);
+
+            // Act
+            List<string> paragraphs = SemanticTextPartitioner.SplitPlainTextParagraphs(lines, maxTokens * 3, tokenizer);
+
+            // Assert - no text is lost, and paragraphs of multiple lines fit in the budget
+            Assert.Equal(Words(string.Join(" ", lines)), Words(string.Join(" ", paragraphs)));
+            foreach (string paragraph in paragraphs.Take(paragraphs.Count - 1).Where(x => x.Contains('\n', StringComparison.Ordinal)))
+            {
+                Assert.True(tokenizer.CountTokens(paragraph) <= maxTokens * 3, $"Paragraph too long: {paragraph}");
+            }
+        }
+    }
+
+    private static string[] Words(string text)
+    {
+        return text.Split(new[] { ' ', '\n', '\r' }, StringSplitOptions.RemoveEmptyEntries);
+    }
+
+    /// <summary>
+    /// The string based implementation replaced by the span based one, used as reference.
+    /// </summary>
+    private static class LegacyPartitioner
+    {
+        private static readonly char[]?[] s_plaintextSplitOptions =
+        {
+            new[] { '\n', '\r' }, new[] { '.' }, new[] { '?', '!' }, new[] { ';' }, new[] { ':' },
+            new[] { ',' }, new[] { ')', ']', '}' }, new[] { ' ' }, new[] { '-' }, null
+        };
+
+        private static readonly char[]?[] s_markdownSplitOptions =
+        {
+            new[] { '.' }, new[] { '?', '!' }, new[] { ';' }, new[] { ':' }, new[] { ',' },
+            new[] { ')', ']', '}' }, new[] { ' ' }, new[] { '-' }, new[] { '\n', '\r' }, null
+        };
+
+        public static int Estimate(string input) => input.Length / 4;
+
+        public static List<string> SplitLines(string text, int maxTokens, bool trim, bool markdown, Func<string, int> tokenCount)
+        {
+            text = text.Replace("\r\n", "\n", StringComparison.OrdinalIgnoreCase);
+
+            List<string>? result = null;
+            foreach (char[]? separators in markdown ? s_markdownSplitOptions : s_plaintextSplitOptions)
+            {
+                bool inputWasSplit = false;
+                var next = new List<string>();
+                foreach (string item in result ?? new List<string> { text })
+                {
+                    next.AddRange(Split(item, maxTokens, separators, trim, tokenCount, out bool split));
+                    inputWasSplit |= split;
+                }
+
+                result = next;
+                if (!inputWasSplit) { break; }
+            }
+
+            return result ?? new List<string>();
+        }
+
+        public static List<string> SplitParagraphs(List<string> lines, int maxTokens, bool markdown)
+        {
+            if (lines.Count == 0) { return new List<string>(); }
+
+            var truncatedLines = lines.SelectMany(x => SplitLines(x, maxTokens, false, markdown, Estimate)).ToList();
+
+            var paragraphs = new List<string>();
+            var currentParagraph = new StringBuilder();
+            foreach (var line in truncatedLines)
+            {
+                if (Estimate(currentParagraph.ToString()) + Estimate(line) + 1 >= maxTokens && currentParagraph.Length > 0)
+                {
+                    paragraphs.Add(currentParagraph.ToString().Trim());
+                    currentParagraph.Clear();
+                }
+
+                currentParagraph.AppendLine(line);
+            }
+
+            if (currentParagraph.Length > 0) { paragraphs.Add(currentParagraph.ToString().Trim()); }
+
+            if (paragraphs.Count > 1 && Estimate(paragraphs[^1]) < maxTokens / 4)
+            {
+                var last = paragraphs[^1].Split(' ', StringSplitOptions.RemoveEmptyEntries);
+                var secondLast = paragraphs[^2].Split(' ', StringSplitOptions.RemoveEmptyEntries);
+                if (last.Length + secondLast.Length <= maxTokens)
+                {
+                    paragraphs[^2] = string.Join(" ", secondLast.Concat(last));
+                    paragraphs.RemoveAt(paragraphs.Count - 1);
+                }
+            }
+
+            return paragraphs;
+        }
+
+        private static List<string> Split(string input, int maxTokens, char[]? separators, bool trim, Func<string, int> tokenCount, out bool inputWasSplit)
+        {
+            inputWasSplit = false;
+            var asIs = new List<string> { trim ? input.Trim() : input };
+            if (tokenCount(input) <= maxTokens) { return asIs; }
+
+            inputWasSplit = true;
+            int half = input.Length / 2;
+            int cutPoint = -1;
+            if (separators == null)
+            {
+                cutPoint = half;
+            }
+            else if (input.Any(separators.Contains) && input.Length > 2)
+            {
+                for (var index = 0; index < input.Length - 1; index++)
+                {
+                    if (separators.Contains(input[index]) && Math.Abs(half - index) < Math.Abs(half - cutPoint))
+                    {
+                        cutPoint = index + 1;
+                    }
+                }
+            }
+
+            if (cutPoint <= 0) { return asIs; }
+
+            var firstHalf = input[..cutPoint];
+            var secondHalf = input[cutPoint..];
+            if (trim)
+            {
+                firstHalf = firstHalf.Trim();
+                secondHalf = secondHalf.Trim();
+            }
+
+            var result = Split(firstHalf, maxTokens, separators, trim, tokenCount, out bool split1);
+            result.AddRange(Split(secondHalf, maxTokens, separators, trim, tokenCount, out bool split2));
+            inputWasSplit = split1 || split2;
+
+            return result;
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 using System;
 using System.Collections.Generic;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
 using SemanticKernelTests.XunitHelpers;
 using Xunit;
@@ -34,6 +35,23 @@ public sealed class SemanticTextPartitionerTests : IDisposable
         Assert.Equal(expected, result);
     }
 
+    [Fact]
+    public void CanSplitPlainTextLinesWithTokenizer()
+    {
+        // CJK text is about one token per char, 4x the length/4 estimate
+        const string input = "这是一个测试。这只是一个测试。";
+        var expected = new[]
+        {
+            "这是一个测试。",
+            "这只是一个测试。"
+        };
+
+        var result = SemanticTextPartitioner.SplitPlainTextLines(input, 10, HeuristicTokenizer.Instance);
+
+        Assert.Equal(expected, result);
+        Assert.Single(SemanticTextPartitioner.SplitPlainTextLines(input, 10));
+    }
+
     [Fact]
     public void CanSplitMarkdownParagraphs()
     {
@@ -0,0 +1,21 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+
+namespace SemanticKernelTests.TestHelpers;
+
+/// <summary>
+/// Completion client returning a different completion at every call, to tell cached completions apart.
+/// </summary>
+internal sealed class CountingCompletionClient : ITextCompletionClient
+{
+    public int Calls { get; private set; }
+
+    public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        this.Calls++;
+        return Task.FromResult($"completion {this.Calls} of {text}");
+    }
+}
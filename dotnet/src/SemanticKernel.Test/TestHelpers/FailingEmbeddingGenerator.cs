@@ -0,0 +1,20 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+
+namespace SemanticKernelTests.TestHelpers;
+
+/// <summary>
+/// Embedding generator failing every request, as an unavailable backend.
+/// </summary>
+internal sealed class FailingEmbeddingGenerator : IEmbeddingGenerator<string, float>
+{
+    public Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data, CancellationToken cancellationToken = default)
+    {
+        throw new InvalidOperationException("The embedding backend is not available");
+    }
+}
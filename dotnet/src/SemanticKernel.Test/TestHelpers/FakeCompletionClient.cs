@@ -0,0 +1,46 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI;
+
+namespace SemanticKernelTests.TestHelpers;
+
+/// <summary>
+/// Completion client returning a fixed completion, or a completion computed from the prompt, optionally failing.
+/// Safe to use from concurrent requests.
+/// </summary>
+internal sealed class FakeCompletionClient : ITextCompletionClient
+{
+    private readonly Func<string, CancellationToken, Task<string>> _complete;
+    private int _requestCount;
+
+    public FakeCompletionClient(string completion)
+        : this(_ => completion)
+    {
+    }
+
+    public FakeCompletionClient(Func<string, string> complete)
+        : this((text, _) => Task.FromResult(complete(text)))
+    {
+    }
+
+    public FakeCompletionClient(Func<string, CancellationToken, Task<string>> complete)
+    {
+        this._complete = complete;
+    }
+
+    public int RequestCount => this._requestCount;
+
+    public Exception? Error { get; set; }
+
+    public Action? OnRequest { get; set; }
+
+    public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        Interlocked.Increment(ref this._requestCount);
+        this.OnRequest?.Invoke();
+        return this.Error == null ? this._complete(text, cancellationToken) : Task.FromException<string>(this.Error);
+    }
+}
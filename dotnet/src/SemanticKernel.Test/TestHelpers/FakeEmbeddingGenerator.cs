@@ -0,0 +1,50 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+
+namespace SemanticKernelTests.TestHelpers;
+
+/// <summary>
+/// Embeds text counting a few known words, so that similarity depends only on those words.
+/// </summary>
+internal sealed class FakeEmbeddingGenerator : IEmbeddingGenerator<string, float>, IDisposable
+{
+    private static readonly string[] s_vocabulary = { "cat", "dog", "car" };
+    private static readonly char[] s_separators = { ' ', '\n', ':' };
+
+    /// <summary>
+    /// Number of calls to the generator.
+    /// </summary>
+    public int Calls { get; private set; }
+
+    /// <summary>
+    /// Texts embedded, in order.
+    /// </summary>
+    public List<string> Texts { get; } = new();
+
+    public bool IsDisposed { get; private set; }
+
+    public Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data, CancellationToken cancellationToken = default)
+    {
+        this.Calls++;
+        this.Texts.AddRange(data);
+        IList<Embedding<float>> result = data.Select(text =>
+        {
+            var words = text.ToUpperInvariant().Split(s_separators, StringSplitOptions.RemoveEmptyEntries);
+            var vector = s_vocabulary.Select(v => (float)words.Count(w => w == v.ToUpperInvariant())).Append(0.01f).ToArray();
+            return new Embedding<float>(vector);
+        }).ToList();
+
+        return Task.FromResult(result);
+    }
+
+    public void Dispose()
+    {
+        this.IsDisposed = true;
+    }
+}
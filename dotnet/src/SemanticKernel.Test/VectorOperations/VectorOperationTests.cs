@@ -24,9 +24,12 @@ public class VectorOperationTests
         var target = SupportedTypes.Types;
 
         // Assert
-        Assert.Equal(2, target.Count());
+        Assert.Equal(5, target.Count());
         Assert.Contains(typeof(float), target);
         Assert.Contains(typeof(double), target);
+        Assert.Contains(typeof(Float16), target);
+        Assert.Contains(typeof(BFloat16), target);
+        Assert.Contains(typeof(Half), target);
     }
 
     [Fact]
@@ -262,4 +265,65 @@ public class VectorOperationTests
         Assert.True(target[2] > target[3]);
         Assert.Equal(-1.0, target[3]); // opposing vectors results in similarity of -1
     }
+
+    [Fact]
+    public void ItComputesCosineSimilarityHalfPrecision()
+    {
+        // Arrange: the length is not a multiple of the SIMD vector size
+        var random = new Random(7);
+        float[] x = Enumerable.Range(0, 67).Select(_ => (float)(random.NextDouble() - 0.5)).ToArray();
+        float[] y = Enumerable.Range(0, 67).Select(_ => (float)(random.NextDouble() - 0.5)).ToArray();
+        double expected = x.CosineSimilarity(y);
+
+        // Act
+        double float16 = x.Select(v => (Float16)v).ToArray().CosineSimilarity(y.Select(v => (Float16)v).ToArray());
+        double bfloat16 = x.Select(v => (BFloat16)v).ToArray().CosineSimilarity(y.Select(v => (BFloat16)v).ToArray());
+        double systemHalf = x.Select(v => (Half)v).ToArray().CosineSimilarity(y.Select(v => (Half)v).ToArray());
+
+        // Assert
+        Assert.Equal(expected, float16, 3);
+        Assert.Equal(expected, bfloat16, 2);
+        Assert.Equal(float16, systemHalf, 6);
+    }
+
+    [Fact]
+    public void ItComputesDotProductHalfPrecision()
+    {
+        // Arrange
+        var x = this._floatV1.Select(v => (Float16)v).ToArray();
+        var y = this._floatV2.Select(v => (BFloat16)v).ToArray();
+
+        // Act
+        double float16 = x.DotProduct(x);
+        double bfloat16 = y.DotProduct(y);
+
+        // Assert
+        Assert.Equal(121, float16);
+        Assert.Equal(95, bfloat16);
+    }
+
+    [Fact]
+    public void ItNormalizesInPlaceHalfPrecision()
+    {
+        // Arrange
+        var target = new[] { (Float16)3.0F, (Float16)(-4.0F) };
+
+        // Act
+        target.NormalizeInPlace();
+
+        // Assert
+        Assert.Equal(0.6, (float)target[0], 3);
+        Assert.Equal(-0.8, (float)target[1], 3);
+    }
+
+    [Fact]
+    public void ItThrowsOnCosineSimilarityWithDifferentLengthVectorsHalfPrecision()
+    {
+        // Arrange
+        var x = new[] { (BFloat16)1.0F, (BFloat16)2.0F };
+        var y = new[] { (BFloat16)1.0F };
+
+        // Assert
+        Assert.Throws<ArgumentException>(() => x.CosineSimilarity(y));
+    }
 }
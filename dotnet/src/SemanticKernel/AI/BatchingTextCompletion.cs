@@ -0,0 +1,256 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Caching;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI;
+
+/// <summary>
+/// Text completion client coalescing concurrent requests with the same settings into batch requests.
+/// The first request of a batch waits up to <see cref="MaxDelay"/> for other requests, and the batch
+/// is sent as soon as it contains <see cref="MaxBatchSize"/> prompts.
+/// Cancelled requests are removed from their batch if the batch has not been sent yet.
+/// Prompts are validated before joining a batch, and a batch rejected as invalid is sent again one prompt
+/// per request, so that a bad prompt fails only its own caller.
+/// </summary>
+public sealed class BatchingTextCompletion : ITextCompletionClient, IDisposable
+{
+    /// <summary>
+    /// Default max number of prompts sent with a single request.
+    /// </summary>
+    public const int DefaultMaxBatchSize = 16;
+
+    /// <summary>
+    /// Default max time a request waits for other requests to batch with.
+    /// </summary>
+    public static readonly TimeSpan DefaultMaxDelay = TimeSpan.FromMilliseconds(20);
+
+    /// <summary>
+    /// Create a new instance.
+    /// </summary>
+    /// <param name="client">Client used to send the batch requests</param>
+    /// <param name="maxBatchSize">Max number of prompts sent with a single request</param>
+    /// <param name="maxDelay">Max time a request waits for other requests to batch with</param>
+    /// <param name="tokenizer">Tokenizer used to check that the prompts fit in the model context window</param>
+    /// <param name="modelId">Model name, e.g. "text-davinci-003", used to get the context window size</param>
+    public BatchingTextCompletion(
+        ITextBatchCompletionClient client,
+        int maxBatchSize = DefaultMaxBatchSize,
+        TimeSpan? maxDelay = null,
+        ITokenizer? tokenizer = null,
+        string modelId = "")
+    {
+        Verify.NotNull(client, "The completion client cannot be NULL");
+        if (maxBatchSize < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxBatchSize), "The batch size must be greater than zero");
+        }
+
+        this._client = client;
+        this.MaxBatchSize = maxBatchSize;
+        this.MaxDelay = maxDelay ?? DefaultMaxDelay;
+        this._tokenizer = tokenizer;
+        this._modelId = modelId;
+    }
+
+    /// <summary>
+    /// Max number of prompts sent with a single request.
+    /// </summary>
+    public int MaxBatchSize { get; }
+
+    /// <summary>
+    /// Max time a request waits for other requests to batch with.
+    /// </summary>
+    public TimeSpan MaxDelay { get; }
+
+    /// <inheritdoc/>
+    public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        Verify.NotNull(requestSettings, "Completion settings cannot be empty");
+        cancellationToken.ThrowIfCancellationRequested();
+        this._tokenizer?.ValidateCompletionRequest(text, requestSettings, this._modelId);
+
+        string key = CompletionCache.CreateKey(string.Empty, string.Empty, string.Empty, requestSettings);
+        var request = new PendingRequest(text);
+
+        Batch? fullBatch = null;
+        lock (this._pendingBatches)
+        {
+            if (this._disposed) { throw new ObjectDisposedException(nameof(BatchingTextCompletion)); }
+
+            if (!this._pendingBatches.TryGetValue(key, out Batch? batch))
+            {
+                batch = new Batch(requestSettings);
+                this._pendingBatches[key] = batch;
+                _ = this.SendAfterDelayAsync(key, batch);
+            }
+
+            batch.Requests.Add(request);
+            if (batch.Requests.Count >= this.MaxBatchSize)
+            {
+                this._pendingBatches.Remove(key);
+                fullBatch = batch;
+            }
+        }
+
+        if (fullBatch != null)
+        {
+            _ = this.SendAsync(fullBatch);
+        }
+
+        return cancellationToken.CanBeCanceled
+            ? this.WaitAsync(key, request, cancellationToken)
+            : request.Completion.Task;
+    }
+
+    /// <summary>
+    /// Fail the pending requests and dispose the inner client.
+    /// </summary>
+    public void Dispose()
+    {
+        List<Batch> pending;
+        lock (this._pendingBatches)
+        {
+            if (this._disposed) { return; }
+
+            this._disposed = true;
+            pending = this._pendingBatches.Values.ToList();
+            this._pendingBatches.Clear();
+        }
+
+        foreach (PendingRequest request in pending.SelectMany(x => x.Requests))
+        {
+            request.Completion.TrySetException(new ObjectDisposedException(nameof(BatchingTextCompletion)));
+        }
+
+        if (this._client is IDisposable disposable) { disposable.Dispose(); }
+    }
+
+    #region private ================================================================================
+
+    private readonly ITextBatchCompletionClient _client;
+    private readonly ITokenizer? _tokenizer;
+    private readonly string _modelId;
+
+    // Settings key => batch waiting to be sent
+    private readonly Dictionary<string, Batch> _pendingBatches = new(StringComparer.Ordinal);
+
+    private bool _disposed;
+
+    private sealed class PendingRequest
+    {
+        internal PendingRequest(string text)
+        {
+            this.Text = text;
+        }
+
+        internal string Text { get; }
+
+        internal TaskCompletionSource<string> Completion { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+    }
+
+    private sealed class Batch
+    {
+        internal Batch(CompleteRequestSettings requestSettings)
+        {
+            this.RequestSettings = requestSettings;
+        }
+
+        internal CompleteRequestSettings RequestSettings { get; }
+
+        internal List<PendingRequest> Requests { get; } = new();
+    }
+
+    private async Task<string> WaitAsync(string key, PendingRequest request, CancellationToken cancellationToken)
+    {
+        using (cancellationToken.Register(() => this.Cancel(key, request, cancellationToken)))
+        {
+            return await request.Completion.Task;
+        }
+    }
+
+    private void Cancel(string key, PendingRequest request, CancellationToken cancellationToken)
+    {
+        lock (this._pendingBatches)
+        {
+            // Once the batch is sent the prompt is part of the request, the caller just stops waiting
+            if (this._pendingBatches.TryGetValue(key, out Batch? batch) && batch.Requests.Remove(request) && batch.Requests.Count == 0)
+            {
+                this._pendingBatches.Remove(key);
+            }
+        }
+
+        request.Completion.TrySetCanceled(cancellationToken);
+    }
+
+    private async Task SendAfterDelayAsync(string key, Batch batch)
+    {
+        await Task.Delay(this.MaxDelay);
+
+        lock (this._pendingBatches)
+        {
+            // The batch might have been sent already because full, or failed because the client was disposed
+            if (!this._pendingBatches.TryGetValue(key, out Batch? pending) || pending != batch) { return; }
+
+            this._pendingBatches.Remove(key);
+        }
+
+        await this.SendAsync(batch);
+    }
+
+    private async Task SendAsync(Batch batch)
+    {
+        if (batch.Requests.Count == 1)
+        {
+            await this.SendAsync(batch.Requests[0], batch.RequestSettings);
+            return;
+        }
+
+        try
+        {
+            IList<string> completions = await this._client.CompleteBatchAsync(
+                batch.Requests.Select(x => x.Text).ToList(), batch.RequestSettings);
+
+            for (int i = 0; i < batch.Requests.Count; i++)
+            {
+                batch.Requests[i].Completion.TrySetResult(completions[i]);
+            }
+        }
+        catch (AIException e) when (e.ErrorCode == AIException.ErrorCodes.InvalidRequest && batch.Requests.Count > 1)
+        {
+            // The service rejects the whole batch when one prompt is not valid
+            await Task.WhenAll(batch.Requests.Select(x => this.SendAsync(x, batch.RequestSettings)));
+        }
+#pragma warning disable CA1031 // The exception is returned to the callers
+        catch (Exception e)
+        {
+            foreach (PendingRequest request in batch.Requests)
+            {
+                request.Completion.TrySetException(e);
+            }
+        }
+#pragma warning restore CA1031
+    }
+
+    private async Task SendAsync(PendingRequest request, CompleteRequestSettings requestSettings)
+    {
+        try
+        {
+            request.Completion.TrySetResult(await this._client.CompleteAsync(request.Text, requestSettings));
+        }
+#pragma warning disable CA1031 // The exception is returned to the caller
+        catch (Exception e)
+        {
+            request.Completion.TrySetException(e);
+        }
+#pragma warning restore CA1031
+    }
+
+    #endregion
+}
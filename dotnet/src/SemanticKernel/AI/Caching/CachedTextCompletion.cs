@@ -0,0 +1,68 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Text completion client returning cached completions for prompts already completed,
+/// and sending the other requests to the inner client.
+/// </summary>
+public sealed class CachedTextCompletion : ITextCompletionClient, IDisposable
+{
+    /// <summary>
+    /// Create a new instance.
+    /// </summary>
+    /// <param name="client">Client used when a completion is not in the cache</param>
+    /// <param name="cache">Completion cache, shared by all the clients</param>
+    /// <param name="backendLabel">Label of the backend, part of the cache key</param>
+    /// <param name="modelId">Model or deployment used by the client, part of the cache key</param>
+    public CachedTextCompletion(ITextCompletionClient client, CompletionCache cache, string backendLabel, string modelId)
+    {
+        Verify.NotNull(client, "The completion client cannot be NULL");
+        Verify.NotNull(cache, "The completion cache cannot be NULL");
+
+        this._client = client;
+        this._cache = cache;
+        this._backendLabel = backendLabel;
+        this._modelId = modelId;
+    }
+
+    /// <inheritdoc/>
+    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        if (!this._cache.IsCacheable(requestSettings))
+        {
+            return await this._client.CompleteAsync(text, requestSettings, cancellationToken);
+        }
+
+        string key = CompletionCache.CreateKey(this._backendLabel, this._modelId, text, requestSettings);
+        string? completion = await this._cache.TryGetAsync(key, cancellationToken);
+        if (completion != null) { return completion; }
+
+        completion = await this._client.CompleteAsync(text, requestSettings, cancellationToken);
+        await this._cache.SetAsync(key, completion, cancellationToken);
+
+        return completion;
+    }
+
+    /// <summary>
+    /// Dispose the inner client.
+    /// </summary>
+    public void Dispose()
+    {
+        if (this._client is IDisposable disposable) { disposable.Dispose(); }
+    }
+
+    #region private ================================================================================
+
+    private readonly ITextCompletionClient _client;
+    private readonly CompletionCache _cache;
+    private readonly string _backendLabel;
+    private readonly string _modelId;
+
+    #endregion
+}
@@ -0,0 +1,379 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Security.Cryptography;
+using System.Text;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Cache of text completions, keyed by backend, model, prompt and request settings.
+/// Completions are kept in memory, evicting the least recently used when the size limit is reached,
+/// and optionally persisted in a directory. The cache is safe to use from multiple threads, and
+/// the same instance can be shared by multiple clients.
+/// </summary>
+public sealed class CompletionCache
+{
+    /// <summary>
+    /// Create a new cache.
+    /// </summary>
+    /// <param name="options">Cache settings, by default completions are kept only in memory and never expire</param>
+    public CompletionCache(CompletionCacheOptions? options = null) : this(options, null)
+    {
+    }
+
+    /// <summary>
+    /// Cache settings.
+    /// </summary>
+    public CompletionCacheOptions Options { get; }
+
+    /// <summary>
+    /// Whether the completion of a request can be cached.
+    /// </summary>
+    /// <param name="requestSettings">Request settings</param>
+    /// <returns>True if the completion can be cached</returns>
+    public bool IsCacheable(CompleteRequestSettings requestSettings)
+    {
+        return IsCacheable(requestSettings, this.Options.CacheNonDeterministicRequests);
+    }
+
+    /// <summary>
+    /// Compute the cache key of a request.
+    /// </summary>
+    /// <param name="backendLabel">Label of the backend</param>
+    /// <param name="modelId">Model or deployment used by the backend</param>
+    /// <param name="prompt">Rendered prompt</param>
+    /// <param name="requestSettings">Request settings</param>
+    /// <returns>Cache key</returns>
+    public static string CreateKey(string backendLabel, string modelId, string prompt, CompleteRequestSettings requestSettings)
+    {
+        Verify.NotNull(prompt, "The prompt cannot be NULL");
+        Verify.NotNull(requestSettings, "The request settings cannot be NULL");
+
+        byte[] json = JsonSerializer.SerializeToUtf8Bytes(new CacheKey
+        {
+            Backend = backendLabel,
+            Model = modelId,
+            Temperature = requestSettings.Temperature,
+            TopP = requestSettings.TopP,
+            PresencePenalty = requestSettings.PresencePenalty,
+            FrequencyPenalty = requestSettings.FrequencyPenalty,
+            MaxTokens = requestSettings.MaxTokens,
+            StopSequences = requestSettings.StopSequences,
+            Prompt = prompt
+        });
+
+        using var sha256 = SHA256.Create();
+        byte[] hash = sha256.ComputeHash(json);
+
+        var key = new StringBuilder(hash.Length * 2);
+        foreach (byte b in hash) { key.Append(b.ToString("x2", System.Globalization.CultureInfo.InvariantCulture)); }
+
+        return key.ToString();
+    }
+
+    /// <summary>
+    /// Get a completion from the cache.
+    /// </summary>
+    /// <param name="key">Cache key, see <see cref="CreateKey"/></param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>The completion, or NULL if the completion is not in the cache or is expired</returns>
+    public async Task<string?> TryGetAsync(string key, CancellationToken cancel = default)
+    {
+        Verify.NotEmpty(key, "The cache key is empty");
+
+        DateTimeOffset now = this._clock();
+        lock (this._lock)
+        {
+            if (this._entries.TryGetValue(key, out LinkedListNode<Entry>? node))
+            {
+                if (!node.Value.IsExpired(now))
+                {
+                    // Move to the front, i.e. most recently used
+                    this._lru.Remove(node);
+                    this._lru.AddFirst(node);
+                    this._memoryHits++;
+                    return node.Value.Value;
+                }
+
+                this.RemoveNode(node);
+            }
+        }
+
+        Entry? stored = await this.ReadFileAsync(key, now, cancel);
+        if (stored != null)
+        {
+            lock (this._lock)
+            {
+                this._storageHits++;
+                this.AddInternal(stored);
+            }
+
+            return stored.Value;
+        }
+
+        Interlocked.Increment(ref this._misses);
+        return null;
+    }
+
+    /// <summary>
+    /// Store a completion in the cache.
+    /// </summary>
+    /// <param name="key">Cache key, see <see cref="CreateKey"/></param>
+    /// <param name="completion">Completion to cache</param>
+    /// <param name="cancel">Cancellation token</param>
+    public async Task SetAsync(string key, string completion, CancellationToken cancel = default)
+    {
+        Verify.NotEmpty(key, "The cache key is empty");
+        Verify.NotNull(completion, "The completion cannot be NULL");
+
+        DateTimeOffset? expiration = this.Options.TimeToLive.HasValue ? this._clock() + this.Options.TimeToLive.Value : null;
+        var entry = new Entry(key, completion, expiration);
+
+        lock (this._lock)
+        {
+            this.AddInternal(entry);
+        }
+
+        await this.WriteFileAsync(entry, cancel);
+    }
+
+    /// <summary>
+    /// Remove all the completions kept in memory. Persisted completions are not deleted.
+    /// </summary>
+    public void Clear()
+    {
+        lock (this._lock)
+        {
+            this._entries.Clear();
+            this._lru.Clear();
+            this._size = 0;
+        }
+    }
+
+    /// <summary>
+    /// Get the cache usage statistics.
+    /// </summary>
+    /// <returns>Snapshot of the current statistics</returns>
+    public CompletionCacheStats GetStats()
+    {
+        lock (this._lock)
+        {
+            return new CompletionCacheStats
+            {
+                MemoryHits = this._memoryHits,
+                StorageHits = this._storageHits,
+                Misses = Interlocked.Read(ref this._misses),
+                Evictions = this._evictions,
+                Count = this._entries.Count,
+                Size = this._size,
+            };
+        }
+    }
+
+    #region internals ==============================================================================
+
+    /// <summary>
+    /// Whether the completion of a request can be cached: requests with a temperature above zero return
+    /// a different completion every time, and are cached only if explicitly allowed.
+    /// </summary>
+    internal static bool IsCacheable(CompleteRequestSettings requestSettings, bool cacheNonDeterministicRequests)
+    {
+        Verify.NotNull(requestSettings, "The request settings cannot be NULL");
+        return cacheNonDeterministicRequests || requestSettings.Temperature <= 0;
+    }
+
+    /// <summary>
+    /// Constructor allowing to replace the clock, used to test expirations.
+    /// </summary>
+    internal CompletionCache(CompletionCacheOptions? options, Func<DateTimeOffset>? clock)
+    {
+        this.Options = options ?? new CompletionCacheOptions();
+        if (this.Options.MaxMemorySize < 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(options), "The max memory size cannot be negative");
+        }
+
+        this._clock = clock ?? (() => DateTimeOffset.UtcNow);
+
+        if (!string.IsNullOrEmpty(this.Options.Directory))
+        {
+            System.IO.Directory.CreateDirectory(this.Options.Directory);
+        }
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    // Approximate memory used by an entry, in addition to keys and values
+    private const int EntryOverhead = 128;
+
+    private readonly object _lock = new();
+    private readonly Func<DateTimeOffset> _clock;
+
+    // Most recently used entries first
+    private readonly LinkedList<Entry> _lru = new();
+    private readonly Dictionary<string, LinkedListNode<Entry>> _entries = new(StringComparer.Ordinal);
+
+    private long _size;
+    private long _memoryHits;
+    private long _storageHits;
+    private long _misses;
+    private long _evictions;
+
+    private sealed class Entry
+    {
+        internal Entry(string key, string value, DateTimeOffset? expiration)
+        {
+            this.Key = key;
+            this.Value = value;
+            this.Expiration = expiration;
+            this.Size = EntryOverhead + (2L * (key.Length + value.Length));
+        }
+
+        internal string Key { get; }
+        internal string Value { get; }
+        internal DateTimeOffset? Expiration { get; }
+        internal long Size { get; }
+
+        internal bool IsExpired(DateTimeOffset now)
+        {
+            return this.Expiration.HasValue && this.Expiration.Value <= now;
+        }
+    }
+
+    private sealed class CacheKey
+    {
+        [JsonPropertyName("backend")]
+        public string Backend { get; set; } = string.Empty;
+
+        [JsonPropertyName("model")]
+        public string Model { get; set; } = string.Empty;
+
+        [JsonPropertyName("temperature")]
+        public double Temperature { get; set; }
+
+        [JsonPropertyName("top_p")]
+        public double TopP { get; set; }
+
+        [JsonPropertyName("presence_penalty")]
+        public double PresencePenalty { get; set; }
+
+        [JsonPropertyName("frequency_penalty")]
+        public double FrequencyPenalty { get; set; }
+
+        [JsonPropertyName("max_tokens")]
+        public int MaxTokens { get; set; }
+
+        [JsonPropertyName("stop")]
+        public IList<string> StopSequences { get; set; } = Array.Empty<string>();
+
+        [JsonPropertyName("prompt")]
+        public string Prompt { get; set; } = string.Empty;
+    }
+
+    private sealed class StoredCompletion
+    {
+        [JsonPropertyName("value")]
+        public string Value { get; set; } = string.Empty;
+
+        [JsonPropertyName("expiration")]
+        public DateTimeOffset? Expiration { get; set; }
+    }
+
+    private void AddInternal(Entry entry)
+    {
+        if (this._entries.TryGetValue(entry.Key, out LinkedListNode<Entry>? existing))
+        {
+            this.RemoveNode(existing);
+        }
+
+        // Entries larger than the whole cache are not kept in memory
+        if (entry.Size > this.Options.MaxMemorySize) { return; }
+
+        this._entries[entry.Key] = this._lru.AddFirst(entry);
+        this._size += entry.Size;
+
+        while (this._size > this.Options.MaxMemorySize && this._lru.Last != null)
+        {
+            this.RemoveNode(this._lru.Last);
+            this._evictions++;
+        }
+    }
+
+    private void RemoveNode(LinkedListNode<Entry> node)
+    {
+        this._lru.Remove(node);
+        this._entries.Remove(node.Value.Key);
+        this._size -= node.Value.Size;
+    }
+
+    private string? GetFilePath(string key)
+    {
+        return string.IsNullOrEmpty(this.Options.Directory) ? null : Path.Combine(this.Options.Directory, key + ".json");
+    }
+
+    private async Task<Entry?> ReadFileAsync(string key, DateTimeOffset now, CancellationToken cancel)
+    {
+        string? path = this.GetFilePath(key);
+        if (path == null || !File.Exists(path)) { return null; }
+
+        try
+        {
+            StoredCompletion? stored;
+            using (var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read | FileShare.Delete, 4096, useAsync: true))
+            {
+                stored = await JsonSerializer.DeserializeAsync<StoredCompletion>(stream, cancellationToken: cancel);
+            }
+
+            if (stored == null) { return null; }
+
+            var entry = new Entry(key, stored.Value, stored.Expiration);
+            if (!entry.IsExpired(now)) { return entry; }
+
+            File.Delete(path);
+        }
+        catch (Exception e) when (e is IOException or UnauthorizedAccessException or JsonException)
+        {
+            // The persistent storage is best effort, e.g. the file might be deleted or being written by another process
+        }
+
+        return null;
+    }
+
+    private async Task WriteFileAsync(Entry entry, CancellationToken cancel)
+    {
+        string? path = this.GetFilePath(entry.Key);
+        if (path == null) { return; }
+
+        // Write to a temporary file and rename it, so that other readers never see a partial file
+        string tempPath = $"{path}.{Guid.NewGuid():N}.tmp";
+        try
+        {
+            using (var stream = new FileStream(tempPath, FileMode.CreateNew, FileAccess.Write, FileShare.None, 4096, useAsync: true))
+            {
+                await JsonSerializer.SerializeAsync(stream, new StoredCompletion { Value = entry.Value, Expiration = entry.Expiration }, cancellationToken: cancel);
+            }
+
+            if (File.Exists(path)) { File.Delete(path); }
+
+            File.Move(tempPath, path);
+        }
+        catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+        {
+            // The persistent storage is best effort, e.g. another process might have stored the same completion
+            try { File.Delete(tempPath); }
+            catch (Exception e2) when (e2 is IOException or UnauthorizedAccessException) { }
+        }
+    }
+
+    #endregion
+}
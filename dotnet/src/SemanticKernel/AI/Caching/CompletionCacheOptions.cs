@@ -0,0 +1,34 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Settings of the completion cache.
+/// </summary>
+public class CompletionCacheOptions
+{
+    /// <summary>
+    /// Max size in bytes of the completions kept in memory, estimated from the length of keys and values.
+    /// The least recently used completions are evicted when the size is exceeded.
+    /// </summary>
+    public long MaxMemorySize { get; set; } = 64 * 1024 * 1024;
+
+    /// <summary>
+    /// How long completions are cached. Null means completions don't expire.
+    /// </summary>
+    public TimeSpan? TimeToLive { get; set; } = null;
+
+    /// <summary>
+    /// Optional directory where completions are persisted, to share them across processes and restarts.
+    /// </summary>
+    public string? Directory { get; set; } = null;
+
+    /// <summary>
+    /// Whether to cache completions of requests with a temperature above zero.
+    /// By default only deterministic requests are cached, to avoid returning always the same result
+    /// when the caller expects some variety.
+    /// </summary>
+    public bool CacheNonDeterministicRequests { get; set; } = false;
+}
@@ -0,0 +1,56 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Snapshot of the completion cache usage.
+/// </summary>
+public sealed class CompletionCacheStats
+{
+    /// <summary>
+    /// Number of completions found in memory.
+    /// </summary>
+    public long MemoryHits { get; internal set; }
+
+    /// <summary>
+    /// Number of completions found in the persistent storage.
+    /// </summary>
+    public long StorageHits { get; internal set; }
+
+    /// <summary>
+    /// Number of completions not found, or expired.
+    /// </summary>
+    public long Misses { get; internal set; }
+
+    /// <summary>
+    /// Number of completions removed from memory to stay within the size limit.
+    /// </summary>
+    public long Evictions { get; internal set; }
+
+    /// <summary>
+    /// Number of completions in memory.
+    /// </summary>
+    public int Count { get; internal set; }
+
+    /// <summary>
+    /// Estimated size in bytes of the completions in memory.
+    /// </summary>
+    public long Size { get; internal set; }
+
+    /// <summary>
+    /// Total number of completions found.
+    /// </summary>
+    public long Hits => this.MemoryHits + this.StorageHits;
+
+    /// <summary>
+    /// Ratio of lookups returning a completion, between 0 and 1.
+    /// </summary>
+    public double HitRate
+    {
+        get
+        {
+            long lookups = this.Hits + this.Misses;
+            return lookups == 0 ? 0 : (double)this.Hits / lookups;
+        }
+    }
+}
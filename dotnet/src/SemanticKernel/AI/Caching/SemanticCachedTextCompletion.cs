@@ -0,0 +1,92 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Text completion client returning the cached completion of a similar prompt when available,
+/// and sending the other requests to the inner client. The cache is best effort: failures to embed the
+/// prompt or to access the cache storage are handled as cache misses.
+/// </summary>
+public sealed class SemanticCachedTextCompletion : ITextCompletionClient, IDisposable
+{
+    /// <summary>
+    /// Create a new instance.
+    /// </summary>
+    /// <param name="client">Client used when no similar prompts are in the cache</param>
+    /// <param name="cache">Semantic completion cache, shared by all the clients</param>
+    /// <param name="backendLabel">Label of the backend, completions are reused only within the same backend</param>
+    /// <param name="modelId">Model or deployment used by the client, completions are reused only within the same model</param>
+    public SemanticCachedTextCompletion(ITextCompletionClient client, SemanticCompletionCache cache, string backendLabel, string modelId)
+    {
+        Verify.NotNull(client, "The completion client cannot be NULL");
+        Verify.NotNull(cache, "The completion cache cannot be NULL");
+
+        this._client = client;
+        this._cache = cache;
+        this._backendLabel = backendLabel;
+        this._modelId = modelId;
+    }
+
+    /// <inheritdoc/>
+    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        if (!this._cache.IsCacheable(requestSettings))
+        {
+            return await this._client.CompleteAsync(text, requestSettings, cancellationToken);
+        }
+
+        // The embedding is generated once, and reused to store the completion
+        string collection = SemanticCompletionCache.GetCollectionName(this._backendLabel, this._modelId, requestSettings);
+        Embedding<float>? embedding = null;
+        string? completion = null;
+        try
+        {
+            embedding = await this._cache.GenerateEmbeddingAsync(text, cancellationToken);
+            completion = await this._cache.TryGetAsync(collection, embedding.Value, cancellationToken);
+        }
+        catch (Exception e) when (!e.IsCriticalException() && !cancellationToken.IsCancellationRequested)
+        {
+            // Cache miss
+        }
+
+        if (completion != null) { return completion; }
+
+        completion = await this._client.CompleteAsync(text, requestSettings, cancellationToken);
+        if (embedding.HasValue)
+        {
+            try
+            {
+                await this._cache.SetAsync(collection, text, embedding.Value, completion);
+            }
+            catch (Exception e) when (!e.IsCriticalException())
+            {
+                // The completion is returned even if it cannot be cached
+            }
+        }
+
+        return completion;
+    }
+
+    /// <summary>
+    /// Dispose the inner client.
+    /// </summary>
+    public void Dispose()
+    {
+        if (this._client is IDisposable disposable) { disposable.Dispose(); }
+    }
+
+    #region private ================================================================================
+
+    private readonly ITextCompletionClient _client;
+    private readonly SemanticCompletionCache _cache;
+    private readonly string _backendLabel;
+    private readonly string _modelId;
+
+    #endregion
+}
@@ -0,0 +1,301 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Memory;
+using Microsoft.SemanticKernel.Memory.Storage;
+
+namespace Microsoft.SemanticKernel.AI.Caching;
+
+/// <summary>
+/// Cache of text completions returning the completion of the most similar prompt already completed,
+/// when the similarity of the prompts embeddings is above a threshold. Prompts are grouped by backend,
+/// model and request settings, so that only completions of equivalent requests are reused.
+/// The cache keeps up to <see cref="MaxEntries"/> completions, evicting the least recently used,
+/// and optionally expires completions after a time to live.
+/// </summary>
+public sealed class SemanticCompletionCache
+{
+    /// <summary>
+    /// Default min cosine similarity of prompts sharing a completion.
+    /// </summary>
+    public const double DefaultMinSimilarity = 0.95;
+
+    /// <summary>
+    /// Default max number of completions stored.
+    /// </summary>
+    public const int DefaultMaxEntries = 1000;
+
+    /// <summary>
+    /// Create a new cache.
+    /// </summary>
+    /// <param name="embeddingGenerator">Generator used to embed prompts</param>
+    /// <param name="storage">Storage of the prompts embeddings and completions, by default an in-memory store</param>
+    /// <param name="minSimilarity">Min cosine similarity of two prompts to reuse a completion</param>
+    /// <param name="cacheNonDeterministicRequests">Whether to cache completions of requests with a temperature above zero</param>
+    /// <param name="maxEntries">Max number of completions stored, the least recently used are removed first</param>
+    /// <param name="timeToLive">How long completions are reused, by default completions never expire</param>
+    public SemanticCompletionCache(
+        IEmbeddingGenerator<string, float> embeddingGenerator,
+        IMemoryStore<float>? storage = null,
+        double minSimilarity = DefaultMinSimilarity,
+        bool cacheNonDeterministicRequests = false,
+        int maxEntries = DefaultMaxEntries,
+        TimeSpan? timeToLive = null)
+        : this(embeddingGenerator, storage, minSimilarity, cacheNonDeterministicRequests, maxEntries, timeToLive, null)
+    {
+    }
+
+    /// <summary>
+    /// Min cosine similarity of two prompts to reuse a completion.
+    /// </summary>
+    public double MinSimilarity { get; }
+
+    /// <summary>
+    /// Max number of completions stored.
+    /// </summary>
+    public int MaxEntries { get; }
+
+    /// <summary>
+    /// How long completions are reused, NULL if completions never expire.
+    /// </summary>
+    public TimeSpan? TimeToLive { get; }
+
+    /// <summary>
+    /// Number of completions stored.
+    /// </summary>
+    public int Count
+    {
+        get
+        {
+            lock (this._lock) { return this._entries.Count; }
+        }
+    }
+
+    /// <summary>
+    /// Number of lookups returning a completion.
+    /// </summary>
+    public long Hits => Interlocked.Read(ref this._hits);
+
+    /// <summary>
+    /// Number of lookups not finding a completion.
+    /// </summary>
+    public long Misses => Interlocked.Read(ref this._misses);
+
+    /// <summary>
+    /// Whether the completion of a request can be cached.
+    /// </summary>
+    /// <param name="requestSettings">Request settings</param>
+    /// <returns>True if the completion can be cached</returns>
+    public bool IsCacheable(CompleteRequestSettings requestSettings)
+    {
+        return CompletionCache.IsCacheable(requestSettings, this._cacheNonDeterministicRequests);
+    }
+
+    /// <summary>
+    /// Get the completion of the most similar prompt.
+    /// </summary>
+    /// <param name="backendLabel">Label of the backend</param>
+    /// <param name="modelId">Model or deployment used by the backend</param>
+    /// <param name="prompt">Rendered prompt</param>
+    /// <param name="requestSettings">Request settings</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>The completion, or NULL if there are no similar prompts</returns>
+    public async Task<string?> TryGetAsync(
+        string backendLabel, string modelId, string prompt, CompleteRequestSettings requestSettings, CancellationToken cancel = default)
+    {
+        Embedding<float> embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(prompt, cancel);
+        return await this.TryGetAsync(GetCollectionName(backendLabel, modelId, requestSettings), embedding, cancel);
+    }
+
+    /// <summary>
+    /// Store the completion of a prompt.
+    /// </summary>
+    /// <param name="backendLabel">Label of the backend</param>
+    /// <param name="modelId">Model or deployment used by the backend</param>
+    /// <param name="prompt">Rendered prompt</param>
+    /// <param name="requestSettings">Request settings</param>
+    /// <param name="completion">Completion to cache</param>
+    /// <param name="cancel">Cancellation token</param>
+    public async Task SetAsync(
+        string backendLabel, string modelId, string prompt, CompleteRequestSettings requestSettings, string completion, CancellationToken cancel = default)
+    {
+        Embedding<float> embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(prompt, cancel);
+        await this.SetAsync(GetCollectionName(backendLabel, modelId, requestSettings), prompt, embedding, completion, cancel);
+    }
+
+    #region internals ==============================================================================
+
+    /// <summary>
+    /// Constructor allowing to replace the clock, used to test expirations.
+    /// </summary>
+    internal SemanticCompletionCache(
+        IEmbeddingGenerator<string, float> embeddingGenerator,
+        IMemoryStore<float>? storage,
+        double minSimilarity,
+        bool cacheNonDeterministicRequests,
+        int maxEntries,
+        TimeSpan? timeToLive,
+        Func<DateTimeOffset>? clock)
+    {
+        Verify.NotNull(embeddingGenerator, "The embedding generator cannot be NULL");
+        if (minSimilarity is <= 0 or > 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(minSimilarity), "The min similarity must be greater than 0 and less or equal to 1");
+        }
+
+        if (maxEntries < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxEntries), "The max number of entries must be greater than zero");
+        }
+
+        if (timeToLive <= TimeSpan.Zero)
+        {
+            throw new ArgumentOutOfRangeException(nameof(timeToLive), "The time to live must be greater than zero");
+        }
+
+        this._embeddingGenerator = embeddingGenerator;
+        this._storage = storage ?? new VolatileMemoryStore();
+        this.MinSimilarity = minSimilarity;
+        this._cacheNonDeterministicRequests = cacheNonDeterministicRequests;
+        this.MaxEntries = maxEntries;
+        this.TimeToLive = timeToLive;
+        this._clock = clock ?? (() => DateTimeOffset.UtcNow);
+    }
+
+    internal Task<Embedding<float>> GenerateEmbeddingAsync(string prompt, CancellationToken cancel = default)
+    {
+        return this._embeddingGenerator.GenerateEmbeddingAsync(prompt, cancel);
+    }
+
+    internal static string GetCollectionName(string backendLabel, string modelId, CompleteRequestSettings requestSettings)
+    {
+        return "completions-" + CompletionCache.CreateKey(backendLabel, modelId, string.Empty, requestSettings);
+    }
+
+    internal async Task<string?> TryGetAsync(string collection, Embedding<float> embedding, CancellationToken cancel = default)
+    {
+        cancel.ThrowIfCancellationRequested();
+        (IEmbeddingWithMetadata<float>? match, double _) = await this._storage.GetNearestMatchAsync(collection, embedding, this.MinSimilarity);
+        if (match is MemoryRecord record)
+        {
+            if (this.Touch(collection, record.Id))
+            {
+                Interlocked.Increment(ref this._hits);
+                return record.Description;
+            }
+
+            await this._storage.RemoveAsync(collection, record.Id, cancel);
+        }
+
+        Interlocked.Increment(ref this._misses);
+        return null;
+    }
+
+    internal async Task SetAsync(string collection, string prompt, Embedding<float> embedding, string completion, CancellationToken cancel = default)
+    {
+        // The ID is the hash of the prompt, so that the same prompt is stored only once
+        string id = CompletionCache.CreateKey(string.Empty, string.Empty, prompt, new CompleteRequestSettings());
+        MemoryRecord record = MemoryRecord.LocalRecord(id, prompt, completion, embedding);
+
+        await this._storage.PutValueAsync(collection, key: id, value: record, cancel: cancel);
+
+        foreach (Entry evicted in this.Track(collection, id))
+        {
+            await this._storage.RemoveAsync(evicted.Collection, evicted.Id, cancel);
+        }
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    private readonly IEmbeddingGenerator<string, float> _embeddingGenerator;
+    private readonly IMemoryStore<float> _storage;
+    private readonly bool _cacheNonDeterministicRequests;
+    private readonly Func<DateTimeOffset> _clock;
+    private readonly object _lock = new();
+
+    // Completions stored by this instance, most recently used first
+    private readonly LinkedList<Entry> _lru = new();
+    private readonly Dictionary<string, LinkedListNode<Entry>> _entries = new(StringComparer.Ordinal);
+
+    private long _hits;
+    private long _misses;
+
+    private sealed class Entry
+    {
+        internal Entry(string collection, string id, DateTimeOffset? expiration)
+        {
+            this.Collection = collection;
+            this.Id = id;
+            this.Expiration = expiration;
+        }
+
+        internal string Collection { get; }
+        internal string Id { get; }
+        internal DateTimeOffset? Expiration { get; }
+        internal string Key => GetKey(this.Collection, this.Id);
+    }
+
+    private static string GetKey(string collection, string id)
+    {
+        return $"{collection}/{id}";
+    }
+
+    /// <summary>
+    /// Track a new completion, returning the completions to remove from the storage to stay within the limits.
+    /// </summary>
+    private List<Entry> Track(string collection, string id)
+    {
+        var evicted = new List<Entry>();
+        var entry = new Entry(collection, id, this.TimeToLive.HasValue ? this._clock() + this.TimeToLive.Value : null);
+        lock (this._lock)
+        {
+            if (this._entries.TryGetValue(entry.Key, out LinkedListNode<Entry>? existing))
+            {
+                this._lru.Remove(existing);
+            }
+
+            this._entries[entry.Key] = this._lru.AddFirst(entry);
+
+            while (this._entries.Count > this.MaxEntries && this._lru.Last != null)
+            {
+                evicted.Add(this._lru.Last.Value);
+                this._entries.Remove(this._lru.Last.Value.Key);
+                this._lru.RemoveLast();
+            }
+        }
+
+        return evicted;
+    }
+
+    /// <summary>
+    /// Mark a completion as recently used.
+    /// </summary>
+    /// <returns>False if the completion is expired and must be removed from the storage</returns>
+    private bool Touch(string collection, string id)
+    {
+        lock (this._lock)
+        {
+            // Completions stored by other instances sharing the storage are not tracked
+            if (!this._entries.TryGetValue(GetKey(collection, id), out LinkedListNode<Entry>? node)) { return true; }
+
+            this._lru.Remove(node);
+            if (node.Value.Expiration.HasValue && node.Value.Expiration.Value <= this._clock())
+            {
+                this._entries.Remove(node.Value.Key);
+                return false;
+            }
+
+            this._lru.AddFirst(node);
+            return true;
+        }
+    }
+
+    #endregion
+}
@@ -41,6 +41,13 @@ public class CompleteRequestSettings
     /// </summary>
     public IList<string> StopSequences { get; set; } = Array.Empty<string>();
 
+    /// <summary>
+    /// Max time allowed to render the prompt and get the completion, including retries and time spent
+    /// waiting for rate limits. When NULL, the request is limited only by the caller's cancellation token.
+    /// The timeout is not sent to the backend, and is not part of the completion cache key.
+    /// </summary>
+    public TimeSpan? Timeout { get; set; }
+
     /// <summary>
     /// Create a new settings object with the values from another settings object.
     /// </summary>
@@ -0,0 +1,132 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace Microsoft.SemanticKernel.AI.Embeddings;
+
+/// <summary>
+/// Brain floating point (bfloat16) number: the 16 most significant bits of a <see cref="float"/>.
+/// Same range as <see cref="float"/> with reduced precision, used to store embeddings in half the space.
+/// </summary>
+/// <remarks>
+/// Only conversions to and from <see cref="float"/> are provided. Vector operations widen the values to
+/// <see cref="float"/> and accumulate in single precision.
+/// </remarks>
+[JsonConverter(typeof(BFloat16JsonConverter))]
+public readonly struct BFloat16 : IEquatable<BFloat16>
+{
+    /// <summary>
+    /// Create a value from its binary representation.
+    /// </summary>
+    /// <param name="bits">bfloat16 bits</param>
+    public BFloat16(ushort bits)
+    {
+        this.Bits = bits;
+    }
+
+    /// <summary>
+    /// bfloat16 bits, i.e. the upper 16 bits of the equivalent <see cref="float"/>.
+    /// </summary>
+    public ushort Bits { get; }
+
+    /// <summary>
+    /// Convert a <see cref="float"/> to the nearest bfloat16 value, rounding ties to even.
+    /// </summary>
+    /// <param name="value">Value to convert</param>
+    public static explicit operator BFloat16(float value)
+    {
+        return new BFloat16(FromSingle(value));
+    }
+
+    /// <summary>
+    /// Convert a bfloat16 value to <see cref="float"/>. The conversion is exact.
+    /// </summary>
+    /// <param name="value">Value to convert</param>
+    public static implicit operator float(BFloat16 value)
+    {
+        return ToSingle(value.Bits);
+    }
+
+    /// <inheritdoc/>
+    public bool Equals(BFloat16 other)
+    {
+        return this.Bits == other.Bits;
+    }
+
+    /// <inheritdoc/>
+    public override bool Equals(object obj)
+    {
+        return (obj is BFloat16 other) && this.Equals(other);
+    }
+
+    /// <inheritdoc/>
+    public override int GetHashCode()
+    {
+        return this.Bits.GetHashCode();
+    }
+
+    /// <inheritdoc/>
+    public override string ToString()
+    {
+        return ToSingle(this.Bits).ToString(System.Globalization.CultureInfo.InvariantCulture);
+    }
+
+    /// <summary>
+    /// Compares two values for binary equality.
+    /// </summary>
+    public static bool operator ==(BFloat16 left, BFloat16 right)
+    {
+        return left.Equals(right);
+    }
+
+    /// <summary>
+    /// Compares two values for binary inequality.
+    /// </summary>
+    public static bool operator !=(BFloat16 left, BFloat16 right)
+    {
+        return !(left == right);
+    }
+
+    /// <summary>
+    /// Convert bfloat16 bits to <see cref="float"/>.
+    /// </summary>
+    internal static float ToSingle(ushort bits)
+    {
+        return BitConverter.Int32BitsToSingle(bits << 16);
+    }
+
+    /// <summary>
+    /// Convert <see cref="float"/> to bfloat16 bits, rounding to nearest even.
+    /// </summary>
+    internal static ushort FromSingle(float value)
+    {
+        uint bits = (uint)BitConverter.SingleToInt32Bits(value);
+        if (float.IsNaN(value))
+        {
+            // Keep the sign, make sure the truncated mantissa is not zero
+            return (ushort)((bits >> 16) | 0x0040u);
+        }
+
+        uint roundingBias = 0x7FFFu + ((bits >> 16) & 1);
+        return (ushort)((bits + roundingBias) >> 16);
+    }
+
+    #region private ================================================================================
+
+    private sealed class BFloat16JsonConverter : JsonConverter<BFloat16>
+    {
+        public override BFloat16 Read(ref Utf8JsonReader reader, Type typeToConvert, JsonSerializerOptions options)
+        {
+            return (BFloat16)reader.GetSingle();
+        }
+
+        public override void Write(Utf8JsonWriter writer, BFloat16 value, JsonSerializerOptions options)
+        {
+            writer.WriteNumberValue((float)value);
+        }
+    }
+
+    #endregion
+}
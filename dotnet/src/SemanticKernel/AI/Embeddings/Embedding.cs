@@ -182,5 +182,5 @@ public static class Embedding
     /// <summary>
     /// Types supported by the <see cref="Embedding{TEmbedding}"/> struct.
     /// </summary>
-    public static readonly Type[] SupportedTypes = { typeof(float), typeof(double) };
+    public static readonly Type[] SupportedTypes = Embeddings.SupportedTypes.Types.ToArray();
 }
@@ -0,0 +1,163 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace Microsoft.SemanticKernel.AI.Embeddings;
+
+/// <summary>
+/// IEEE 754 half precision (binary16) floating point number, used to store embeddings in half the space of <see cref="float"/>.
+/// The binary layout is the same as System.Half, available on .NET 5 and later.
+/// </summary>
+/// <remarks>
+/// Only conversions to and from <see cref="float"/> are provided. Vector operations widen the values to
+/// <see cref="float"/> and accumulate in single precision.
+/// </remarks>
+[JsonConverter(typeof(Float16JsonConverter))]
+public readonly struct Float16 : IEquatable<Float16>
+{
+    /// <summary>
+    /// Create a value from its binary representation.
+    /// </summary>
+    /// <param name="bits">IEEE 754 binary16 bits</param>
+    public Float16(ushort bits)
+    {
+        this.Bits = bits;
+    }
+
+    /// <summary>
+    /// IEEE 754 binary16 bits.
+    /// </summary>
+    public ushort Bits { get; }
+
+    /// <summary>
+    /// Convert a <see cref="float"/> to the nearest half precision value, rounding ties to even.
+    /// Values too large to be represented become infinity.
+    /// </summary>
+    /// <param name="value">Value to convert</param>
+    public static explicit operator Float16(float value)
+    {
+        return new Float16(FromSingle(value));
+    }
+
+    /// <summary>
+    /// Convert a half precision value to <see cref="float"/>. The conversion is exact.
+    /// </summary>
+    /// <param name="value">Value to convert</param>
+    public static implicit operator float(Float16 value)
+    {
+        return ToSingle(value.Bits);
+    }
+
+    /// <inheritdoc/>
+    public bool Equals(Float16 other)
+    {
+        return this.Bits == other.Bits;
+    }
+
+    /// <inheritdoc/>
+    public override bool Equals(object obj)
+    {
+        return (obj is Float16 other) && this.Equals(other);
+    }
+
+    /// <inheritdoc/>
+    public override int GetHashCode()
+    {
+        return this.Bits.GetHashCode();
+    }
+
+    /// <inheritdoc/>
+    public override string ToString()
+    {
+        return ToSingle(this.Bits).ToString(System.Globalization.CultureInfo.InvariantCulture);
+    }
+
+    /// <summary>
+    /// Compares two values for binary equality.
+    /// </summary>
+    public static bool operator ==(Float16 left, Float16 right)
+    {
+        return left.Equals(right);
+    }
+
+    /// <summary>
+    /// Compares two values for binary inequality.
+    /// </summary>
+    public static bool operator !=(Float16 left, Float16 right)
+    {
+        return !(left == right);
+    }
+
+    /// <summary>
+    /// Convert binary16 bits to <see cref="float"/>.
+    /// </summary>
+    internal static float ToSingle(ushort bits)
+    {
+        // Move exponent and mantissa in place, then rebias the exponent with a multiplication,
+        // which also normalizes subnormal values. Infinity and NaN keep an all-ones exponent.
+        uint expMantissa = bits & 0x7FFFu;
+        float value = BitConverter.Int32BitsToSingle((int)(expMantissa << 13)) * s_exponentAdjust;
+        uint result = (uint)BitConverter.SingleToInt32Bits(value);
+        if (expMantissa >= 0x7C00u) { result |= 0x7F800000u; }
+
+        return BitConverter.Int32BitsToSingle((int)(result | ((bits & 0x8000u) << 16)));
+    }
+
+    /// <summary>
+    /// Convert <see cref="float"/> to binary16 bits, rounding to nearest even.
+    /// </summary>
+    internal static ushort FromSingle(float value)
+    {
+        uint bits = (uint)BitConverter.SingleToInt32Bits(value);
+        uint sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint result;
+        if (bits >= Float16MaxAsSingleBits)
+        {
+            // Overflow to infinity, or NaN
+            result = bits > SingleInfinityBits ? 0x7E00u : 0x7C00u;
+        }
+        else if (bits < Float16MinNormalAsSingleBits)
+        {
+            // Subnormal or zero: let the FPU round, adding a value that aligns the mantissa
+            float aligned = BitConverter.Int32BitsToSingle((int)bits) + BitConverter.Int32BitsToSingle((int)SubnormalMagicBits);
+            result = (uint)BitConverter.SingleToInt32Bits(aligned) - SubnormalMagicBits;
+        }
+        else
+        {
+            uint mantissaOdd = (bits >> 13) & 1;
+            bits += unchecked((uint)((15 - 127) << 23)) + 0xFFFu + mantissaOdd;
+            result = bits >> 13;
+        }
+
+        return (ushort)(result | (sign >> 16));
+    }
+
+    #region private ================================================================================
+
+    // 2^112: difference between the float and the half exponent bias
+    private static readonly float s_exponentAdjust = BitConverter.Int32BitsToSingle(0x77800000);
+
+    private const uint SingleInfinityBits = 0xFFu << 23;
+    private const uint Float16MaxAsSingleBits = (127 + 16) << 23;
+    private const uint Float16MinNormalAsSingleBits = (127 - 14) << 23;
+    private const uint SubnormalMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    private sealed class Float16JsonConverter : JsonConverter<Float16>
+    {
+        public override Float16 Read(ref Utf8JsonReader reader, Type typeToConvert, JsonSerializerOptions options)
+        {
+            return (Float16)reader.GetSingle();
+        }
+
+        public override void Write(Utf8JsonWriter writer, Float16 value, JsonSerializerOptions options)
+        {
+            writer.WriteNumberValue((float)value);
+        }
+    }
+
+    #endregion
+}
@@ -2,6 +2,7 @@
 
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.SemanticKernel.Diagnostics;
 
@@ -19,8 +20,9 @@ public interface IEmbeddingGenerator<TValue, TEmbedding>
     /// Generates an embedding from the given <paramref name="data"/>.
     /// </summary>
     /// <param name="data">List of strings to generate embeddings for</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>List of embeddings</returns>
-    Task<IList<Embedding<TEmbedding>>> GenerateEmbeddingsAsync(IList<TValue> data);
+    Task<IList<Embedding<TEmbedding>>> GenerateEmbeddingsAsync(IList<TValue> data, CancellationToken cancellationToken = default);
 }
 
 /// <summary>
@@ -35,12 +37,13 @@ public static class EmbeddingGeneratorExtensions
     /// <typeparam name="TEmbedding">The numeric type of the embedding data.</typeparam>
     /// <param name="generator">The embedding generator.</param>
     /// <param name="value">A value from which an <see cref="Embedding{TEmbedding}"/> will be generated.</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>A list of <see cref="Embedding{TEmbedding}"/> structs representing the input <paramref name="value"/>.</returns>
     public static async Task<Embedding<TEmbedding>> GenerateEmbeddingAsync<TValue, TEmbedding>
-        (this IEmbeddingGenerator<TValue, TEmbedding> generator, TValue value)
+        (this IEmbeddingGenerator<TValue, TEmbedding> generator, TValue value, CancellationToken cancellationToken = default)
         where TEmbedding : unmanaged
     {
         Verify.NotNull(generator, "Embeddings generator cannot be NULL");
-        return (await generator.GenerateEmbeddingsAsync(new[] { value })).FirstOrDefault();
+        return (await generator.GenerateEmbeddingsAsync(new[] { value }, cancellationToken)).FirstOrDefault();
     }
 }
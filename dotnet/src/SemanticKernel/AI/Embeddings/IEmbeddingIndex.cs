@@ -1,6 +1,7 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
 using System.Collections.Generic;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.SemanticKernel.Diagnostics;
 
@@ -26,6 +27,23 @@ public interface IEmbeddingIndex<TEmbedding>
         Embedding<TEmbedding> embedding,
         int limit = 1,
         double minRelevanceScore = 0.0);
+
+    /// <summary>
+    /// Gets the nearest matches to each of the given <see cref="Embedding{TEmbedding}"/>, scanning the collection once for all the queries.
+    /// </summary>
+    /// <param name="collection">The storage collection to search.</param>
+    /// <param name="embeddings">The input <see cref="Embedding{TEmbedding}"/> list to use as the search.</param>
+    /// <param name="limit">The max number of results to return for each query.</param>
+    /// <param name="minRelevanceScore">The minimum score to consider in the distance calculation.</param>
+    /// <param name="cancel">Cancellation token.</param>
+    /// <returns>For each query, in the same order as the input, a list of tuples consisting of the
+    /// <see cref="IEmbeddingWithMetadata{TEmbedding}"/> and the similarity score, sorted by score.</returns>
+    Task<IList<IList<(IEmbeddingWithMetadata<TEmbedding>, double)>>> GetNearestMatchesBatchAsync(
+        string collection,
+        IList<Embedding<TEmbedding>> embeddings,
+        int limit = 1,
+        double minRelevanceScore = 0.0,
+        CancellationToken cancel = default);
 }
 
 /// <summary>
@@ -4,6 +4,7 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Runtime.CompilerServices;
+using Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
 
 namespace Microsoft.SemanticKernel.AI.Embeddings;
 
@@ -59,7 +60,17 @@ public static class SupportedTypes
 
     #region private ================================================================================
 
-    private static readonly Type[] s_types = { typeof(float), typeof(double) };
+    private static readonly Type[] s_types = GetTypes();
+
+    private static Type[] GetTypes()
+    {
+        var types = new List<Type> { typeof(float), typeof(double), typeof(Float16), typeof(BFloat16) };
+
+        // System.Half has the same layout as Float16, and is available only on .NET 5 and later
+        if (HalfPrecisionOperations.SystemHalfType != null) { types.Add(HalfPrecisionOperations.SystemHalfType); }
+
+        return types.ToArray();
+    }
 
     private static new string ToString()
     {
@@ -0,0 +1,303 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
+
+/// <summary>
+/// Cosine similarity between a block of records and a batch of queries, computed as a small matrix-matrix product.
+/// </summary>
+/// <remarks>
+/// Queries are processed in groups of <see cref="QueryGroupSize"/>: each record is read once per group,
+/// accumulating the dot products with all the queries of the group and its own length in the same pass.
+/// Callers should size the record block so that it fits in the CPU cache, so that the block is read
+/// from memory once and then reused from cache by all the query groups.
+/// </remarks>
+internal static class CosineSimilarityBatchOperation
+{
+    /// <summary>
+    /// Number of queries scored together against each record.
+    /// </summary>
+    internal const int QueryGroupSize = 4;
+
+    /// <summary>
+    /// Calculate the cosine similarity of each record against each query.
+    /// </summary>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
+    /// <param name="records">Block of records to score.</param>
+    /// <param name="queries">Queries to score the records against.</param>
+    /// <param name="queryLengths">Euclidean length of each query.</param>
+    /// <param name="scores">Output, the score of record R for query Q is stored at [Q * records.Length + R].</param>
+    internal static void CosineSimilarityBlock<TNumber>(
+        ReadOnlySpan<Embedding<TNumber>> records,
+        ReadOnlySpan<Embedding<TNumber>> queries,
+        ReadOnlySpan<double> queryLengths,
+        Span<double> scores)
+        where TNumber : unmanaged
+    {
+        if (queryLengths.Length != queries.Length || scores.Length < records.Length * queries.Length)
+        {
+            throw new ArgumentException("Output size doesn't match the number of records and queries");
+        }
+
+        Span<double> dots = stackalloc double[QueryGroupSize];
+        for (int q = 0; q < queries.Length; q += QueryGroupSize)
+        {
+            int groupSize = Math.Min(QueryGroupSize, queries.Length - q);
+            for (int r = 0; r < records.Length; r++)
+            {
+                ReadOnlySpan<TNumber> record = records[r].AsReadOnlySpan();
+                double recordLengthSquared;
+                if (groupSize == QueryGroupSize)
+                {
+                    DotProducts(record,
+                        queries[q].AsReadOnlySpan(), queries[q + 1].AsReadOnlySpan(),
+                        queries[q + 2].AsReadOnlySpan(), queries[q + 3].AsReadOnlySpan(),
+                        dots, out recordLengthSquared);
+                }
+                else
+                {
+                    recordLengthSquared = 0;
+                    for (int i = 0; i < groupSize; i++)
+                    {
+                        dots[i] = DotProduct(record, queries[q + i].AsReadOnlySpan(), out recordLengthSquared);
+                    }
+                }
+
+                double recordLength = Math.Sqrt(recordLengthSquared);
+                for (int i = 0; i < groupSize; i++)
+                {
+                    scores[((q + i) * records.Length) + r] = dots[i] / (queryLengths[q + i] * recordLength);
+                }
+            }
+        }
+    }
+
+    #region private ================================================================================
+
+    private static void DotProducts<TNumber>(
+        ReadOnlySpan<TNumber> x,
+        ReadOnlySpan<TNumber> y0, ReadOnlySpan<TNumber> y1, ReadOnlySpan<TNumber> y2, ReadOnlySpan<TNumber> y3,
+        Span<double> dots, out double xx)
+        where TNumber : unmanaged
+    {
+        if (x.Length != y0.Length || x.Length != y1.Length || x.Length != y2.Length || x.Length != y3.Length)
+        {
+            throw new ArgumentException("Array lengths must be equal");
+        }
+
+        if (typeof(TNumber) == typeof(float))
+        {
+            DotProductsImplementation(MemoryMarshal.Cast<TNumber, float>(x),
+                MemoryMarshal.Cast<TNumber, float>(y0), MemoryMarshal.Cast<TNumber, float>(y1),
+                MemoryMarshal.Cast<TNumber, float>(y2), MemoryMarshal.Cast<TNumber, float>(y3),
+                dots, out xx);
+            return;
+        }
+
+        if (typeof(TNumber) == typeof(double))
+        {
+            DotProductsImplementation(MemoryMarshal.Cast<TNumber, double>(x),
+                MemoryMarshal.Cast<TNumber, double>(y0), MemoryMarshal.Cast<TNumber, double>(y1),
+                MemoryMarshal.Cast<TNumber, double>(y2), MemoryMarshal.Cast<TNumber, double>(y3),
+                dots, out xx);
+            return;
+        }
+
+        HalfPrecisionFormat format = HalfPrecisionOperations.GetFormat<TNumber>();
+        if (format != HalfPrecisionFormat.None)
+        {
+            HalfPrecisionOperations.DotProducts(MemoryMarshal.Cast<TNumber, ushort>(x),
+                MemoryMarshal.Cast<TNumber, ushort>(y0), MemoryMarshal.Cast<TNumber, ushort>(y1),
+                MemoryMarshal.Cast<TNumber, ushort>(y2), MemoryMarshal.Cast<TNumber, ushort>(y3),
+                format, dots, out xx);
+            return;
+        }
+
+        SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
+        xx = default;
+    }
+
+    private static double DotProduct<TNumber>(ReadOnlySpan<TNumber> x, ReadOnlySpan<TNumber> y, out double xx)
+        where TNumber : unmanaged
+    {
+        if (x.Length != y.Length)
+        {
+            throw new ArgumentException("Array lengths must be equal");
+        }
+
+        if (typeof(TNumber) == typeof(float))
+        {
+            return DotProductImplementation(MemoryMarshal.Cast<TNumber, float>(x), MemoryMarshal.Cast<TNumber, float>(y), out xx);
+        }
+
+        if (typeof(TNumber) == typeof(double))
+        {
+            return DotProductImplementation(MemoryMarshal.Cast<TNumber, double>(x), MemoryMarshal.Cast<TNumber, double>(y), out xx);
+        }
+
+        HalfPrecisionFormat format = HalfPrecisionOperations.GetFormat<TNumber>();
+        if (format != HalfPrecisionFormat.None)
+        {
+            return HalfPrecisionOperations.DotProduct(MemoryMarshal.Cast<TNumber, ushort>(x), MemoryMarshal.Cast<TNumber, ushort>(y), format, out xx);
+        }
+
+        SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
+        xx = default;
+        return default;
+    }
+
+    private static void DotProductsImplementation(
+        ReadOnlySpan<float> x,
+        ReadOnlySpan<float> y0, ReadOnlySpan<float> y1, ReadOnlySpan<float> y2, ReadOnlySpan<float> y3,
+        Span<double> dots, out double xx)
+    {
+        ReadOnlySpan<Vector<float>> vx = MemoryMarshal.Cast<float, Vector<float>>(x);
+        ReadOnlySpan<Vector<float>> vy0 = MemoryMarshal.Cast<float, Vector<float>>(y0);
+        ReadOnlySpan<Vector<float>> vy1 = MemoryMarshal.Cast<float, Vector<float>>(y1);
+        ReadOnlySpan<Vector<float>> vy2 = MemoryMarshal.Cast<float, Vector<float>>(y2);
+        ReadOnlySpan<Vector<float>> vy3 = MemoryMarshal.Cast<float, Vector<float>>(y3);
+
+        Vector<float> sum0 = Vector<float>.Zero;
+        Vector<float> sum1 = Vector<float>.Zero;
+        Vector<float> sum2 = Vector<float>.Zero;
+        Vector<float> sum3 = Vector<float>.Zero;
+        Vector<float> sumXX = Vector<float>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Vector<float> v = vx[i];
+            sum0 += v * vy0[i];
+            sum1 += v * vy1[i];
+            sum2 += v * vy2[i];
+            sum3 += v * vy3[i];
+            sumXX += v * v;
+        }
+
+        double dot0 = Vector.Dot(sum0, Vector<float>.One);
+        double dot1 = Vector.Dot(sum1, Vector<float>.One);
+        double dot2 = Vector.Dot(sum2, Vector<float>.One);
+        double dot3 = Vector.Dot(sum3, Vector<float>.One);
+        xx = Vector.Dot(sumXX, Vector<float>.One);
+
+        // Remaining items, when the length is not a multiple of the vector size
+        for (int i = vx.Length * Vector<float>.Count; i < x.Length; i++)
+        {
+            double v = x[i];
+            dot0 += v * y0[i];
+            dot1 += v * y1[i];
+            dot2 += v * y2[i];
+            dot3 += v * y3[i];
+            xx += v * v;
+        }
+
+        dots[0] = dot0;
+        dots[1] = dot1;
+        dots[2] = dot2;
+        dots[3] = dot3;
+    }
+
+    private static void DotProductsImplementation(
+        ReadOnlySpan<double> x,
+        ReadOnlySpan<double> y0, ReadOnlySpan<double> y1, ReadOnlySpan<double> y2, ReadOnlySpan<double> y3,
+        Span<double> dots, out double xx)
+    {
+        ReadOnlySpan<Vector<double>> vx = MemoryMarshal.Cast<double, Vector<double>>(x);
+        ReadOnlySpan<Vector<double>> vy0 = MemoryMarshal.Cast<double, Vector<double>>(y0);
+        ReadOnlySpan<Vector<double>> vy1 = MemoryMarshal.Cast<double, Vector<double>>(y1);
+        ReadOnlySpan<Vector<double>> vy2 = MemoryMarshal.Cast<double, Vector<double>>(y2);
+        ReadOnlySpan<Vector<double>> vy3 = MemoryMarshal.Cast<double, Vector<double>>(y3);
+
+        Vector<double> sum0 = Vector<double>.Zero;
+        Vector<double> sum1 = Vector<double>.Zero;
+        Vector<double> sum2 = Vector<double>.Zero;
+        Vector<double> sum3 = Vector<double>.Zero;
+        Vector<double> sumXX = Vector<double>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Vector<double> v = vx[i];
+            sum0 += v * vy0[i];
+            sum1 += v * vy1[i];
+            sum2 += v * vy2[i];
+            sum3 += v * vy3[i];
+            sumXX += v * v;
+        }
+
+        double dot0 = Vector.Dot(sum0, Vector<double>.One);
+        double dot1 = Vector.Dot(sum1, Vector<double>.One);
+        double dot2 = Vector.Dot(sum2, Vector<double>.One);
+        double dot3 = Vector.Dot(sum3, Vector<double>.One);
+        xx = Vector.Dot(sumXX, Vector<double>.One);
+
+        // Remaining items, when the length is not a multiple of the vector size
+        for (int i = vx.Length * Vector<double>.Count; i < x.Length; i++)
+        {
+            double v = x[i];
+            dot0 += v * y0[i];
+            dot1 += v * y1[i];
+            dot2 += v * y2[i];
+            dot3 += v * y3[i];
+            xx += v * v;
+        }
+
+        dots[0] = dot0;
+        dots[1] = dot1;
+        dots[2] = dot2;
+        dots[3] = dot3;
+    }
+
+    private static double DotProductImplementation(ReadOnlySpan<float> x, ReadOnlySpan<float> y, out double xx)
+    {
+        ReadOnlySpan<Vector<float>> vx = MemoryMarshal.Cast<float, Vector<float>>(x);
+        ReadOnlySpan<Vector<float>> vy = MemoryMarshal.Cast<float, Vector<float>>(y);
+
+        Vector<float> sum = Vector<float>.Zero;
+        Vector<float> sumXX = Vector<float>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Vector<float> v = vx[i];
+            sum += v * vy[i];
+            sumXX += v * v;
+        }
+
+        double dot = Vector.Dot(sum, Vector<float>.One);
+        xx = Vector.Dot(sumXX, Vector<float>.One);
+        for (int i = vx.Length * Vector<float>.Count; i < x.Length; i++)
+        {
+            double v = x[i];
+            dot += v * y[i];
+            xx += v * v;
+        }
+
+        return dot;
+    }
+
+    private static double DotProductImplementation(ReadOnlySpan<double> x, ReadOnlySpan<double> y, out double xx)
+    {
+        ReadOnlySpan<Vector<double>> vx = MemoryMarshal.Cast<double, Vector<double>>(x);
+        ReadOnlySpan<Vector<double>> vy = MemoryMarshal.Cast<double, Vector<double>>(y);
+
+        Vector<double> sum = Vector<double>.Zero;
+        Vector<double> sumXX = Vector<double>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Vector<double> v = vx[i];
+            sum += v * vy[i];
+            sumXX += v * v;
+        }
+
+        double dot = Vector.Dot(sum, Vector<double>.One);
+        xx = Vector.Dot(sumXX, Vector<double>.One);
+        for (int i = vx.Length * Vector<double>.Count; i < x.Length; i++)
+        {
+            double v = x[i];
+            dot += v * y[i];
+            xx += v * v;
+        }
+
+        return dot;
+    }
+
+    #endregion
+}
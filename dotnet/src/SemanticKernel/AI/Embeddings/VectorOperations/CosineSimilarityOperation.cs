@@ -16,7 +16,7 @@ public static class CosineSimilarityOperation
     /// <summary>
     /// Calculate the cosine similarity between two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     public static double CosineSimilarity<TNumber>(this ReadOnlySpan<TNumber> x, ReadOnlySpan<TNumber> y)
@@ -34,6 +34,12 @@ public static class CosineSimilarityOperation
             ReadOnlySpan<double> doubleSpanY = MemoryMarshal.Cast<TNumber, double>(y);
             return CosineSimilarityImplementation(doubleSpanX, doubleSpanY);
         }
+        else if (HalfPrecisionOperations.GetFormat<TNumber>() != HalfPrecisionFormat.None)
+        {
+            ReadOnlySpan<ushort> halfSpanX = MemoryMarshal.Cast<TNumber, ushort>(x);
+            ReadOnlySpan<ushort> halfSpanY = MemoryMarshal.Cast<TNumber, ushort>(y);
+            return HalfPrecisionOperations.CosineSimilarity(halfSpanX, halfSpanY, HalfPrecisionOperations.GetFormat<TNumber>());
+        }
 
         SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
         return default;
@@ -42,7 +48,7 @@ public static class CosineSimilarityOperation
     /// <summary>
     /// Calculate the cosine similarity between two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     public static double CosineSimilarity<TNumber>(this Span<TNumber> x, Span<TNumber> y)
@@ -54,7 +60,7 @@ public static class CosineSimilarityOperation
     /// <summary>
     /// Calculate the cosine similarity between two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     public static double CosineSimilarity<TNumber>(this TNumber[] x, TNumber[] y)
@@ -13,7 +13,7 @@ public static class DivideOperation
     /// <summary>
     /// Divide all elements of <see cref="Span{T}"/> of type <typeparamref name="TNumber"/> by <paramref name="divisor"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="span">The data vector</param>
     /// <param name="divisor">The value to divide by.</param>
     public static void DivideByInPlace<TNumber>(this Span<TNumber> span, double divisor)
@@ -29,6 +29,11 @@ public static class DivideOperation
             Span<double> doubleSpan = MemoryMarshal.Cast<TNumber, double>(span);
             DivideByInPlaceImplementation(doubleSpan, divisor);
         }
+        else if (HalfPrecisionOperations.GetFormat<TNumber>() != HalfPrecisionFormat.None)
+        {
+            Span<ushort> halfSpan = MemoryMarshal.Cast<TNumber, ushort>(span);
+            HalfPrecisionOperations.DivideByInPlace(halfSpan, HalfPrecisionOperations.GetFormat<TNumber>(), divisor);
+        }
         else
         {
             SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
@@ -38,7 +43,7 @@ public static class DivideOperation
     /// <summary>
     /// Divide all elements of an array of type <typeparamref name="TNumber"/> by <paramref name="divisor"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The data vector</param>
     /// <param name="divisor">The value to divide by.</param>
     public static void DivideByInPlace<TNumber>(this TNumber[] vector, double divisor)
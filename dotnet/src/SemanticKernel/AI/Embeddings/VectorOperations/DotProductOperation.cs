@@ -16,7 +16,7 @@ public static class DotProductOperation
     /// <summary>
     /// Calculate the dot products of two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     /// <returns>The dot product as a <see cref="double"/>.</returns>
@@ -35,6 +35,12 @@ public static class DotProductOperation
             ReadOnlySpan<double> doubleSpanY = MemoryMarshal.Cast<TNumber, double>(y);
             return DotProductImplementation(doubleSpanX, doubleSpanY);
         }
+        else if (HalfPrecisionOperations.GetFormat<TNumber>() != HalfPrecisionFormat.None)
+        {
+            ReadOnlySpan<ushort> halfSpanX = MemoryMarshal.Cast<TNumber, ushort>(x);
+            ReadOnlySpan<ushort> halfSpanY = MemoryMarshal.Cast<TNumber, ushort>(y);
+            return HalfPrecisionOperations.DotProduct(halfSpanX, halfSpanY, HalfPrecisionOperations.GetFormat<TNumber>());
+        }
 
         SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
         return default;
@@ -43,7 +49,7 @@ public static class DotProductOperation
     /// <summary>
     /// Calculate the dot products of two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     /// <returns>The dot product as a <see cref="double"/>.</returns>
@@ -56,7 +62,7 @@ public static class DotProductOperation
     /// <summary>
     /// Calculate the dot products of two vectors of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The first vector.</param>
     /// <param name="y">The second vector.</param>
     /// <returns>The dot product as a <see cref="double"/>.</returns>
@@ -12,7 +12,7 @@ public static class EuclideanLengthOperation
     /// <summary>
     /// Calculate the Euclidean length of a vector of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The vector.</param>
     /// <returns>Euclidean length as a <see cref="double"/></returns>
     public static double EuclideanLength<TNumber>(this ReadOnlySpan<TNumber> x)
@@ -24,7 +24,7 @@ public static class EuclideanLengthOperation
     /// <summary>
     /// Calculate the Euclidean length of a vector of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="x">The vector.</param>
     /// <returns>Euclidean length as a <see cref="double"/></returns>
     public static double EuclideanLength<TNumber>(this Span<TNumber> x)
@@ -37,7 +37,7 @@ public static class EuclideanLengthOperation
     /// <summary>
     /// Calculate the Euclidean length of a vector of type <typeparamref name="TNumber"/>.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The vector.</param>
     /// <returns>Euclidean length as a <see cref="double"/></returns>
     public static double EuclideanLength<TNumber>(this TNumber[] vector)
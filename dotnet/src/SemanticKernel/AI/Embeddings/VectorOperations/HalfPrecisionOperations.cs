@@ -0,0 +1,237 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
+
+/// <summary>
+/// 16-bit floating point formats supported by the vector operations.
+/// </summary>
+internal enum HalfPrecisionFormat
+{
+    None = 0,
+
+    /// <summary>
+    /// IEEE 754 binary16, i.e. <see cref="Embeddings.Float16"/> and System.Half.
+    /// </summary>
+    Float16 = 1,
+
+    /// <summary>
+    /// bfloat16, i.e. <see cref="Embeddings.BFloat16"/>.
+    /// </summary>
+    BFloat16 = 2,
+}
+
+/// <summary>
+/// Vector operations on 16-bit floating point values. Values are widened to <see cref="float"/>
+/// using SIMD instructions, and results are accumulated in single precision.
+/// </summary>
+internal static class HalfPrecisionOperations
+{
+    /// <summary>
+    /// System.Half, available on .NET 5 and later. The binary layout is the same as <see cref="Embeddings.Float16"/>.
+    /// </summary>
+    internal static readonly Type? SystemHalfType = Type.GetType("System.Half", throwOnError: false);
+
+    /// <summary>
+    /// Get the 16-bit format of a type, if any.
+    /// </summary>
+    internal static HalfPrecisionFormat GetFormat(Type type)
+    {
+        if (type == typeof(Float16) || (SystemHalfType != null && type == SystemHalfType)) { return HalfPrecisionFormat.Float16; }
+
+        if (type == typeof(BFloat16)) { return HalfPrecisionFormat.BFloat16; }
+
+        return HalfPrecisionFormat.None;
+    }
+
+    /// <summary>
+    /// Get the 16-bit format of a type, if any, cached per type.
+    /// </summary>
+    internal static HalfPrecisionFormat GetFormat<TNumber>() where TNumber : unmanaged
+    {
+        return FormatCache<TNumber>.Format;
+    }
+
+    internal static double DotProduct(ReadOnlySpan<ushort> x, ReadOnlySpan<ushort> y, HalfPrecisionFormat format)
+    {
+        return DotProduct(x, y, format, out _);
+    }
+
+    internal static double CosineSimilarity(ReadOnlySpan<ushort> x, ReadOnlySpan<ushort> y, HalfPrecisionFormat format)
+    {
+        double dot = DotProduct(x, y, format, out double xx);
+        double yy = DotProduct(y, y, format, out _);
+
+        return dot / (Math.Sqrt(xx) * Math.Sqrt(yy));
+    }
+
+    /// <summary>
+    /// Calculate the dot product of two vectors, and the dot product of the first vector with itself.
+    /// </summary>
+    internal static double DotProduct(ReadOnlySpan<ushort> x, ReadOnlySpan<ushort> y, HalfPrecisionFormat format, out double xx)
+    {
+        if (x.Length != y.Length)
+        {
+            throw new ArgumentException("Array lengths must be equal");
+        }
+
+        ReadOnlySpan<Vector<ushort>> vx = MemoryMarshal.Cast<ushort, Vector<ushort>>(x);
+        ReadOnlySpan<Vector<ushort>> vy = MemoryMarshal.Cast<ushort, Vector<ushort>>(y);
+
+        Vector<float> sum = Vector<float>.Zero;
+        Vector<float> sumXX = Vector<float>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Widen(vx[i], format, out Vector<float> xLow, out Vector<float> xHigh);
+            Widen(vy[i], format, out Vector<float> yLow, out Vector<float> yHigh);
+            sum += (xLow * yLow) + (xHigh * yHigh);
+            sumXX += (xLow * xLow) + (xHigh * xHigh);
+        }
+
+        double dot = Vector.Dot(sum, Vector<float>.One);
+        xx = Vector.Dot(sumXX, Vector<float>.One);
+
+        // Remaining items, when the length is not a multiple of the vector size
+        for (int i = vx.Length * Vector<ushort>.Count; i < x.Length; i++)
+        {
+            double xValue = ToSingle(x[i], format);
+            dot += xValue * ToSingle(y[i], format);
+            xx += xValue * xValue;
+        }
+
+        return dot;
+    }
+
+    /// <summary>
+    /// Calculate the dot products of a vector with four other vectors, and the dot product of the first vector with itself.
+    /// The first vector is widened only once.
+    /// </summary>
+    internal static void DotProducts(
+        ReadOnlySpan<ushort> x,
+        ReadOnlySpan<ushort> y0, ReadOnlySpan<ushort> y1, ReadOnlySpan<ushort> y2, ReadOnlySpan<ushort> y3,
+        HalfPrecisionFormat format, Span<double> dots, out double xx)
+    {
+        ReadOnlySpan<Vector<ushort>> vx = MemoryMarshal.Cast<ushort, Vector<ushort>>(x);
+        ReadOnlySpan<Vector<ushort>> vy0 = MemoryMarshal.Cast<ushort, Vector<ushort>>(y0);
+        ReadOnlySpan<Vector<ushort>> vy1 = MemoryMarshal.Cast<ushort, Vector<ushort>>(y1);
+        ReadOnlySpan<Vector<ushort>> vy2 = MemoryMarshal.Cast<ushort, Vector<ushort>>(y2);
+        ReadOnlySpan<Vector<ushort>> vy3 = MemoryMarshal.Cast<ushort, Vector<ushort>>(y3);
+
+        Vector<float> sum0 = Vector<float>.Zero;
+        Vector<float> sum1 = Vector<float>.Zero;
+        Vector<float> sum2 = Vector<float>.Zero;
+        Vector<float> sum3 = Vector<float>.Zero;
+        Vector<float> sumXX = Vector<float>.Zero;
+        for (int i = 0; i < vx.Length; i++)
+        {
+            Widen(vx[i], format, out Vector<float> xLow, out Vector<float> xHigh);
+            sumXX += (xLow * xLow) + (xHigh * xHigh);
+
+            Widen(vy0[i], format, out Vector<float> yLow, out Vector<float> yHigh);
+            sum0 += (xLow * yLow) + (xHigh * yHigh);
+            Widen(vy1[i], format, out yLow, out yHigh);
+            sum1 += (xLow * yLow) + (xHigh * yHigh);
+            Widen(vy2[i], format, out yLow, out yHigh);
+            sum2 += (xLow * yLow) + (xHigh * yHigh);
+            Widen(vy3[i], format, out yLow, out yHigh);
+            sum3 += (xLow * yLow) + (xHigh * yHigh);
+        }
+
+        double dot0 = Vector.Dot(sum0, Vector<float>.One);
+        double dot1 = Vector.Dot(sum1, Vector<float>.One);
+        double dot2 = Vector.Dot(sum2, Vector<float>.One);
+        double dot3 = Vector.Dot(sum3, Vector<float>.One);
+        xx = Vector.Dot(sumXX, Vector<float>.One);
+
+        for (int i = vx.Length * Vector<ushort>.Count; i < x.Length; i++)
+        {
+            double xValue = ToSingle(x[i], format);
+            dot0 += xValue * ToSingle(y0[i], format);
+            dot1 += xValue * ToSingle(y1[i], format);
+            dot2 += xValue * ToSingle(y2[i], format);
+            dot3 += xValue * ToSingle(y3[i], format);
+            xx += xValue * xValue;
+        }
+
+        dots[0] = dot0;
+        dots[1] = dot1;
+        dots[2] = dot2;
+        dots[3] = dot3;
+    }
+
+    internal static void MultiplyByInPlace(Span<ushort> x, HalfPrecisionFormat format, double multiplier)
+    {
+        for (int i = 0; i < x.Length; i++)
+        {
+            x[i] = FromSingle((float)(ToSingle(x[i], format) * multiplier), format);
+        }
+    }
+
+    internal static void DivideByInPlace(Span<ushort> x, HalfPrecisionFormat format, double divisor)
+    {
+        for (int i = 0; i < x.Length; i++)
+        {
+            x[i] = FromSingle((float)(ToSingle(x[i], format) / divisor), format);
+        }
+    }
+
+    #region private ================================================================================
+
+    private static class FormatCache<TNumber>
+    {
+        internal static readonly HalfPrecisionFormat Format = GetFormat(typeof(TNumber));
+    }
+
+    private static readonly Vector<uint> s_upperHalfMultiplier = new(0x10000u);
+    private static readonly Vector<uint> s_float16ExponentShift = new(1u << 13);
+    private static readonly Vector<uint> s_float16ExpMantissaMask = new(0x7FFFu);
+    private static readonly Vector<uint> s_float16SignMask = new(0x8000u);
+    private static readonly Vector<uint> s_float16InfinityBits = new(0x7C00u);
+    private static readonly Vector<uint> s_singleExponentMask = new(0x7F800000u);
+
+    // 2^112: difference between the float and the half exponent bias
+    private static readonly Vector<float> s_float16ExponentAdjust = Vector.AsVectorSingle(new Vector<uint>(0x77800000u));
+
+    private static void Widen(Vector<ushort> value, HalfPrecisionFormat format, out Vector<float> low, out Vector<float> high)
+    {
+        Vector.Widen(value, out Vector<uint> lowBits, out Vector<uint> highBits);
+        if (format == HalfPrecisionFormat.BFloat16)
+        {
+            low = Vector.AsVectorSingle(lowBits * s_upperHalfMultiplier);
+            high = Vector.AsVectorSingle(highBits * s_upperHalfMultiplier);
+        }
+        else
+        {
+            low = Float16ToSingle(lowBits);
+            high = Float16ToSingle(highBits);
+        }
+    }
+
+    /// <summary>
+    /// Vectorized version of <see cref="Float16.ToSingle"/>.
+    /// </summary>
+    private static Vector<float> Float16ToSingle(Vector<uint> bits)
+    {
+        Vector<uint> expMantissa = bits & s_float16ExpMantissaMask;
+        Vector<float> value = Vector.AsVectorSingle(expMantissa * s_float16ExponentShift) * s_float16ExponentAdjust;
+        Vector<uint> infinityOrNaN = Vector.GreaterThanOrEqual(expMantissa, s_float16InfinityBits) & s_singleExponentMask;
+        Vector<uint> sign = (bits & s_float16SignMask) * s_upperHalfMultiplier;
+
+        return Vector.AsVectorSingle(Vector.AsVectorUInt32(value) | infinityOrNaN | sign);
+    }
+
+    private static float ToSingle(ushort bits, HalfPrecisionFormat format)
+    {
+        return format == HalfPrecisionFormat.BFloat16 ? BFloat16.ToSingle(bits) : Float16.ToSingle(bits);
+    }
+
+    private static ushort FromSingle(float value, HalfPrecisionFormat format)
+    {
+        return format == HalfPrecisionFormat.BFloat16 ? BFloat16.FromSingle(value) : Float16.FromSingle(value);
+    }
+
+    #endregion
+}
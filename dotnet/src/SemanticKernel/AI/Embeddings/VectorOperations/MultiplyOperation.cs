@@ -14,7 +14,7 @@ public static class MultiplyOperation
     /// Multiplies all elements of a vector by the scalar <paramref name="multiplier"/> in-place.
     /// Does not allocate new memory.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The input vector.</param>
     /// <param name="multiplier">The scalar.</param>
     public static void MultiplyByInPlace<TNumber>(this Span<TNumber> vector, double multiplier)
@@ -30,6 +30,11 @@ public static class MultiplyOperation
             Span<double> doubleSpan = MemoryMarshal.Cast<TNumber, double>(vector);
             MultiplyByInPlaceImplementation(doubleSpan, multiplier);
         }
+        else if (HalfPrecisionOperations.GetFormat<TNumber>() != HalfPrecisionFormat.None)
+        {
+            Span<ushort> halfSpan = MemoryMarshal.Cast<TNumber, ushort>(vector);
+            HalfPrecisionOperations.MultiplyByInPlace(halfSpan, HalfPrecisionOperations.GetFormat<TNumber>(), multiplier);
+        }
         else
         {
             SupportedTypes.ThrowTypeNotSupported(typeof(TNumber));
@@ -40,7 +45,7 @@ public static class MultiplyOperation
     /// Multiplies all elements of a vector by the scalar <paramref name="multiplier"/> in-place.
     /// Does not allocate new memory.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The input vector.</param>
     /// <param name="multiplier">The scalar.</param>
     public static void MultiplyByInPlace<TNumber>(this TNumber[] vector, double multiplier)
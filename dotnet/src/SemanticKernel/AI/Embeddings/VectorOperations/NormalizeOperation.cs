@@ -16,7 +16,7 @@ public static class NormalizeOperation
     /// Normalizes a vector in-place by dividing all elements by the scalar Euclidean length.
     /// The resulting length will be 1.0. Does not allocate new memory.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The input vector.</param>
     public static void NormalizeInPlace<TNumber>(this Span<TNumber> vector)
         where TNumber : unmanaged
@@ -28,7 +28,7 @@ public static class NormalizeOperation
     /// Normalizes a vector in-place by dividing all elements by the scalar Euclidean length.
     /// The resulting length will be 1.0. Does not allocate new memory.
     /// </summary>
-    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/> currently supported).</typeparam>
+    /// <typeparam name="TNumber">The unmanaged data type (<see cref="float"/>, <see cref="double"/>, <see cref="Float16"/> and <see cref="BFloat16"/> currently supported).</typeparam>
     /// <param name="vector">The input vector.</param>
     public static void NormalizeInPlace<TNumber>(this TNumber[] vector)
         where TNumber : unmanaged
@@ -0,0 +1,53 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI;
+
+/// <summary>
+/// Interface for text completion clients able to complete multiple prompts with a single request.
+/// </summary>
+public interface ITextBatchCompletionClient : ITextCompletionClient
+{
+    /// <summary>
+    /// Creates a completion for each prompt, using the same settings for all the prompts.
+    /// </summary>
+    /// <param name="texts">The prompts to complete.</param>
+    /// <param name="requestSettings">Request settings for the completion API</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>Texts generated by the remote model, in the same order of the prompts</returns>
+    public Task<IList<string>> CompleteBatchAsync(IList<string> texts, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default);
+}
+
+/// <summary>
+/// Provides a collection of static methods for operating on <see cref="ITextCompletionClient"/> objects.
+/// </summary>
+public static class TextCompletionClientExtensions
+{
+    /// <summary>
+    /// Creates a completion for each prompt, with a single request when the client supports batches,
+    /// otherwise sending one request per prompt, concurrently.
+    /// </summary>
+    /// <param name="client">The completion client.</param>
+    /// <param name="texts">The prompts to complete.</param>
+    /// <param name="requestSettings">Request settings for the completion API</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>Texts generated by the remote model, in the same order of the prompts</returns>
+    public static async Task<IList<string>> CompleteBatchAsync(
+        this ITextCompletionClient client, IList<string> texts, CompleteRequestSettings requestSettings,
+        CancellationToken cancellationToken = default)
+    {
+        Verify.NotNull(client, "Completion client cannot be NULL");
+
+        if (client is ITextBatchCompletionClient batchClient)
+        {
+            return await batchClient.CompleteBatchAsync(texts, requestSettings, cancellationToken);
+        }
+
+        return await Task.WhenAll(texts.Select(text => client.CompleteAsync(text, requestSettings, cancellationToken)));
+    }
+}
@@ -1,5 +1,6 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System.Threading;
 using System.Threading.Tasks;
 
 namespace Microsoft.SemanticKernel.AI;
@@ -14,6 +15,7 @@ public interface ITextCompletionClient
     /// </summary>
     /// <param name="text">The prompt to complete.</param>
     /// <param name="requestSettings">Request settings for the completion API</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>Text generated by the remote model</returns>
-    public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings);
+    public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default);
 }
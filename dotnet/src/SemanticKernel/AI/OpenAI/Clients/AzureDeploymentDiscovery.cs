@@ -0,0 +1,204 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
+
+namespace Microsoft.SemanticKernel.AI.OpenAI.Clients;
+
+/// <summary>
+/// Deployments available on an Azure OpenAI endpoint, shared by all the clients of the endpoint.
+/// The list is fetched once for all the concurrent callers, and refreshed in the background when older
+/// than the time to live, while callers keep using the previous list (stale-while-revalidate).
+/// </summary>
+internal sealed class AzureDeploymentDiscovery
+{
+    /// <summary>
+    /// Immutable list of deployments, replaced as a whole on refresh.
+    /// </summary>
+    internal sealed class Snapshot
+    {
+        internal Snapshot(IDictionary<string, string> deploymentToModel, DateTimeOffset fetchedAt)
+        {
+            this.DeploymentToModel = new Dictionary<string, string>(deploymentToModel, StringComparer.Ordinal);
+            this.ModelToDeployment = new Dictionary<string, string>(StringComparer.Ordinal);
+            foreach (KeyValuePair<string, string> deployment in deploymentToModel)
+            {
+                this.ModelToDeployment[deployment.Value] = deployment.Key;
+            }
+
+            this.FetchedAt = fetchedAt;
+        }
+
+        internal IReadOnlyDictionary<string, string> DeploymentToModel { get; }
+        internal Dictionary<string, string> ModelToDeployment { get; }
+        internal DateTimeOffset FetchedAt { get; }
+
+        /// <summary>
+        /// Find the deployment of a model ID or deployment name.
+        /// </summary>
+        /// <param name="modelId">Model ID or deployment name</param>
+        /// <param name="deploymentName">Name of the deployment found</param>
+        /// <returns>True if the deployment was found</returns>
+        internal bool TryGetDeployment(string modelId, out string deploymentName)
+        {
+            if (this.DeploymentToModel.ContainsKey(modelId))
+            {
+                deploymentName = modelId;
+                return true;
+            }
+
+            return this.ModelToDeployment.TryGetValue(modelId, out deploymentName!);
+        }
+    }
+
+    /// <summary>
+    /// Time after which the deployments are refreshed in the background.
+    /// </summary>
+    internal static readonly TimeSpan TimeToLive = TimeSpan.FromMinutes(5);
+
+    /// <summary>
+    /// Min time between refreshes triggered by a model not found, to avoid fetching the list on each request.
+    /// </summary>
+    internal static readonly TimeSpan MinRefreshInterval = TimeSpan.FromSeconds(30);
+
+    /// <summary>
+    /// Get the discovery of an endpoint, shared by all the clients of the endpoint.
+    /// </summary>
+    /// <param name="endpoint">Azure OpenAI endpoint</param>
+    /// <returns>Deployment discovery of the endpoint</returns>
+    internal static AzureDeploymentDiscovery ForEndpoint(string endpoint)
+    {
+        return s_endpoints.GetOrAdd(endpoint, _ => new AzureDeploymentDiscovery());
+    }
+
+    internal AzureDeploymentDiscovery(Func<DateTimeOffset>? clock = null)
+    {
+        this._clock = clock ?? (() => DateTimeOffset.UtcNow);
+    }
+
+    /// <summary>
+    /// Latest list of deployments, NULL until the first fetch completes.
+    /// </summary>
+    internal Snapshot? Current => this._snapshot;
+
+    /// <summary>
+    /// Get the list of deployments, fetching it if not available yet, and refreshing it in the background when stale.
+    /// </summary>
+    /// <param name="fetch">Function fetching the deployments</param>
+    /// <param name="log">Logger</param>
+    /// <param name="cancel">Cancellation token, to stop waiting for the fetch</param>
+    /// <returns>The list of deployments</returns>
+    internal Task<Snapshot> GetAsync(Func<Task<Snapshot>> fetch, ILogger log, CancellationToken cancel = default)
+    {
+        Snapshot? snapshot = this._snapshot;
+        if (snapshot == null) { return this.RefreshAsync(fetch, cancel); }
+
+        this.RefreshIfStale(fetch, log);
+        return Task.FromResult(snapshot);
+    }
+
+    /// <summary>
+    /// Start a background refresh if the list of deployments is older than the time to live.
+    /// </summary>
+    /// <param name="fetch">Function fetching the deployments</param>
+    /// <param name="log">Logger</param>
+    internal void RefreshIfStale(Func<Task<Snapshot>> fetch, ILogger log)
+    {
+        Snapshot? snapshot = this._snapshot;
+        if (snapshot != null && this._clock() - snapshot.FetchedAt > TimeToLive) { this.RefreshInBackground(fetch, log); }
+    }
+
+    /// <summary>
+    /// Fetch the list of deployments, joining the fetch in progress if any.
+    /// Cancelling stops waiting, while the fetch keeps running for the other callers.
+    /// </summary>
+    /// <param name="fetch">Function fetching the deployments</param>
+    /// <param name="cancel">Cancellation token, to stop waiting for the fetch</param>
+    /// <returns>The new list of deployments</returns>
+    internal Task<Snapshot> RefreshAsync(Func<Task<Snapshot>> fetch, CancellationToken cancel = default)
+    {
+        Task<Snapshot> refresh;
+        lock (this._lock)
+        {
+            refresh = this._refresh ??= this.RunRefreshAsync(fetch);
+        }
+
+        return cancel.CanBeCanceled && !refresh.IsCompleted ? WaitAsync(refresh, cancel) : refresh;
+    }
+
+    /// <summary>
+    /// Whether the list is old enough to be refreshed when a model is not found.
+    /// </summary>
+    /// <param name="snapshot">List of deployments where the model was not found</param>
+    /// <returns>True if a refresh is allowed</returns>
+    internal bool CanRefresh(Snapshot snapshot)
+    {
+        return this._clock() - snapshot.FetchedAt >= MinRefreshInterval;
+    }
+
+    /// <summary>
+    /// Current time, used to timestamp the lists of deployments.
+    /// </summary>
+    internal DateTimeOffset Now => this._clock();
+
+    #region private ================================================================================
+
+    private static readonly ConcurrentDictionary<string, AzureDeploymentDiscovery> s_endpoints = new(StringComparer.OrdinalIgnoreCase);
+
+    private readonly object _lock = new();
+    private readonly Func<DateTimeOffset> _clock;
+    private volatile Snapshot? _snapshot;
+    private Task<Snapshot>? _refresh;
+
+    private async Task<Snapshot> RunRefreshAsync(Func<Task<Snapshot>> fetch)
+    {
+        // Complete asynchronously, so that the task is stored before being cleared
+        await Task.Yield();
+
+        try
+        {
+            Snapshot snapshot = await fetch();
+            this._snapshot = snapshot;
+            return snapshot;
+        }
+        finally
+        {
+            lock (this._lock) { this._refresh = null; }
+        }
+    }
+
+    private static async Task<Snapshot> WaitAsync(Task<Snapshot> refresh, CancellationToken cancel)
+    {
+        var cancelled = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+        using (cancel.Register(() => cancelled.TrySetResult(true)))
+        {
+            if (await Task.WhenAny(refresh, cancelled.Task) != refresh)
+            {
+                // Observe the failure of the fetch, in case no other caller is waiting for it
+                _ = refresh.ContinueWith(task => _ = task.Exception,
+                    CancellationToken.None, TaskContinuationOptions.OnlyOnFaulted, TaskScheduler.Default);
+                cancel.ThrowIfCancellationRequested();
+            }
+        }
+
+        return await refresh;
+    }
+
+    private void RefreshInBackground(Func<Task<Snapshot>> fetch, ILogger log)
+    {
+        lock (this._lock)
+        {
+            if (this._refresh != null) { return; }
+        }
+
+        _ = this.RefreshAsync(fetch).ContinueWith(
+            task => log.LogWarning(task.Exception, "Unable to refresh the list of Azure OpenAI deployments, using the previous list"),
+            CancellationToken.None, TaskContinuationOptions.OnlyOnFaulted, TaskScheduler.Default);
+    }
+
+    #endregion
+}
@@ -1,11 +1,14 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
 using System;
-using System.Collections.Concurrent;
+using System.Collections.Generic;
 using System.Net.Http;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Clients;
@@ -48,7 +51,9 @@ public abstract class AzureOpenAIClientAbstract : OpenAIClientAbstract
     /// Construct an AzureOpenAIClientAbstract object
     /// </summary>
     /// <param name="log">Logger</param>
-    protected AzureOpenAIClientAbstract(ILogger? log = null) : base(log)
+    /// <param name="handlerFactory">Retry handler factory</param>
+    protected AzureOpenAIClientAbstract(ILogger? log = null, IDelegatingHandlerFactory? handlerFactory = null)
+        : base(log, handlerFactory)
     {
     }
 
@@ -56,47 +61,87 @@ public abstract class AzureOpenAIClientAbstract : OpenAIClientAbstract
     /// Returns the deployment name of the model ID
     /// </summary>
     /// <param name="modelId">Azure OpenAI Model ID</param>
+    /// <param name="cancellationToken">Cancellation token, to stop waiting for the list of deployments</param>
     /// <returns>Name of the deployment for the model ID</returns>
     /// <exception cref="AIException">AIException thrown during request.</exception>
-    protected async Task<string> GetDeploymentNameAsync(string modelId)
+    protected async Task<string> GetDeploymentNameAsync(string modelId, CancellationToken cancellationToken = default)
     {
-        string fullModelId = this.Endpoint + ":" + modelId;
+        var discovery = AzureDeploymentDiscovery.ForEndpoint(this.Endpoint);
+        AzureDeploymentDiscovery.Snapshot snapshot = await discovery.GetAsync(this.FetchDeploymentsAsync, this.Log, cancellationToken);
+        if (snapshot.TryGetDeployment(modelId, out string deploymentName)) { return deploymentName; }
 
-        // If the value is a deployment name
-        if (s_deploymentToModel.ContainsKey(fullModelId))
+        // The model might have been deployed after the list was fetched
+        if (discovery.CanRefresh(snapshot))
         {
-            return modelId;
+            snapshot = await discovery.RefreshAsync(this.FetchDeploymentsAsync, cancellationToken);
+            if (snapshot.TryGetDeployment(modelId, out deploymentName)) { return deploymentName; }
         }
 
-        // If the value is a model ID present in the cache
-        if (s_modelToDeployment.TryGetValue(fullModelId, out string modelIdCached))
-        {
-            return modelIdCached;
-        }
+        string modelsAvailable = string.Join(", ", snapshot.ModelToDeployment.Keys);
+        throw new AIException(
+            AIException.ErrorCodes.ModelNotAvailable,
+            $"Model '{modelId}' not available on {this.Endpoint}. " +
+            $"Available models: {modelsAvailable}. Deploy the model and try again.");
+    }
+
+    /// <summary>
+    /// Returns the URL of an operation of the deployment of the model ID, e.g. "completions".
+    /// The URL is computed once per list of deployments, so that requests don't have to build it.
+    /// </summary>
+    /// <param name="modelId">Azure OpenAI Model ID or deployment name</param>
+    /// <param name="operation">Operation, e.g. "completions" or "embeddings"</param>
+    /// <param name="cancellationToken">Cancellation token, to stop waiting for the list of deployments</param>
+    /// <returns>URL of the operation</returns>
+    /// <exception cref="AIException">AIException thrown during request.</exception>
+    protected async Task<DeploymentUrl> GetDeploymentUrlAsync(string modelId, string operation, CancellationToken cancellationToken = default)
+    {
+        var discovery = AzureDeploymentDiscovery.ForEndpoint(this.Endpoint);
 
-        // If the cache has already been warmed up
-        string modelsAvailable;
-        if (s_deploymentsCached.ContainsKey(this.Endpoint))
+        // Fast path: reuse the URL while the list of deployments doesn't change
+        ResolvedUrl? resolved = this._resolvedUrl;
+        AzureDeploymentDiscovery.Snapshot? current = discovery.Current;
+        if (resolved != null && current != null && ReferenceEquals(resolved.Snapshot, current)
+            && resolved.ModelId == modelId && resolved.Operation == operation)
         {
-            modelsAvailable = string.Join(", ", s_modelToDeployment.Keys);
-            throw new AIException(
-                AIException.ErrorCodes.ModelNotAvailable,
-                $"Model '{modelId}' not available on {this.Endpoint}. " +
-                $"Available models: {modelsAvailable}. Deploy the model and restart the application.");
+            discovery.RefreshIfStale(this.FetchDeploymentsAsync, this.Log);
+            return resolved.Url;
         }
 
-        await this.CacheDeploymentsAsync();
+        string deploymentName = await this.GetDeploymentNameAsync(modelId, cancellationToken);
+        var url = new DeploymentUrl(
+            deploymentName,
+            $"{this.Endpoint}/openai/deployments/{deploymentName}/{operation}?api-version={this.AzureOpenAIApiVersion}",
+            RateLimiterRegistry.GetKey(this.Endpoint, deploymentName),
+            RateLimiterRegistry.GetKey(this.Endpoint, modelId));
 
-        if (s_modelToDeployment.TryGetValue(fullModelId, out string modelIdAfterCache))
-        {
-            return modelIdAfterCache;
-        }
+        current = discovery.Current;
+        if (current != null) { this._resolvedUrl = new ResolvedUrl(current, modelId, operation, url); }
 
-        modelsAvailable = string.Join(", ", s_modelToDeployment.Keys);
-        throw new AIException(
-            AIException.ErrorCodes.ModelNotAvailable,
-            $"Model '{modelId}' not available on {this.Endpoint}. " +
-            $"Available models: {modelsAvailable}. Deploy the model and restart the application.");
+        return url;
+    }
+
+    /// <summary>
+    /// Returns the rate limiter shared by the clients of the deployment, if any.
+    /// </summary>
+    /// <param name="deploymentName">Name of the deployment</param>
+    /// <param name="modelId">Model ID or deployment name used to create the client</param>
+    /// <returns>The rate limiter registered for the deployment or for the model ID, NULL if none</returns>
+    protected TokenBucketRateLimiter? GetRateLimiter(string deploymentName, string modelId)
+    {
+        return RateLimiterRegistry.GetLimiter(this.Endpoint, deploymentName)
+               ?? RateLimiterRegistry.GetLimiter(this.Endpoint, modelId);
+    }
+
+    /// <summary>
+    /// Returns the rate limiter shared by the clients of the deployment, if any.
+    /// </summary>
+    /// <param name="url">URL of the deployment</param>
+    /// <returns>The rate limiter registered for the deployment or for the model ID, NULL if none</returns>
+    protected TokenBucketRateLimiter? GetRateLimiter(DeploymentUrl url)
+    {
+        Verify.NotNull(url, "The deployment URL is NULL");
+        return RateLimiterRegistry.GetLimiterByKey(url.RateLimiterKey)
+               ?? RateLimiterRegistry.GetLimiterByKey(url.ModelRateLimiterKey);
     }
 
     /// <summary>
@@ -105,9 +150,64 @@ public abstract class AzureOpenAIClientAbstract : OpenAIClientAbstract
     /// <returns>An async task</returns>
     /// <exception cref="AIException">AIException thrown during the request.</exception>
     protected async Task CacheDeploymentsAsync()
+    {
+        await AzureDeploymentDiscovery.ForEndpoint(this.Endpoint).RefreshAsync(this.FetchDeploymentsAsync);
+    }
+
+    /// <summary>
+    /// URL of an operation of a deployment
+    /// </summary>
+    protected sealed class DeploymentUrl
+    {
+        internal DeploymentUrl(string deploymentName, string url, string rateLimiterKey, string modelRateLimiterKey)
+        {
+            this.DeploymentName = deploymentName;
+            this.Url = url;
+            this.RateLimiterKey = rateLimiterKey;
+            this.ModelRateLimiterKey = modelRateLimiterKey;
+        }
+
+        /// <summary>
+        /// Name of the deployment
+        /// </summary>
+        public string DeploymentName { get; }
+
+        /// <summary>
+        /// URL of the operation
+        /// </summary>
+        public string Url { get; }
+
+        internal string RateLimiterKey { get; }
+        internal string ModelRateLimiterKey { get; }
+    }
+
+    #region private ================================================================================
+
+    private sealed class ResolvedUrl
+    {
+        internal ResolvedUrl(AzureDeploymentDiscovery.Snapshot snapshot, string modelId, string operation, DeploymentUrl url)
+        {
+            this.Snapshot = snapshot;
+            this.ModelId = modelId;
+            this.Operation = operation;
+            this.Url = url;
+        }
+
+        internal AzureDeploymentDiscovery.Snapshot Snapshot { get; }
+        internal string ModelId { get; }
+        internal string Operation { get; }
+        internal DeploymentUrl Url { get; }
+    }
+
+    private string _azureOpenAIApiVersion = DefaultAzureAPIVersion;
+
+    // Last URL resolved by this client, valid until the list of deployments changes
+    private ResolvedUrl? _resolvedUrl;
+
+    private async Task<AzureDeploymentDiscovery.Snapshot> FetchDeploymentsAsync()
     {
         var url = $"{this.Endpoint}/openai/deployments?api-version={this.AzureOpenAIApiVersion}";
-        HttpResponseMessage response = await this.HTTPClient.GetAsync(url);
+        using HttpResponseMessage response = await this.HTTPClient.GetAsync(url);
         if (!response.IsSuccessStatusCode)
         {
             throw new AIException(
@@ -117,49 +217,37 @@ public abstract class AzureOpenAIClientAbstract : OpenAIClientAbstract
 
         string json = await response.Content.ReadAsStringAsync();
 
-        lock (s_deploymentToModel)
+        try
         {
-            try
+            var data = Json.Deserialize<AzureDeployments>(json);
+            if (data == null)
             {
-                var data = Json.Deserialize<AzureDeployments>(json);
-                if (data == null)
-                {
-                    throw new AIException(
-                        AIException.ErrorCodes.InvalidResponseContent,
-                        "Model not available. Unable to fetch the list of models.");
-                }
+                throw new AIException(
+                    AIException.ErrorCodes.InvalidResponseContent,
+                    "Model not available. Unable to fetch the list of models.");
+            }
 
-                foreach (var deployment in data.Deployments)
+            var deploymentToModel = new Dictionary<string, string>();
+            foreach (var deployment in data.Deployments)
+            {
+                if (!deployment.IsAvailableDeployment() || string.IsNullOrEmpty(deployment.ModelName) ||
+                    string.IsNullOrEmpty(deployment.DeploymentName))
                 {
-                    if (!deployment.IsAvailableDeployment() || string.IsNullOrEmpty(deployment.ModelName) ||
-                        string.IsNullOrEmpty(deployment.DeploymentName))
-                    {
-                        continue;
-                    }
-
-                    s_deploymentToModel[this.Endpoint + ":" + deployment.DeploymentName] = deployment.ModelName;
-                    s_modelToDeployment[this.Endpoint + ":" + deployment.ModelName] = deployment.DeploymentName;
+                    continue;
                 }
+
+                deploymentToModel[deployment.DeploymentName] = deployment.ModelName;
             }
-            catch (Exception e) when (e is not AIException)
-            {
-                throw new AIException(
-                    AIException.ErrorCodes.UnknownError,
-                    "Model not available. Unable to fetch the list of models.", e);
-            }
-        }
 
-        s_deploymentsCached[this.Endpoint] = true;
+            return new AzureDeploymentDiscovery.Snapshot(deploymentToModel, AzureDeploymentDiscovery.ForEndpoint(this.Endpoint).Now);
+        }
+        catch (Exception e) when (e is not AIException)
+        {
+            throw new AIException(
+                AIException.ErrorCodes.UnknownError,
+                "Model not available. Unable to fetch the list of models.", e);
+        }
     }
 
-    #region private ================================================================================
-
-    // Caching Azure details across multiple instances so we don't have to use "deployment names"
-    private static readonly ConcurrentDictionary<string, bool> s_deploymentsCached = new();
-    private static readonly ConcurrentDictionary<string, string> s_deploymentToModel = new();
-    private static readonly ConcurrentDictionary<string, string> s_modelToDeployment = new();
-
-    private string _azureOpenAIApiVersion = DefaultAzureAPIVersion;
-
     #endregion
 }
@@ -5,13 +5,17 @@ using System.Collections.Generic;
 using System.Linq;
 using System.Net;
 using System.Net.Http;
+using System.Net.Http.Headers;
 using System.Net.Mime;
+using System.Security.Cryptography;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.Extensions.Logging.Abstractions;
 using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Clients;
@@ -33,14 +37,30 @@ public abstract class OpenAIClientAbstract : IDisposable
     protected HttpClient HTTPClient { get; }
 
     private readonly HttpClientHandler _httpClientHandler;
+    private readonly ConcurrencyLimitingHandler _limitingHandler;
+    private readonly DelegatingHandler? _retryHandler;
 
-    internal OpenAIClientAbstract(ILogger? log = null)
+    internal OpenAIClientAbstract(ILogger? log = null, IDelegatingHandlerFactory? handlerFactory = null)
     {
         if (log != null) { this.Log = log; }
 
-        // TODO: allow injection of retry logic, e.g. Polly
         this._httpClientHandler = new() { CheckCertificateRevocationList = true };
-        this.HTTPClient = new HttpClient(this._httpClientHandler);
+
+        // The concurrency limit applies to each attempt, so it runs inside the retry and hedging handlers
+        this._limitingHandler = new ConcurrencyLimitingHandler { InnerHandler = this._httpClientHandler };
+
+        // Retry logic runs inside the HTTP client, so only the failed HTTP call is repeated
+        if (handlerFactory != null)
+        {
+            this._retryHandler = handlerFactory.Create(this.Log);
+            this._retryHandler.GetInnermostHandler().InnerHandler = this._limitingHandler;
+            this.HTTPClient = new HttpClient(this._retryHandler);
+        }
+        else
+        {
+            this.HTTPClient = new HttpClient(this._limitingHandler);
+        }
+
         this.HTTPClient.DefaultRequestHeaders.Add("User-Agent", HTTPUseragent);
     }
 
@@ -49,25 +69,73 @@ public abstract class OpenAIClientAbstract : IDisposable
     /// </summary>
     /// <param name="url">URL for the completion request API</param>
     /// <param name="requestBody">Prompt to complete</param>
+    /// <param name="rateLimiter">Optional rate limiter of the deployment</param>
+    /// <param name="estimatedTokens">Estimated tokens used by the request, charged to the rate limiter</param>
+    /// <param name="deduplicate">Whether concurrent identical requests can share the same response</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>The completed text</returns>
     /// <exception cref="AIException">AIException thrown during the request.</exception>
-    protected async Task<string> ExecuteCompleteRequestAsync(string url, string requestBody)
+    /// <exception cref="OperationCanceledException">The request has been cancelled by the caller.</exception>
+    protected async Task<string> ExecuteCompleteRequestAsync(string url, string requestBody,
+        TokenBucketRateLimiter? rateLimiter = null, int estimatedTokens = 0, bool deduplicate = false,
+        CancellationToken cancellationToken = default)
     {
         try
         {
             this.Log.LogDebug("Sending completion request to {0}: {1}", url, requestBody);
 
-            var result = await this.ExecutePostRequestAsync<CompletionResponse>(url, requestBody);
-            if (result.Completions.Count < 1)
+            if (!deduplicate) { return await this.SendCompleteRequestAsync(url, requestBody, rateLimiter, estimatedTokens, cancellationToken); }
+
+            return await s_completionRequests.RunAsync(this.GetRequestKey(url, requestBody),
+                ct => this.SendCompleteRequestAsync(url, requestBody, rateLimiter, estimatedTokens, ct), cancellationToken);
+        }
+        catch (Exception e) when (e is not AIException && !IsCancellation(e, cancellationToken))
+        {
+            throw new AIException(
+                AIException.ErrorCodes.UnknownError,
+                $"Something went wrong: {e.Message}", e);
+        }
+    }
+
+    /// <summary>
+    /// Asynchronously sends a completion request for multiple prompts
+    /// </summary>
+    /// <param name="url">URL for the completion request API</param>
+    /// <param name="requestBody">Prompts to complete</param>
+    /// <param name="count">Number of prompts in the request</param>
+    /// <param name="rateLimiter">Optional rate limiter of the deployment</param>
+    /// <param name="estimatedTokens">Estimated tokens used by the request, charged to the rate limiter</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>The completed texts, in the same order of the prompts</returns>
+    /// <exception cref="AIException">AIException thrown during the request.</exception>
+    /// <exception cref="OperationCanceledException">The request has been cancelled by the caller.</exception>
+    protected async Task<IList<string>> ExecuteCompleteBatchRequestAsync(string url, string requestBody, int count,
+        TokenBucketRateLimiter? rateLimiter = null, int estimatedTokens = 0, CancellationToken cancellationToken = default)
+    {
+        try
+        {
+            this.Log.LogDebug("Sending completion request for {0} prompts to {1}", count, url);
+
+            var result = await this.ExecuteRateLimitedPostRequestAsync<CompletionResponse>(
+                url, requestBody, rateLimiter, estimatedTokens, x => x.Usage, cancellationToken);
+
+            // One choice per prompt, the index of the choice is the index of the prompt
+            var completions = new string?[count];
+            foreach (CompletionResponse.Choice choice in result.Completions)
+            {
+                if (choice.Index >= 0 && choice.Index < count) { completions[choice.Index] = choice.Text; }
+            }
+
+            if (completions.Any(x => x == null))
             {
                 throw new AIException(
                     AIException.ErrorCodes.InvalidResponseContent,
-                    "Completions not found");
+                    $"Completions not found, expected {count} completions, received {result.Completions.Count}");
             }
 
-            return result.Completions.First().Text;
+            return completions!;
         }
-        catch (Exception e) when (e is not AIException)
+        catch (Exception e) when (e is not AIException && !IsCancellation(e, cancellationToken))
         {
             throw new AIException(
                 AIException.ErrorCodes.UnknownError,
@@ -80,23 +148,27 @@ public abstract class OpenAIClientAbstract : IDisposable
     /// </summary>
     /// <param name="url"></param>
     /// <param name="requestBody"></param>
+    /// <param name="rateLimiter">Optional rate limiter of the deployment</param>
+    /// <param name="estimatedTokens">Estimated tokens used by the request, charged to the rate limiter</param>
+    /// <param name="deduplicate">Whether concurrent identical requests can share the same response</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns></returns>
     /// <exception cref="AIException"></exception>
-    protected async Task<IList<Embedding<float>>> ExecuteEmbeddingRequestAsync(string url, string requestBody)
+    /// <exception cref="OperationCanceledException">The request has been cancelled by the caller.</exception>
+    protected async Task<IList<Embedding<float>>> ExecuteEmbeddingRequestAsync(string url, string requestBody,
+        TokenBucketRateLimiter? rateLimiter = null, int estimatedTokens = 0, bool deduplicate = false,
+        CancellationToken cancellationToken = default)
     {
         try
         {
-            var result = await this.ExecutePostRequestAsync<EmbeddingResponse>(url, requestBody);
-            if (result.Embeddings.Count < 1)
-            {
-                throw new AIException(
-                    AIException.ErrorCodes.InvalidResponseContent,
-                    "Embeddings not found");
-            }
+            if (!deduplicate) { return await this.SendEmbeddingRequestAsync(url, requestBody, rateLimiter, estimatedTokens, cancellationToken); }
 
-            return result.Embeddings.Select(e => new Embedding<float>(e.Values.ToArray())).ToList();
+            // Each caller gets its own list, the embeddings are not modified by the callers
+            IList<Embedding<float>> result = await s_embeddingRequests.RunAsync(this.GetRequestKey(url, requestBody),
+                ct => this.SendEmbeddingRequestAsync(url, requestBody, rateLimiter, estimatedTokens, ct), cancellationToken);
+            return result.ToList();
         }
-        catch (Exception e) when (e is not AIException)
+        catch (Exception e) when (e is not AIException && !IsCancellation(e, cancellationToken))
         {
             throw new AIException(
                 AIException.ErrorCodes.UnknownError,
@@ -123,6 +195,8 @@ public abstract class OpenAIClientAbstract : IDisposable
         if (disposing)
         {
             this.HTTPClient.Dispose();
+            this._retryHandler?.Dispose();
+            this._limitingHandler.Dispose();
             this._httpClientHandler.Dispose();
         }
     }
@@ -132,23 +206,106 @@ public abstract class OpenAIClientAbstract : IDisposable
     // HTTP user agent sent to remote endpoints
     private const string HTTPUseragent = "Microsoft Semantic Kernel";
 
-    private async Task<T> ExecutePostRequestAsync<T>(string url, string requestBody)
+    // Requests in flight, shared by all the clients, so that identical requests sent by different
+    // components, e.g. a semantic function and the semantic memory, share the same response
+    private static readonly SingleFlight<string> s_completionRequests = new();
+    private static readonly SingleFlight<IList<Embedding<float>>> s_embeddingRequests = new();
+
+    // Headers identifying the caller, included in the key of the requests in flight
+    private static readonly string[] s_credentialHeaders = { "api-key", "Authorization", "OpenAI-Organization" };
+
+    private string? _credentialsHash;
+
+    private async Task<string> SendCompleteRequestAsync(
+        string url, string requestBody, TokenBucketRateLimiter? rateLimiter, int estimatedTokens, CancellationToken cancellationToken)
     {
-        string responseJson;
+        var result = await this.ExecuteRateLimitedPostRequestAsync<CompletionResponse>(
+            url, requestBody, rateLimiter, estimatedTokens, x => x.Usage, cancellationToken);
+        if (result.Completions.Count < 1)
+        {
+            throw new AIException(
+                AIException.ErrorCodes.InvalidResponseContent,
+                "Completions not found");
+        }
 
-        try
+        return result.Completions.First().Text;
+    }
+
+    private async Task<IList<Embedding<float>>> SendEmbeddingRequestAsync(
+        string url, string requestBody, TokenBucketRateLimiter? rateLimiter, int estimatedTokens, CancellationToken cancellationToken)
+    {
+        var result = await this.ExecuteRateLimitedPostRequestAsync<EmbeddingResponse>(
+            url, requestBody, rateLimiter, estimatedTokens, x => x.Usage, cancellationToken);
+        if (result.Embeddings.Count < 1)
         {
-            using HttpContent content = new StringContent(requestBody, Encoding.UTF8, MediaTypeNames.Application.Json);
-            HttpResponseMessage response = await this.HTTPClient.PostAsync(url, content);
+            throw new AIException(
+                AIException.ErrorCodes.InvalidResponseContent,
+                "Embeddings not found");
+        }
+
+        return result.Embeddings.Select(e => new Embedding<float>(e.Values.ToArray())).ToList();
+    }
+
+    /// <summary>
+    /// Key identifying identical requests: same endpoint, same credentials and same body.
+    /// Credentials are part of the key, so that clients never receive responses they are not authorized to get.
+    /// </summary>
+    private string GetRequestKey(string url, string requestBody)
+    {
+        // The credentials are set by the concrete clients after this class is constructed, and don't change later
+        this._credentialsHash ??= ComputeCredentialsHash(this.HTTPClient.DefaultRequestHeaders);
+        return string.Concat(url, "\n", this._credentialsHash, "\n", requestBody);
+    }
 
-            if (response == null)
+    private static string ComputeCredentialsHash(HttpRequestHeaders headers)
+    {
+        var credentials = new StringBuilder();
+        foreach (string name in s_credentialHeaders)
+        {
+            if (headers.TryGetValues(name, out IEnumerable<string>? values))
             {
-                throw new AIException(AIException.ErrorCodes.NoResponse, "Empty response");
+                credentials.Append(name).Append(':').AppendJoin(",", values).Append('\n');
             }
+        }
+
+        using var sha = SHA256.Create();
+        return Convert.ToBase64String(sha.ComputeHash(Encoding.UTF8.GetBytes(credentials.ToString())));
+    }
+
+    /// <summary>
+    /// Whether the exception is the caller cancelling the request, as opposed to HTTP client timeouts,
+    /// which are reported as errors.
+    /// </summary>
+    private static bool IsCancellation(Exception e, CancellationToken cancellationToken)
+    {
+        return e is OperationCanceledException && cancellationToken.IsCancellationRequested;
+    }
 
-            this.Log.LogTrace("HTTP response: {0} {1}", (int)response.StatusCode, response.StatusCode.ToString("G"));
+    private async Task<T> ExecuteRateLimitedPostRequestAsync<T>(string url, string requestBody,
+        TokenBucketRateLimiter? rateLimiter, int estimatedTokens, Func<T, TokenUsage?> getUsage, CancellationToken cancellationToken)
+    {
+        if (rateLimiter == null) { return await this.ExecutePostRequestAsync<T>(url, requestBody, null, cancellationToken); }
+
+        await rateLimiter.AcquireAsync(estimatedTokens, cancellationToken);
+        T result = await this.ExecutePostRequestAsync<T>(
+            url, requestBody, new TokenBucketRateLimiter.Charge(rateLimiter, estimatedTokens), cancellationToken);
+
+        // Failed requests keep the estimated charge, which slows down the next requests
+        TokenUsage? usage = getUsage(result);
+        if (usage != null) { rateLimiter.Reconcile(estimatedTokens, usage.TotalTokens); }
 
-            responseJson = await response.Content.ReadAsStringAsync();
+        return result;
+    }
+
+    private async Task<T> ExecutePostRequestAsync<T>(
+        string url, string requestBody, TokenBucketRateLimiter.Charge? charge, CancellationToken cancellationToken)
+    {
+        string responseJson;
+
+        try
+        {
+            HttpResponseMessage response;
+            (response, responseJson) = await this.SendPostRequestAsync(url, requestBody, charge, cancellationToken);
             if (!response.IsSuccessStatusCode)
             {
                 switch (response.StatusCode)
@@ -214,7 +371,7 @@ public abstract class OpenAIClientAbstract : IDisposable
                 }
             }
         }
-        catch (Exception e) when (e is not AIException)
+        catch (Exception e) when (e is not AIException && !IsCancellation(e, cancellationToken))
         {
             throw new AIException(
                 AIException.ErrorCodes.UnknownError,
@@ -238,6 +395,30 @@ public abstract class OpenAIClientAbstract : IDisposable
         }
     }
 
+    private async Task<(HttpResponseMessage Response, string Content)> SendPostRequestAsync(
+        string url, string requestBody, TokenBucketRateLimiter.Charge? charge, CancellationToken cancellationToken)
+    {
+        using var request = new HttpRequestMessage(HttpMethod.Post, url)
+        {
+            Content = new StringContent(requestBody, Encoding.UTF8, MediaTypeNames.Application.Json)
+        };
+
+        // Hedged duplicates of the request are charged to the same rate limiter
+        if (charge != null) { request.Properties[TokenBucketRateLimiter.ChargeProperty] = charge; }
+
+        HttpResponseMessage response = await this.HTTPClient.SendAsync(request, cancellationToken);
+
+        if (response == null)
+        {
+            throw new AIException(AIException.ErrorCodes.NoResponse, "Empty response");
+        }
+
+        this.Log.LogTrace("HTTP response: {0} {1}", (int)response.StatusCode, response.StatusCode.ToString("G"));
+
+        string responseJson = await response.Content.ReadAsStringAsync();
+        return (response, responseJson);
+    }
+
     /// <summary>
     /// C# finalizer
     /// </summary>
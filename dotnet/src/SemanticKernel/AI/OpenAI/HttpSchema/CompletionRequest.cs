@@ -90,10 +90,11 @@ public abstract class CompletionRequest
 
     /// <summary>
     /// The prompt(s) to generate completions for, encoded as a string, array of strings, array of tokens, or array of token arrays
+    /// Type: string or array of strings
     /// </summary>
     [JsonPropertyName("prompt")]
     [JsonPropertyOrder(100)]
-    public string Prompt { get; set; } = string.Empty;
+    public object Prompt { get; set; } = string.Empty;
 }
 
 /// <summary>
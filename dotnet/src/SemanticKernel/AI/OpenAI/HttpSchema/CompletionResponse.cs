@@ -33,4 +33,10 @@ public sealed class CompletionResponse
     /// </summary>
     [JsonPropertyName("choices")]
     public IList<Choice> Completions { get; set; } = new List<Choice>();
+
+    /// <summary>
+    /// Tokens used by the request, when provided by the backend.
+    /// </summary>
+    [JsonPropertyName("usage")]
+    public TokenUsage? Usage { get; set; }
 }
@@ -33,4 +33,10 @@ public sealed class EmbeddingResponse
     /// </summary>
     [JsonPropertyName("data")]
     public IList<EmbeddingResponseIndex> Embeddings { get; set; } = new List<EmbeddingResponseIndex>();
+
+    /// <summary>
+    /// Tokens used by the request, when provided by the backend.
+    /// </summary>
+    [JsonPropertyName("usage")]
+    public TokenUsage? Usage { get; set; }
 }
@@ -0,0 +1,29 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Text.Json.Serialization;
+
+namespace Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+
+/// <summary>
+/// Tokens used by a request
+/// </summary>
+public sealed class TokenUsage
+{
+    /// <summary>
+    /// Number of tokens in the prompt.
+    /// </summary>
+    [JsonPropertyName("prompt_tokens")]
+    public int PromptTokens { get; set; }
+
+    /// <summary>
+    /// Number of tokens generated, not available for embedding requests.
+    /// </summary>
+    [JsonPropertyName("completion_tokens")]
+    public int CompletionTokens { get; set; }
+
+    /// <summary>
+    /// Total number of tokens used by the request.
+    /// </summary>
+    [JsonPropertyName("total_tokens")]
+    public int TotalTokens { get; set; }
+}
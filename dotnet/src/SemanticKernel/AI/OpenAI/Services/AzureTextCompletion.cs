@@ -1,10 +1,16 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI.OpenAI.Clients;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
@@ -12,7 +18,7 @@ namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
 /// <summary>
 /// Azure OpenAI text completion client.
 /// </summary>
-public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextCompletionClient
+public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextBatchCompletionClient
 {
     /// <summary>
     /// Creates a new AzureTextCompletion client instance
@@ -22,11 +28,15 @@ public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextComple
     /// <param name="apiKey">Azure OpenAI API key, see https://learn.microsoft.com/azure/cognitive-services/openai/quickstart</param>
     /// <param name="apiVersion">Azure OpenAI API version, see https://learn.microsoft.com/azure/cognitive-services/openai/reference</param>
     /// <param name="log">Application logger</param>
-    public AzureTextCompletion(string modelId, string endpoint, string apiKey, string apiVersion, ILogger? log = null)
-        : base(log)
+    /// <param name="handlerFactory">Retry handler factory</param>
+    /// <param name="tokenizer">Optional tokenizer, used to reject requests not fitting in the model context window without sending them</param>
+    public AzureTextCompletion(string modelId, string endpoint, string apiKey, string apiVersion, ILogger? log = null,
+        IDelegatingHandlerFactory? handlerFactory = null, ITokenizer? tokenizer = null)
+        : base(log, handlerFactory)
     {
         Verify.NotEmpty(modelId, "The ID cannot be empty, you must provide a Model ID or a Deployment name.");
         this._modelId = modelId;
+        this._tokenizer = tokenizer;
 
         Verify.NotEmpty(endpoint, "The Azure endpoint cannot be empty");
         Verify.StartsWith(endpoint, "https://", "The Azure OpenAI endpoint must start with 'https://'");
@@ -43,17 +53,65 @@ public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextComple
     /// </summary>
     /// <param name="text">Text to complete</param>
     /// <param name="requestSettings">Request settings for the completion API</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>The completed text.</returns>
     /// <exception cref="AIException">AIException thrown during the request</exception>
-    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings)
+    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
     {
         Verify.NotNull(requestSettings, "Completion settings cannot be empty");
 
-        var deploymentName = await this.GetDeploymentNameAsync(this._modelId);
-        var url = $"{this.Endpoint}/openai/deployments/{deploymentName}/completions?api-version={this.AzureOpenAIApiVersion}";
+        var deploymentUrl = await this.GetDeploymentUrlAsync(this._modelId, "completions", cancellationToken);
+        var url = deploymentUrl.Url;
 
         this.Log.LogDebug("Sending Azure OpenAI completion request to {0}", url);
 
+        this._tokenizer?.ValidateCompletionRequest(text, requestSettings, this._modelId);
+        var requestBody = CreateRequestBody(text, requestSettings);
+        var rateLimiter = this.GetRateLimiter(deploymentUrl);
+        int estimatedTokens = rateLimiter == null ? 0 : HeuristicTokenizer.CountTokens(text.AsSpan()) + requestSettings.MaxTokens;
+
+        // Identical deterministic requests in flight share the same response
+        return await this.ExecuteCompleteRequestAsync(url, requestBody, rateLimiter, estimatedTokens,
+            deduplicate: requestSettings.Temperature <= 0, cancellationToken: cancellationToken);
+    }
+
+    /// <summary>
+    /// Creates a completion for each prompt, sending all the prompts in a single request.
+    /// </summary>
+    /// <param name="texts">The prompts to complete.</param>
+    /// <param name="requestSettings">Request settings for the completion API, used for all the prompts</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>The completed texts, in the same order of the prompts</returns>
+    /// <exception cref="AIException">AIException thrown during the request</exception>
+    public async Task<IList<string>> CompleteBatchAsync(
+        IList<string> texts, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        Verify.NotNull(texts, "The prompts cannot be NULL");
+        if (texts.Count == 0) { return Array.Empty<string>(); }
+
+        Verify.NotNull(requestSettings, "Completion settings cannot be empty");
+
+        var deploymentUrl = await this.GetDeploymentUrlAsync(this._modelId, "completions", cancellationToken);
+        var url = deploymentUrl.Url;
+
+        this.Log.LogDebug("Sending Azure OpenAI completion request to {0}", url);
+
+        foreach (string text in texts) { this._tokenizer?.ValidateCompletionRequest(text, requestSettings, this._modelId); }
+
+        var requestBody = CreateRequestBody(texts, requestSettings);
+        var rateLimiter = this.GetRateLimiter(deploymentUrl);
+        int estimatedTokens = rateLimiter == null ? 0 : texts.Sum(x => HeuristicTokenizer.CountTokens(x.AsSpan()) + requestSettings.MaxTokens);
+
+        return await this.ExecuteCompleteBatchRequestAsync(url, requestBody, texts.Count, rateLimiter, estimatedTokens, cancellationToken);
+    }
+
+    #region private ================================================================================
+
+    private readonly string _modelId;
+    private readonly ITokenizer? _tokenizer;
+
+    private static string CreateRequestBody(object prompt, CompleteRequestSettings requestSettings)
+    {
         if (requestSettings.MaxTokens < 1)
         {
             throw new AIException(
@@ -61,9 +119,9 @@ public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextComple
                 $"MaxTokens {requestSettings.MaxTokens} is not valid, the value must be greater than zero");
         }
 
-        var requestBody = Json.Serialize(new AzureCompletionRequest
+        return Json.Serialize(new AzureCompletionRequest
         {
-            Prompt = text,
+            Prompt = prompt,
             Temperature = requestSettings.Temperature,
             TopP = requestSettings.TopP,
             PresencePenalty = requestSettings.PresencePenalty,
@@ -71,13 +129,7 @@ public sealed class AzureTextCompletion : AzureOpenAIClientAbstract, ITextComple
             MaxTokens = requestSettings.MaxTokens,
             Stop = requestSettings.StopSequences is { Count: > 0 } ? requestSettings.StopSequences : null,
         });
-
-        return await this.ExecuteCompleteRequestAsync(url, requestBody);
     }
 
-    #region private ================================================================================
-
-    private readonly string _modelId;
-
     #endregion
 }
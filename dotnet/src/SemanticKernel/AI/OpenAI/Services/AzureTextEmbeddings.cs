@@ -1,12 +1,16 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
 using System.Collections.Generic;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.AI.OpenAI.Clients;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
@@ -26,8 +30,10 @@ public sealed class AzureTextEmbeddings : AzureOpenAIClientAbstract, IEmbeddingG
     /// <param name="apiKey">Azure OpenAI API key, see https://learn.microsoft.com/azure/cognitive-services/openai/quickstart</param>
     /// <param name="apiVersion">Azure OpenAI API version, see https://learn.microsoft.com/azure/cognitive-services/openai/reference</param>
     /// <param name="log">Application logger</param>
-    public AzureTextEmbeddings(string modelId, string endpoint, string apiKey, string apiVersion, ILogger? log = null)
-        : base(log)
+    /// <param name="handlerFactory">Retry handler factory</param>
+    public AzureTextEmbeddings(string modelId, string endpoint, string apiKey, string apiVersion, ILogger? log = null,
+        IDelegatingHandlerFactory? handlerFactory = null)
+        : base(log, handlerFactory)
     {
         Verify.NotEmpty(modelId, "The ID cannot be empty, you must provide a Model ID or a Deployment name.");
         this._modelId = modelId;
@@ -43,17 +49,20 @@ public sealed class AzureTextEmbeddings : AzureOpenAIClientAbstract, IEmbeddingG
     }
 
     /// <inheritdoc/>
-    public async Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data)
+    public async Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data, CancellationToken cancellationToken = default)
     {
-        var deploymentName = await this.GetDeploymentNameAsync(this._modelId);
-        var url = $"{this.Endpoint}/openai/deployments/{deploymentName}/embeddings?api-version={this.AzureOpenAIApiVersion}";
+        var deploymentUrl = await this.GetDeploymentUrlAsync(this._modelId, "embeddings", cancellationToken);
+        var url = deploymentUrl.Url;
 
+        var rateLimiter = this.GetRateLimiter(deploymentUrl);
         var embeddings = new List<Embedding<float>>(data.Count);
 
         for (int i = 0; i < data.Count; i++)
         {
             var requestBody = Json.Serialize(new AzureEmbeddingRequest { Input = new List<string> { data[i] } });
-            embeddings.AddRange(await this.ExecuteEmbeddingRequestAsync(url, requestBody));
+            int estimatedTokens = rateLimiter == null ? 0 : HeuristicTokenizer.CountTokens(data[i].AsSpan());
+            embeddings.AddRange(await this.ExecuteEmbeddingRequestAsync(url, requestBody, rateLimiter, estimatedTokens, deduplicate: true,
+                cancellationToken: cancellationToken));
         }
 
         return embeddings;
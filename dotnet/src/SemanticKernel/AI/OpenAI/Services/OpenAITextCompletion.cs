@@ -1,11 +1,16 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
+using System.Collections.Generic;
 using System.Net.Http.Headers;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI.OpenAI.Clients;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
@@ -13,12 +18,13 @@ namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
 /// <summary>
 /// OpenAI text completion service.
 /// </summary>
-public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextCompletionClient
+public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextBatchCompletionClient
 {
     // 3P OpenAI REST API endpoint
     private const string OpenaiEndpoint = "https://api.openai.com/v1";
 
     private readonly string _modelId;
+    private readonly ITokenizer? _tokenizer;
 
     /// <summary>
     /// Creates a new OpenAITextCompletion with supplied values.
@@ -27,11 +33,15 @@ public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextCompletion
     /// <param name="apiKey">OpenAI API key, see https://platform.openai.com/account/api-keys</param>
     /// <param name="organization">OpenAI organization id. This is usually optional unless your account belongs to multiple organizations.</param>
     /// <param name="log">Logger</param>
-    public OpenAITextCompletion(string modelId, string apiKey, string? organization = null, ILogger? log = null) :
-        base(log)
+    /// <param name="handlerFactory">Retry handler factory</param>
+    /// <param name="tokenizer">Optional tokenizer, used to reject requests not fitting in the model context window without sending them</param>
+    public OpenAITextCompletion(string modelId, string apiKey, string? organization = null, ILogger? log = null,
+        IDelegatingHandlerFactory? handlerFactory = null, ITokenizer? tokenizer = null) :
+        base(log, handlerFactory)
     {
         Verify.NotEmpty(modelId, "The OpenAI model ID cannot be empty");
         this._modelId = modelId;
+        this._tokenizer = tokenizer;
 
         Verify.NotEmpty(apiKey, "The OpenAI API key cannot be empty");
         this.HTTPClient.DefaultRequestHeaders.Authorization = new AuthenticationHeaderValue("Bearer", apiKey);
@@ -47,15 +57,54 @@ public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextCompletion
     /// </summary>
     /// <param name="text">The prompt to complete.</param>
     /// <param name="requestSettings">Request settings for the completion API</param>
+    /// <param name="cancellationToken">Cancellation token</param>
     /// <returns>The completed text</returns>
     /// <exception cref="AIException">AIException thrown during the request</exception>
-    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings)
+    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
     {
         Verify.NotNull(requestSettings, "Completion settings cannot be empty");
 
         var url = $"{OpenaiEndpoint}/engines/{this._modelId}/completions";
         this.Log.LogDebug("Sending OpenAI completion request to {0}", url);
 
+        this._tokenizer?.ValidateCompletionRequest(text, requestSettings, this._modelId);
+        var requestBody = CreateRequestBody(text, requestSettings);
+
+        // Identical deterministic requests in flight share the same response
+        return await this.ExecuteCompleteRequestAsync(url, requestBody,
+            deduplicate: requestSettings.Temperature <= 0, cancellationToken: cancellationToken);
+    }
+
+    /// <summary>
+    /// Creates a completion for each prompt, sending all the prompts in a single request.
+    /// </summary>
+    /// <param name="texts">The prompts to complete.</param>
+    /// <param name="requestSettings">Request settings for the completion API, used for all the prompts</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>The completed texts, in the same order of the prompts</returns>
+    /// <exception cref="AIException">AIException thrown during the request</exception>
+    public async Task<IList<string>> CompleteBatchAsync(
+        IList<string> texts, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        Verify.NotNull(texts, "The prompts cannot be NULL");
+        if (texts.Count == 0) { return Array.Empty<string>(); }
+
+        Verify.NotNull(requestSettings, "Completion settings cannot be empty");
+
+        var url = $"{OpenaiEndpoint}/engines/{this._modelId}/completions";
+        this.Log.LogDebug("Sending OpenAI completion request to {0}", url);
+
+        foreach (string text in texts) { this._tokenizer?.ValidateCompletionRequest(text, requestSettings, this._modelId); }
+
+        var requestBody = CreateRequestBody(texts, requestSettings);
+
+        return await this.ExecuteCompleteBatchRequestAsync(url, requestBody, texts.Count, cancellationToken: cancellationToken);
+    }
+
+    #region private ================================================================================
+
+    private static string CreateRequestBody(object prompt, CompleteRequestSettings requestSettings)
+    {
         if (requestSettings.MaxTokens < 1)
         {
             throw new AIException(
@@ -63,9 +112,9 @@ public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextCompletion
                 $"MaxTokens {requestSettings.MaxTokens} is not valid, the value must be greater than zero");
         }
 
-        var requestBody = Json.Serialize(new OpenAICompletionRequest
+        return Json.Serialize(new OpenAICompletionRequest
         {
-            Prompt = text,
+            Prompt = prompt,
             Temperature = requestSettings.Temperature,
             TopP = requestSettings.TopP,
             PresencePenalty = requestSettings.PresencePenalty,
@@ -73,7 +122,7 @@ public sealed class OpenAITextCompletion : OpenAIClientAbstract, ITextCompletion
             MaxTokens = requestSettings.MaxTokens,
             Stop = requestSettings.StopSequences is { Count: > 0 } ? requestSettings.StopSequences : null,
         });
-
-        return await this.ExecuteCompleteRequestAsync(url, requestBody);
     }
+
+    #endregion
 }
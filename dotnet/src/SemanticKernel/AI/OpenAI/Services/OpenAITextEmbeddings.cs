@@ -2,12 +2,14 @@
 
 using System.Collections.Generic;
 using System.Net.Http.Headers;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.AI.OpenAI.Clients;
 using Microsoft.SemanticKernel.AI.OpenAI.HttpSchema;
 using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Reliability;
 using Microsoft.SemanticKernel.Text;
 
 namespace Microsoft.SemanticKernel.AI.OpenAI.Services;
@@ -30,8 +32,10 @@ public sealed class OpenAITextEmbeddings : OpenAIClientAbstract, IEmbeddingGener
     /// <param name="apiKey">OpenAI API Key</param>
     /// <param name="organization">Optional OpenAI organization ID, usually required only if your account belongs to multiple organizations</param>
     /// <param name="log">Application logger</param>
-    public OpenAITextEmbeddings(string modelId, string apiKey, string? organization = null, ILogger? log = null)
-        : base(log)
+    /// <param name="handlerFactory">Retry handler factory</param>
+    public OpenAITextEmbeddings(string modelId, string apiKey, string? organization = null, ILogger? log = null,
+        IDelegatingHandlerFactory? handlerFactory = null)
+        : base(log, handlerFactory)
     {
         Verify.NotEmpty(modelId, "The OpenAI model ID cannot be empty");
         this._modelId = modelId;
@@ -46,10 +50,10 @@ public sealed class OpenAITextEmbeddings : OpenAIClientAbstract, IEmbeddingGener
     }
 
     /// <inheritdoc/>
-    public async Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data)
+    public async Task<IList<Embedding<float>>> GenerateEmbeddingsAsync(IList<string> data, CancellationToken cancellationToken = default)
     {
         var requestBody = Json.Serialize(new OpenAIEmbeddingRequest { Model = this._modelId, Input = data, });
 
-        return await this.ExecuteEmbeddingRequestAsync(OpenaiEmbeddingEndpoint, requestBody);
+        return await this.ExecuteEmbeddingRequestAsync(OpenaiEmbeddingEndpoint, requestBody, deduplicate: true, cancellationToken: cancellationToken);
     }
 }
@@ -0,0 +1,297 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Logging.Abstractions;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI;
+
+/// <summary>
+/// Text completion client spreading requests across several equivalent backends, e.g. deployments of the
+/// same model in different regions, to aggregate their quotas and avoid the latency spikes of a single backend.
+/// Each request goes to the backend with the lowest latency weighted by the requests in flight. When a request
+/// fails because of the backend, it is sent to the next backend, and backends failing repeatedly are ejected
+/// for a while, then probed with a single request before receiving traffic again.
+/// </summary>
+public sealed class RoutingTextCompletionClient : ITextCompletionClient, IDisposable
+{
+    /// <summary>
+    /// Default number of consecutive failures after which a backend is ejected.
+    /// </summary>
+    public const int DefaultFailureThreshold = 3;
+
+    /// <summary>
+    /// Default time a backend is ejected for, doubled each time the probe fails.
+    /// </summary>
+    public static readonly TimeSpan DefaultEjectionTime = TimeSpan.FromSeconds(30);
+
+    /// <summary>
+    /// Create a new instance.
+    /// </summary>
+    /// <param name="backends">Equivalent completion backends</param>
+    /// <param name="failureThreshold">Number of consecutive failures after which a backend is ejected</param>
+    /// <param name="ejectionTime">Time a backend is ejected for, doubled each time the probe fails</param>
+    /// <param name="log">Logger</param>
+    public RoutingTextCompletionClient(
+        IEnumerable<ITextCompletionClient> backends,
+        int failureThreshold = DefaultFailureThreshold,
+        TimeSpan? ejectionTime = null,
+        ILogger? log = null)
+        : this(backends, failureThreshold, ejectionTime, log, null)
+    {
+    }
+
+    /// <summary>
+    /// Number of backends.
+    /// </summary>
+    public int BackendCount => this._backends.Length;
+
+    /// <summary>
+    /// Number of backends currently ejected.
+    /// </summary>
+    public int EjectedCount
+    {
+        get
+        {
+            lock (this._lock) { return this._backends.Count(x => x.EjectedUntil.HasValue); }
+        }
+    }
+
+    /// <inheritdoc/>
+    public async Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+    {
+        var tried = new HashSet<Backend>();
+        while (true)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+            Backend backend = this.Select(tried);
+            tried.Add(backend);
+
+            TimeSpan start = this._clock();
+            try
+            {
+                string result = await backend.Client.CompleteAsync(text, requestSettings, cancellationToken);
+                this.RecordSuccess(backend, this._clock() - start);
+                return result;
+            }
+            catch (Exception e) when (IsBackendFailure(e, cancellationToken))
+            {
+                this.RecordFailure(backend);
+                if (tried.Count >= this._backends.Length) { throw; }
+
+                this._log.LogWarning("Completion backend {0} failed, trying the next backend: {1}", backend.Index, e.Message);
+            }
+            catch (Exception)
+            {
+                // The request is not valid or has been cancelled by the caller: the backend is healthy,
+                // and the other backends would fail too
+                this.RecordRelease(backend);
+                throw;
+            }
+        }
+    }
+
+    /// <inheritdoc/>
+    public void Dispose()
+    {
+        foreach (Backend backend in this._backends)
+        {
+            if (backend.Client is IDisposable disposable) { disposable.Dispose(); }
+        }
+    }
+
+    #region internals ==============================================================================
+
+    internal RoutingTextCompletionClient(
+        IEnumerable<ITextCompletionClient> backends,
+        int failureThreshold,
+        TimeSpan? ejectionTime,
+        ILogger? log,
+        Func<TimeSpan>? clock)
+    {
+        Verify.NotNull(backends, "The completion backends cannot be NULL");
+        this._backends = backends.Select((client, index) => new Backend(client, index)).ToArray();
+        if (this._backends.Length == 0)
+        {
+            throw new AIException(AIException.ErrorCodes.InvalidConfiguration, "At least one completion backend is required");
+        }
+
+        if (failureThreshold < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(failureThreshold), "The failure threshold must be greater than zero");
+        }
+
+        this._failureThreshold = failureThreshold;
+        this._ejectionTime = ejectionTime ?? DefaultEjectionTime;
+        this._log = log ?? NullLogger.Instance;
+
+        if (clock == null)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            clock = () => stopwatch.Elapsed;
+        }
+
+        this._clock = clock;
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    // Weight of the latest latency in the moving average
+    private const double LatencyDecay = 0.2;
+
+    // Max number of times the ejection time is doubled
+    private const int MaxEjectionDoublings = 4;
+
+    private sealed class Backend
+    {
+        internal Backend(ITextCompletionClient client, int index)
+        {
+            this.Client = client;
+            this.Index = index;
+        }
+
+        internal ITextCompletionClient Client { get; }
+        internal int Index { get; }
+        internal int Outstanding { get; set; }
+        internal double LatencyMs { get; set; }
+        internal int ConsecutiveFailures { get; set; }
+        internal int Ejections { get; set; }
+        internal TimeSpan? EjectedUntil { get; set; }
+        internal bool Probing { get; set; }
+    }
+
+    private readonly object _lock = new();
+    private readonly Backend[] _backends;
+    private readonly int _failureThreshold;
+    private readonly TimeSpan _ejectionTime;
+    private readonly ILogger _log;
+    private readonly Func<TimeSpan> _clock;
+    private int _nextStart = -1;
+
+    private static bool IsBackendFailure(Exception e, CancellationToken cancellationToken)
+    {
+        if (e is OperationCanceledException && cancellationToken.IsCancellationRequested) { return false; }
+
+        if (e is not AIException aiException) { return true; }
+
+        switch (aiException.ErrorCode)
+        {
+            case AIException.ErrorCodes.InvalidRequest:
+            case AIException.ErrorCodes.InvalidConfiguration:
+            case AIException.ErrorCodes.FunctionTypeNotSupported:
+                return false;
+
+            default:
+                return true;
+        }
+    }
+
+    private Backend Select(HashSet<Backend> tried)
+    {
+        // Start from a different backend each time, so that ties are spread across backends
+        int start = (int)((uint)Interlocked.Increment(ref this._nextStart) % (uint)this._backends.Length);
+        TimeSpan now = this._clock();
+
+        lock (this._lock)
+        {
+            Backend? best = null;
+            double bestScore = double.MaxValue;
+            for (int i = 0; i < this._backends.Length; i++)
+            {
+                Backend backend = this._backends[(start + i) % this._backends.Length];
+                if (tried.Contains(backend)) { continue; }
+
+                if (backend.EjectedUntil.HasValue)
+                {
+                    // Ejected backends receive a single probe request once the ejection time is over
+                    if (backend.EjectedUntil.Value > now || backend.Probing) { continue; }
+
+                    best = backend;
+                    best.Probing = true;
+                    break;
+                }
+
+                // Backends without latency samples yet are preferred, so that all backends are measured
+                double score = (backend.Outstanding + 1) * Math.Max(backend.LatencyMs, 1);
+                if (backend.LatencyMs == 0) { score = backend.Outstanding; }
+
+                if (score < bestScore)
+                {
+                    best = backend;
+                    bestScore = score;
+                }
+            }
+
+            // When all the backends are ejected, use the one coming back first rather than failing
+            best ??= this._backends.Where(x => !tried.Contains(x)).OrderBy(x => x.EjectedUntil ?? TimeSpan.Zero).First();
+
+            best.Outstanding++;
+            return best;
+        }
+    }
+
+    private void RecordSuccess(Backend backend, TimeSpan latency)
+    {
+        lock (this._lock)
+        {
+            backend.Outstanding--;
+            backend.LatencyMs = backend.LatencyMs == 0
+                ? latency.TotalMilliseconds
+                : ((1 - LatencyDecay) * backend.LatencyMs) + (LatencyDecay * latency.TotalMilliseconds);
+            backend.ConsecutiveFailures = 0;
+
+            if (backend.EjectedUntil.HasValue)
+            {
+                this._log.LogInformation("Completion backend {0} is healthy again", backend.Index);
+                backend.EjectedUntil = null;
+                backend.Probing = false;
+                backend.Ejections = 0;
+            }
+        }
+    }
+
+    private void RecordFailure(Backend backend)
+    {
+        lock (this._lock)
+        {
+            backend.Outstanding--;
+            backend.ConsecutiveFailures++;
+
+            bool probeFailed = backend.Probing;
+            if (!probeFailed && (backend.EjectedUntil.HasValue || backend.ConsecutiveFailures < this._failureThreshold)) { return; }
+
+            TimeSpan ejectionTime = TimeSpan.FromTicks(this._ejectionTime.Ticks << Math.Min(backend.Ejections, MaxEjectionDoublings));
+            backend.EjectedUntil = this._clock() + ejectionTime;
+            backend.Probing = false;
+            backend.Ejections++;
+
+            this._log.LogWarning("Completion backend {0} ejected for {1} after {2} consecutive failures",
+                backend.Index, ejectionTime, backend.ConsecutiveFailures);
+        }
+    }
+
+    private void RecordRelease(Backend backend)
+    {
+        lock (this._lock)
+        {
+            backend.Outstanding--;
+            if (!backend.Probing) { return; }
+
+            // The backend answered the probe, even if the request was not valid
+            backend.EjectedUntil = null;
+            backend.Probing = false;
+            backend.Ejections = 0;
+            backend.ConsecutiveFailures = 0;
+        }
+    }
+
+    #endregion
+}
@@ -0,0 +1,140 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.SemanticKernel.AI;
+
+/// <summary>
+/// Coalesces concurrent identical operations: while an operation with a given key is in flight,
+/// callers using the same key receive the result of that operation instead of starting a new one.
+/// Results are not kept once the operation completes.
+/// A caller cancelling its token stops waiting immediately; the shared operation is cancelled
+/// only when all the callers waiting for it have cancelled.
+/// </summary>
+/// <typeparam name="T">Type of the operation result</typeparam>
+internal sealed class SingleFlight<T>
+{
+    /// <summary>
+    /// Number of operations in flight.
+    /// </summary>
+    internal int Count
+    {
+        get
+        {
+            lock (this._inFlight) { return this._inFlight.Count; }
+        }
+    }
+
+    /// <summary>
+    /// Run the operation, or join the operation in flight with the same key.
+    /// </summary>
+    /// <param name="key">Key identifying identical operations</param>
+    /// <param name="operation">Operation to run if no identical operation is in flight</param>
+    /// <param name="cancellationToken">Cancellation token of the caller</param>
+    /// <returns>Result of the operation</returns>
+    internal async Task<T> RunAsync(string key, Func<CancellationToken, Task<T>> operation, CancellationToken cancellationToken = default)
+    {
+        cancellationToken.ThrowIfCancellationRequested();
+
+        Flight flight;
+        bool isNew = false;
+        lock (this._inFlight)
+        {
+            if (!this._inFlight.TryGetValue(key, out Flight? existing))
+            {
+                existing = new Flight();
+                this._inFlight[key] = existing;
+                isNew = true;
+            }
+
+            flight = existing;
+            flight.Waiters++;
+        }
+
+        if (isNew) { _ = this.RunFlightAsync(key, operation, flight); }
+
+        // Callers that can't cancel keep the operation alive until it completes
+        if (!cancellationToken.CanBeCanceled) { return await flight.Result.Task; }
+
+        var cancelled = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+        using (cancellationToken.Register(() => cancelled.TrySetResult(true)))
+        {
+            Task completed = await Task.WhenAny(flight.Result.Task, cancelled.Task);
+            if (completed != flight.Result.Task)
+            {
+                this.Leave(key, flight);
+                cancellationToken.ThrowIfCancellationRequested();
+            }
+        }
+
+        return await flight.Result.Task;
+    }
+
+    #region private ================================================================================
+
+    private sealed class Flight
+    {
+        internal TaskCompletionSource<T> Result { get; } = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        internal CancellationTokenSource Cancellation { get; } = new();
+
+        internal int Waiters { get; set; }
+
+        internal bool Completed { get; set; }
+    }
+
+    private readonly Dictionary<string, Flight> _inFlight = new(StringComparer.Ordinal);
+
+    private async Task RunFlightAsync(string key, Func<CancellationToken, Task<T>> operation, Flight flight)
+    {
+        try
+        {
+            T result = await operation(flight.Cancellation.Token);
+            this.Complete(key, flight);
+            flight.Result.SetResult(result);
+        }
+#pragma warning disable CA1031 // The exception is passed to all the callers
+        catch (Exception e)
+#pragma warning restore CA1031
+        {
+            this.Complete(key, flight);
+            if (e is OperationCanceledException) { flight.Result.SetCanceled(); }
+            else { flight.Result.SetException(e); }
+        }
+    }
+
+    private void Complete(string key, Flight flight)
+    {
+        lock (this._inFlight)
+        {
+            this.Remove(key, flight);
+            flight.Completed = true;
+            flight.Cancellation.Dispose();
+        }
+    }
+
+    /// <summary>
+    /// A caller stopped waiting. When nobody is waiting anymore, the operation is cancelled and
+    /// new callers start a new operation.
+    /// </summary>
+    private void Leave(string key, Flight flight)
+    {
+        lock (this._inFlight)
+        {
+            if (--flight.Waiters > 0 || flight.Completed) { return; }
+
+            this.Remove(key, flight);
+            flight.Cancellation.Cancel();
+        }
+    }
+
+    private void Remove(string key, Flight flight)
+    {
+        if (this._inFlight.TryGetValue(key, out Flight? current) && current == flight) { this._inFlight.Remove(key); }
+    }
+
+    #endregion
+}
@@ -0,0 +1,418 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Buffers;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Text.RegularExpressions;
+using System.Threading;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI.Tokenizers;
+
+/// <summary>
+/// Byte pair encoding tokenizer compatible with GPT models, e.g. p50k_base (text-davinci-003, code-davinci-002)
+/// and cl100k_base (gpt-3.5-turbo, text-embedding-ada-002).
+/// </summary>
+/// <remarks>
+/// The vocabulary is loaded from a "tiktoken" file, i.e. a text file where each line contains a
+/// base64 encoded token and its rank, separated by a space. The files are published by OpenAI, e.g.
+/// https://openaipublic.blob.core.windows.net/encodings/cl100k_base.tiktoken
+/// Text is first split with the regular expression used by the model, then each piece is encoded
+/// merging pairs of bytes in order of rank. Encoded pieces are cached.
+/// </remarks>
+public sealed class BpeTokenizer : ITokenizer
+{
+    /// <summary>
+    /// Regular expression used by p50k_base and r50k_base to split text before merging.
+    /// </summary>
+    public const string P50KPattern = @"'s|'t|'re|'ve|'m|'ll|'d| ?\p{L}+| ?\p{N}+| ?[^\s\p{L}\p{N}]+|\s+(?!\S)|\s+";
+
+    /// <summary>
+    /// Regular expression used by cl100k_base to split text before merging.
+    /// </summary>
+    public const string Cl100KPattern = @"(?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+(?!\S)|\s+";
+
+    /// <summary>
+    /// Approximate max number of pieces kept in the cache of encoded pieces.
+    /// </summary>
+    public const int MaxCacheSize = 50_000;
+
+    /// <summary>
+    /// Create a tokenizer.
+    /// </summary>
+    /// <param name="ranks">Vocabulary, i.e. list of tokens (as bytes) and their rank. The rank is also the token ID.</param>
+    /// <param name="pattern">Regular expression used to split text before merging, e.g. <see cref="Cl100KPattern"/></param>
+    public BpeTokenizer(IEnumerable<KeyValuePair<byte[], int>> ranks, string pattern)
+    {
+        Verify.NotNull(ranks, "The vocabulary cannot be NULL");
+        Verify.NotEmpty(pattern, "The pattern cannot be empty");
+
+        this._vocabulary = new TokenTable(ranks);
+        this._regex = new Regex(pattern, RegexOptions.Compiled | RegexOptions.CultureInvariant);
+    }
+
+    /// <summary>
+    /// Create a tokenizer loading the vocabulary from a tiktoken file.
+    /// </summary>
+    /// <param name="stream">Stream containing one token per line, as base64 encoded bytes followed by the rank</param>
+    /// <param name="pattern">Regular expression used to split text before merging, e.g. <see cref="Cl100KPattern"/></param>
+    /// <returns>Tokenizer instance</returns>
+    public static BpeTokenizer FromTiktokenStream(Stream stream, string pattern)
+    {
+        Verify.NotNull(stream, "The stream cannot be NULL");
+
+        var ranks = new List<KeyValuePair<byte[], int>>();
+        using var reader = new StreamReader(stream, Encoding.UTF8);
+        string? line;
+        while ((line = reader.ReadLine()) != null)
+        {
+            if (string.IsNullOrWhiteSpace(line)) { continue; }
+
+            int separator = line.IndexOf(' ');
+            if (separator <= 0 || !int.TryParse(line.Substring(separator + 1), out int rank))
+            {
+                throw new AIException(AIException.ErrorCodes.InvalidConfiguration, $"Invalid tiktoken line: {line}");
+            }
+
+            ranks.Add(new KeyValuePair<byte[], int>(Convert.FromBase64String(line.Substring(0, separator)), rank));
+        }
+
+        return new BpeTokenizer(ranks, pattern);
+    }
+
+    /// <summary>
+    /// Create a tokenizer loading the vocabulary from a tiktoken file.
+    /// </summary>
+    /// <param name="path">Path of the file, e.g. "cl100k_base.tiktoken"</param>
+    /// <param name="pattern">Regular expression used to split text before merging, e.g. <see cref="Cl100KPattern"/></param>
+    /// <returns>Tokenizer instance</returns>
+    public static BpeTokenizer FromTiktokenFile(string path, string pattern)
+    {
+        using FileStream stream = File.OpenRead(path);
+        return FromTiktokenStream(stream, pattern);
+    }
+
+    /// <inheritdoc/>
+    public int CountTokens(string text)
+    {
+        if (string.IsNullOrEmpty(text)) { return 0; }
+
+        int count = 0;
+        for (Match match = this._regex.Match(text); match.Success; match = match.NextMatch())
+        {
+            count += this.CountPieceTokens(text.AsSpan(match.Index, match.Length));
+        }
+
+        return count;
+    }
+
+    /// <inheritdoc/>
+    public IList<int> Encode(string text)
+    {
+        var result = new List<int>();
+        if (string.IsNullOrEmpty(text)) { return result; }
+
+        for (Match match = this._regex.Match(text); match.Success; match = match.NextMatch())
+        {
+            result.AddRange(this.EncodePiece(match.Value));
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Convert a list of token IDs back to text.
+    /// </summary>
+    /// <param name="tokens">Token IDs</param>
+    /// <returns>Decoded text</returns>
+    public string Decode(IEnumerable<int> tokens)
+    {
+        Verify.NotNull(tokens, "The list of tokens cannot be NULL");
+
+        using var bytes = new MemoryStream();
+        foreach (int token in tokens)
+        {
+            ReadOnlySpan<byte> tokenBytes = this._vocabulary.GetBytes(token);
+            bytes.Write(tokenBytes);
+        }
+
+        return Encoding.UTF8.GetString(bytes.GetBuffer(), 0, (int)bytes.Length);
+    }
+
+    #region private ================================================================================
+
+    // Pieces up to this size are encoded using the stack
+    private const int MaxStackPieceBytes = 256;
+
+    private readonly TokenTable _vocabulary;
+    private readonly Regex _regex;
+    private readonly object _cacheLock = new();
+
+    // Cache of encoded pieces, in two generations: when the current generation is full it replaces the
+    // previous one, and pieces found in the previous generation are copied to the current one, so that
+    // frequent pieces are kept without tracking the order of use of every piece.
+    private ConcurrentDictionary<string, int[]> _cache = new(StringComparer.Ordinal);
+    private ConcurrentDictionary<string, int[]> _previousCache = new(StringComparer.Ordinal);
+    private int _cacheCount;
+
+    private int CountPieceTokens(ReadOnlySpan<char> piece)
+    {
+        int maxBytes = Encoding.UTF8.GetMaxByteCount(piece.Length);
+        byte[]? rented = null;
+        Span<byte> buffer = maxBytes <= MaxStackPieceBytes
+            ? stackalloc byte[MaxStackPieceBytes]
+            : (rented = ArrayPool<byte>.Shared.Rent(maxBytes));
+
+        try
+        {
+            Span<byte> bytes = buffer.Slice(0, Encoding.UTF8.GetBytes(piece, buffer));
+
+            // Most pieces are a single token
+            if (this._vocabulary.GetRank(bytes) >= 0) { return 1; }
+
+            return this.MergeBytePairs(bytes, null);
+        }
+        finally
+        {
+            if (rented != null) { ArrayPool<byte>.Shared.Return(rented); }
+        }
+    }
+
+    private int[] EncodePiece(string piece)
+    {
+        if (this._cache.TryGetValue(piece, out int[]? cached)) { return cached; }
+
+        if (this._previousCache.TryGetValue(piece, out cached))
+        {
+            this.AddToCache(piece, cached);
+            return cached;
+        }
+
+        byte[] bytes = Encoding.UTF8.GetBytes(piece);
+        int rank = this._vocabulary.GetRank(bytes);
+        int[] tokens;
+        if (rank >= 0)
+        {
+            tokens = new[] { rank };
+        }
+        else
+        {
+            var list = new List<int>();
+            this.MergeBytePairs(bytes, list);
+            tokens = list.ToArray();
+        }
+
+        this.AddToCache(piece, tokens);
+        return tokens;
+    }
+
+    private void AddToCache(string piece, int[] tokens)
+    {
+        if (!this._cache.TryAdd(piece, tokens)) { return; }
+
+        // The counter is approximate under concurrency, which is enough to bound memory usage
+        if (Interlocked.Increment(ref this._cacheCount) < MaxCacheSize / 2) { return; }
+
+        lock (this._cacheLock)
+        {
+            if (this._cacheCount < MaxCacheSize / 2) { return; }
+
+            this._previousCache = this._cache;
+            this._cache = new ConcurrentDictionary<string, int[]>(StringComparer.Ordinal);
+            this._cacheCount = 0;
+        }
+    }
+
+    /// <summary>
+    /// Merge bytes into tokens, always merging first the pair with the lowest rank.
+    /// </summary>
+    /// <param name="bytes">Bytes to encode</param>
+    /// <param name="tokens">Optional list where to add the token IDs</param>
+    /// <returns>Number of tokens</returns>
+    private int MergeBytePairs(ReadOnlySpan<byte> bytes, List<int>? tokens)
+    {
+        // parts[i] is the start of the i-th token, ranks[i] is the rank of the merge of the i-th and the (i+1)-th tokens
+        int partsCount = bytes.Length + 1;
+        int[]? rentedParts = null;
+        int[]? rentedRanks = null;
+        Span<int> parts = partsCount <= MaxStackPieceBytes
+            ? stackalloc int[MaxStackPieceBytes + 1]
+            : (rentedParts = ArrayPool<int>.Shared.Rent(partsCount));
+        Span<int> ranks = partsCount <= MaxStackPieceBytes
+            ? stackalloc int[MaxStackPieceBytes + 1]
+            : (rentedRanks = ArrayPool<int>.Shared.Rent(partsCount));
+
+        try
+        {
+            for (int i = 0; i < partsCount; i++)
+            {
+                parts[i] = i;
+            }
+
+            for (int i = 0; i < partsCount - 2; i++)
+            {
+                ranks[i] = this.GetPairRank(bytes, parts, partsCount, i);
+            }
+
+            while (partsCount > 2)
+            {
+                int minRank = int.MaxValue;
+                int minIndex = -1;
+                for (int i = 0; i < partsCount - 2; i++)
+                {
+                    if (ranks[i] < minRank)
+                    {
+                        minRank = ranks[i];
+                        minIndex = i;
+                    }
+                }
+
+                if (minIndex < 0) { break; }
+
+                // Merge token minIndex with the next one
+                parts.Slice(minIndex + 2, partsCount - minIndex - 2).CopyTo(parts.Slice(minIndex + 1));
+                ranks.Slice(minIndex + 2, partsCount - minIndex - 2).CopyTo(ranks.Slice(minIndex + 1));
+                partsCount--;
+
+                if (minIndex < partsCount - 2) { ranks[minIndex] = this.GetPairRank(bytes, parts, partsCount, minIndex); }
+
+                if (minIndex > 0) { ranks[minIndex - 1] = this.GetPairRank(bytes, parts, partsCount, minIndex - 1); }
+            }
+
+            if (tokens != null)
+            {
+                for (int i = 0; i < partsCount - 1; i++)
+                {
+                    int rank = this._vocabulary.GetRank(bytes.Slice(parts[i], parts[i + 1] - parts[i]));
+                    if (rank < 0)
+                    {
+                        throw new AIException(AIException.ErrorCodes.InvalidConfiguration, "The vocabulary doesn't contain all the single bytes");
+                    }
+
+                    tokens.Add(rank);
+                }
+            }
+
+            return partsCount - 1;
+        }
+        finally
+        {
+            if (rentedParts != null) { ArrayPool<int>.Shared.Return(rentedParts); }
+
+            if (rentedRanks != null) { ArrayPool<int>.Shared.Return(rentedRanks); }
+        }
+    }
+
+    private int GetPairRank(ReadOnlySpan<byte> bytes, Span<int> parts, int partsCount, int index)
+    {
+        if (index + 2 >= partsCount) { return int.MaxValue; }
+
+        int rank = this._vocabulary.GetRank(bytes.Slice(parts[index], parts[index + 2] - parts[index]));
+        return rank < 0 ? int.MaxValue : rank;
+    }
+
+    /// <summary>
+    /// Hash table mapping byte sequences to ranks, searchable without allocating memory.
+    /// </summary>
+    private sealed class TokenTable
+    {
+        public TokenTable(IEnumerable<KeyValuePair<byte[], int>> ranks)
+        {
+            var entries = new List<KeyValuePair<byte[], int>>(ranks);
+            int totalBytes = 0;
+            foreach (var entry in entries) { totalBytes += entry.Key.Length; }
+
+            this._bytes = new byte[totalBytes];
+            this._offsets = new int[entries.Count + 1];
+            this._ranks = new int[entries.Count];
+
+            int capacity = 1;
+            while (capacity < entries.Count * 2) { capacity <<= 1; }
+
+            this._buckets = new int[capacity];
+            this._buckets.AsSpan().Fill(-1);
+
+            int offset = 0;
+            for (int i = 0; i < entries.Count; i++)
+            {
+                entries[i].Key.CopyTo(this._bytes, offset);
+                this._offsets[i] = offset;
+                this._ranks[i] = entries[i].Value;
+                offset += entries[i].Key.Length;
+
+                int bucket = (int)(Hash(entries[i].Key) & (uint)(capacity - 1));
+                while (this._buckets[bucket] >= 0) { bucket = (bucket + 1) & (capacity - 1); }
+
+                this._buckets[bucket] = i;
+
+                this._maxRank = Math.Max(this._maxRank, entries[i].Value);
+            }
+
+            this._offsets[entries.Count] = offset;
+
+            this._entryByRank = new int[this._maxRank + 1];
+            this._entryByRank.AsSpan().Fill(-1);
+            for (int i = 0; i < entries.Count; i++) { this._entryByRank[this._ranks[i]] = i; }
+        }
+
+        /// <summary>
+        /// Get the rank of a byte sequence, or -1 if the sequence is not in the vocabulary.
+        /// </summary>
+        public int GetRank(ReadOnlySpan<byte> key)
+        {
+            int mask = this._buckets.Length - 1;
+            int bucket = (int)(Hash(key) & (uint)mask);
+            while (true)
+            {
+                int entry = this._buckets[bucket];
+                if (entry < 0) { return -1; }
+
+                if (this.GetEntryBytes(entry).SequenceEqual(key)) { return this._ranks[entry]; }
+
+                bucket = (bucket + 1) & mask;
+            }
+        }
+
+        /// <summary>
+        /// Get the byte sequence of a token.
+        /// </summary>
+        public ReadOnlySpan<byte> GetBytes(int rank)
+        {
+            if (rank < 0 || rank > this._maxRank || this._entryByRank[rank] < 0)
+            {
+                throw new AIException(AIException.ErrorCodes.InvalidRequest, $"Unknown token {rank}");
+            }
+
+            return this.GetEntryBytes(this._entryByRank[rank]);
+        }
+
+        private readonly byte[] _bytes;
+        private readonly int[] _offsets;
+        private readonly int[] _ranks;
+        private readonly int[] _buckets;
+        private readonly int[] _entryByRank;
+        private readonly int _maxRank;
+
+        private ReadOnlySpan<byte> GetEntryBytes(int entry)
+        {
+            return this._bytes.AsSpan(this._offsets[entry], this._offsets[entry + 1] - this._offsets[entry]);
+        }
+
+        // FNV-1a
+        private static uint Hash(ReadOnlySpan<byte> key)
+        {
+            uint hash = 2166136261;
+            foreach (byte b in key)
+            {
+                hash = (hash ^ b) * 16777619;
+            }
+
+            return hash;
+        }
+    }
+
+    #endregion
+}
@@ -0,0 +1,148 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace Microsoft.SemanticKernel.AI.Tokenizers;
+
+/// <summary>
+/// Tokenizer estimating the number of tokens without a vocabulary, following the
+/// rules used by GPT byte pair encoders to split text before merging:
+/// words, numbers, punctuation and whitespace are counted separately,
+/// and non latin scripts (e.g. CJK) count about one token per character.
+/// </summary>
+/// <remarks>
+/// The estimate is much closer to the real count than a fixed chars/token ratio, in particular for
+/// code, CJK text and whitespace heavy text. Use <see cref="BpeTokenizer"/> when the exact count is needed.
+/// Token IDs returned by <see cref="Encode"/> are not meaningful for any model.
+/// </remarks>
+public sealed class HeuristicTokenizer : ITokenizer
+{
+    /// <summary>
+    /// Shared instance, the tokenizer is stateless.
+    /// </summary>
+    public static HeuristicTokenizer Instance { get; } = new();
+
+    /// <inheritdoc/>
+    public int CountTokens(string text)
+    {
+        return CountTokens(text.AsSpan());
+    }
+
+    /// <summary>
+    /// Count the tokens in a text, without allocating memory.
+    /// </summary>
+    /// <param name="text">Text to measure</param>
+    /// <returns>Estimated number of tokens</returns>
+    public static int CountTokens(ReadOnlySpan<char> text)
+    {
+        int count = 0;
+        int i = 0;
+        while (i < text.Length)
+        {
+            int start = i;
+            CharClass charClass = Classify(text[i]);
+            switch (charClass)
+            {
+                case CharClass.Letter:
+                    // Words: common words are one token, longer words about 4 chars per token
+                    while (i < text.Length && Classify(text[i]) == CharClass.Letter) { i++; }
+
+                    int length = i - start;
+                    count += length <= CharsPerWord ? 1 : 1 + ((length - CharsPerWord + CharsPerWordToken - 1) / CharsPerWordToken);
+                    break;
+
+                case CharClass.Digit:
+                    // Numbers are split in groups of up to 3 digits
+                    while (i < text.Length && Classify(text[i]) == CharClass.Digit) { i++; }
+
+                    count += (i - start + DigitsPerToken - 1) / DigitsPerToken;
+                    break;
+
+                case CharClass.Whitespace:
+                    // A whitespace before a word is merged into the word, other whitespace runs are one token
+                    while (i < text.Length && Classify(text[i]) == CharClass.Whitespace) { i++; }
+
+                    bool singleSpaceBeforeWord = i - start == 1 && text[start] == ' '
+                                                 && i < text.Length && Classify(text[i]) != CharClass.Whitespace;
+                    if (!singleSpaceBeforeWord) { count++; }
+
+                    break;
+
+                case CharClass.Punctuation:
+                    // Punctuation sequences are merged in pairs, e.g. "()", "->", "==", "//"
+                    while (i < text.Length && Classify(text[i]) == CharClass.Punctuation) { i++; }
+
+                    count += (i - start + 1) / 2;
+                    break;
+
+                default:
+                    // Ideographs and other scripts: one token per char, surrogate pairs included
+                    i += char.IsHighSurrogate(text[i]) && i + 1 < text.Length ? 2 : 1;
+                    count++;
+                    break;
+            }
+        }
+
+        return count;
+    }
+
+    /// <inheritdoc/>
+    /// <remarks>The IDs are placeholders, only the number of items is meaningful.</remarks>
+    public IList<int> Encode(string text)
+    {
+        return new int[this.CountTokens(text)];
+    }
+
+    #region private ================================================================================
+
+    private const int CharsPerWord = 8;
+    private const int CharsPerWordToken = 4;
+    private const int DigitsPerToken = 3;
+
+    private enum CharClass
+    {
+        Letter,
+        Digit,
+        Whitespace,
+        Punctuation,
+        Other,
+    }
+
+    private static CharClass Classify(char c)
+    {
+        if (c < 128)
+        {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) { return CharClass.Letter; }
+
+            if (c >= '0' && c <= '9') { return CharClass.Digit; }
+
+            return c is ' ' or '\t' or '\n' or '\r' or '\f' or '\v' ? CharClass.Whitespace : CharClass.Punctuation;
+        }
+
+        if (char.IsWhiteSpace(c)) { return CharClass.Whitespace; }
+
+        // Latin, Greek and Cyrillic letters (with accents) are merged in words like ASCII letters
+        if (c < 0x0530 && char.IsLetter(c)) { return CharClass.Letter; }
+
+        switch (CharUnicodeInfo.GetUnicodeCategory(c))
+        {
+            case UnicodeCategory.DecimalDigitNumber:
+                return CharClass.Digit;
+
+            case UnicodeCategory.ConnectorPunctuation:
+            case UnicodeCategory.DashPunctuation:
+            case UnicodeCategory.OpenPunctuation:
+            case UnicodeCategory.ClosePunctuation:
+            case UnicodeCategory.OtherPunctuation:
+            case UnicodeCategory.MathSymbol:
+                return CharClass.Punctuation;
+
+            default:
+                return CharClass.Other;
+        }
+    }
+
+    #endregion
+}
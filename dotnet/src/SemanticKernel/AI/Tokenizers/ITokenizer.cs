@@ -0,0 +1,26 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Collections.Generic;
+
+namespace Microsoft.SemanticKernel.AI.Tokenizers;
+
+/// <summary>
+/// Interface for tokenizers, used to measure text in tokens, e.g. to split text
+/// in chunks fitting a model context window, or to validate the size of a request.
+/// </summary>
+public interface ITokenizer
+{
+    /// <summary>
+    /// Count the tokens in a text.
+    /// </summary>
+    /// <param name="text">Text to measure</param>
+    /// <returns>Number of tokens</returns>
+    int CountTokens(string text);
+
+    /// <summary>
+    /// Convert a text to a list of token IDs.
+    /// </summary>
+    /// <param name="text">Text to encode</param>
+    /// <returns>List of token IDs</returns>
+    IList<int> Encode(string text);
+}
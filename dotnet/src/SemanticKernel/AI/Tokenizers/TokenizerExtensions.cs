@@ -0,0 +1,110 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.AI.Tokenizers;
+
+/// <summary>
+/// Extension methods to budget tokens in prompts and completion requests.
+/// </summary>
+public static class TokenizerExtensions
+{
+    /// <summary>
+    /// Calculate how many tokens are left for the completion, after the prompt.
+    /// </summary>
+    /// <param name="tokenizer">Tokenizer matching the model</param>
+    /// <param name="prompt">Prompt to send</param>
+    /// <param name="contextWindowSize">Max number of tokens supported by the model, prompt and completion included, e.g. 4097 for text-davinci-003</param>
+    /// <returns>Max number of tokens available for the completion, zero or negative if the prompt doesn't fit</returns>
+    public static int GetAvailableCompletionTokens(this ITokenizer tokenizer, string prompt, int contextWindowSize)
+    {
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+
+        return contextWindowSize - tokenizer.CountTokens(prompt);
+    }
+
+    /// <summary>
+    /// Check that a prompt and the requested completion size fit in the model context window,
+    /// to avoid sending requests that would be rejected by the service.
+    /// </summary>
+    /// <param name="tokenizer">Tokenizer matching the model</param>
+    /// <param name="prompt">Prompt to send</param>
+    /// <param name="requestSettings">Request settings, containing the max number of tokens to generate</param>
+    /// <param name="contextWindowSize">Max number of tokens supported by the model, prompt and completion included</param>
+    /// <exception cref="AIException">The request doesn't fit in the context window</exception>
+    public static void ValidateCompletionRequest(this ITokenizer tokenizer, string prompt, CompleteRequestSettings requestSettings, int contextWindowSize)
+    {
+        Verify.NotNull(requestSettings, "Completion settings cannot be empty");
+
+        int promptTokens = tokenizer.CountTokens(prompt);
+        if (promptTokens + requestSettings.MaxTokens > contextWindowSize)
+        {
+            throw new AIException(
+                AIException.ErrorCodes.InvalidRequest,
+                $"The prompt ({promptTokens} tokens) and MaxTokens ({requestSettings.MaxTokens}) "
+                + $"exceed the model context size ({contextWindowSize} tokens)");
+        }
+    }
+
+    /// <summary>
+    /// Check that a prompt and the requested completion size fit in the context window of a known model.
+    /// Requests for models with an unknown context window are not checked.
+    /// </summary>
+    /// <param name="tokenizer">Tokenizer matching the model</param>
+    /// <param name="prompt">Prompt to send</param>
+    /// <param name="requestSettings">Request settings, containing the max number of tokens to generate</param>
+    /// <param name="modelId">Model name, e.g. "text-davinci-003"</param>
+    /// <exception cref="AIException">The request doesn't fit in the context window</exception>
+    public static void ValidateCompletionRequest(this ITokenizer tokenizer, string prompt, CompleteRequestSettings requestSettings, string modelId)
+    {
+        if (TryGetContextWindowSize(modelId, out int contextWindowSize))
+        {
+            tokenizer.ValidateCompletionRequest(prompt, requestSettings, contextWindowSize);
+        }
+    }
+
+    /// <summary>
+    /// Get the context window size of a known model.
+    /// </summary>
+    /// <param name="modelId">Model name, e.g. "text-davinci-003"</param>
+    /// <param name="contextWindowSize">Max number of tokens supported by the model, prompt and completion included</param>
+    /// <returns>True if the model is known</returns>
+    public static bool TryGetContextWindowSize(string modelId, out int contextWindowSize)
+    {
+        contextWindowSize = 0;
+        if (string.IsNullOrEmpty(modelId)) { return false; }
+
+        // Longest prefixes first, e.g. "gpt-4-32k" before "gpt-4"
+        foreach (KeyValuePair<string, int> model in s_contextWindowSizes)
+        {
+            if (modelId.StartsWith(model.Key, StringComparison.OrdinalIgnoreCase))
+            {
+                contextWindowSize = model.Value;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    #region private ================================================================================
+
+    private static readonly KeyValuePair<string, int>[] s_contextWindowSizes =
+    {
+        new("gpt-4-32k", 32768),
+        new("gpt-4", 8192),
+        new("gpt-35-turbo", 4096),
+        new("gpt-3.5-turbo", 4096),
+        new("code-davinci-002", 8001),
+        new("text-davinci-003", 4097),
+        new("text-davinci-002", 4097),
+        new("code-cushman-001", 2048),
+        new("text-curie-001", 2049),
+        new("text-babbage-001", 2049),
+        new("text-ada-001", 2049),
+    };
+
+    #endregion
+}
@@ -3,7 +3,10 @@
 using System;
 using System.Collections.Generic;
 using System.Linq;
+using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Caching;
 using Microsoft.SemanticKernel.AI.OpenAI.Services;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.Diagnostics;
 using Microsoft.SemanticKernel.Reliability;
 
@@ -19,6 +22,39 @@ public sealed class KernelConfig
     /// </summary>
     public IRetryMechanism RetryMechanism { get => this._retryMechanism; }
 
+    /// <summary>
+    /// Factory of the HTTP handlers retrying, and optionally hedging, the requests sent to the AI backends.
+    /// By default requests failed because of throttling and transient errors are retried using the
+    /// default <see cref="HttpRetryConfig"/> settings: up to 3 retries, within 90 seconds.
+    /// </summary>
+    public IDelegatingHandlerFactory HttpHandlerFactory { get => this._httpHedgingHandlerFactory ?? this._httpHandlerFactory; }
+
+    /// <summary>
+    /// Optional cache of text completions, shared by all the semantic functions. Disabled by default.
+    /// </summary>
+    public CompletionCache? CompletionCache { get => this._completionCache; }
+
+    /// <summary>
+    /// Optional cache reusing completions of similar prompts, used by the semantic functions opting in. Disabled by default.
+    /// </summary>
+    public SemanticCompletionCache? SemanticCompletionCache { get => this._semanticCompletionCache; }
+
+    /// <summary>
+    /// Max number of concurrent prompts of a semantic function sent with a single request. 1 means batching is disabled.
+    /// </summary>
+    public int CompletionBatchSize { get => this._completionBatchSize; }
+
+    /// <summary>
+    /// Max time a completion request waits for other requests to batch with.
+    /// </summary>
+    public TimeSpan CompletionBatchDelay { get => this._completionBatchDelay; }
+
+    /// <summary>
+    /// Optional tokenizer used to reject completion requests not fitting in the model context window,
+    /// before sending them. Only requests to models with a known context window are checked. Disabled by default.
+    /// </summary>
+    public ITokenizer? CompletionTokenizer { get => this._completionTokenizer; }
+
     /// <summary>
     /// Adds an Azure OpenAI backend to the list.
     /// See https://learn.microsoft.com/azure/cognitive-services/openai for service details.
@@ -190,6 +226,103 @@ public sealed class KernelConfig
         return this;
     }
 
+    /// <summary>
+    /// Set the factory of the HTTP handlers retrying failed requests sent to the AI backends.
+    /// Only backends created after calling this method use the new handlers.
+    /// </summary>
+    /// <param name="httpHandlerFactory">HTTP handler factory to use, or NULL to use the default retry handler.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetHttpRetryHandlerFactory(IDelegatingHandlerFactory? httpHandlerFactory = null)
+    {
+        this._httpHandlerFactory = httpHandlerFactory ?? new DefaultHttpRetryHandlerFactory();
+        return this.SetHttpHedging(this._httpHedgingHandlerFactory?.Config);
+    }
+
+    /// <summary>
+    /// Use the default HTTP retry handler with the given settings.
+    /// </summary>
+    /// <param name="httpRetryConfig">Retry settings</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetDefaultHttpRetryConfig(HttpRetryConfig httpRetryConfig)
+    {
+        Verify.NotNull(httpRetryConfig, "The HTTP retry configuration is NULL");
+        this._httpHandlerFactory = new DefaultHttpRetryHandlerFactory(httpRetryConfig);
+        return this.SetHttpHedging(this._httpHedgingHandlerFactory?.Config);
+    }
+
+    /// <summary>
+    /// Enable hedging of the HTTP requests sent to the AI backends: requests slower than most recent requests
+    /// to the same endpoint and operation are duplicated, and the first response is used. Disabled by default.
+    /// Only backends created after calling this method hedge requests.
+    /// </summary>
+    /// <param name="httpHedgingConfig">Hedging settings, or NULL to disable hedging.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetHttpHedging(HttpHedgingConfig? httpHedgingConfig)
+    {
+        this._httpHedgingHandlerFactory = httpHedgingConfig == null
+            ? null
+            : new HttpHedgingHandlerFactory(httpHedgingConfig, this._httpHandlerFactory);
+        return this;
+    }
+
+    /// <summary>
+    /// Set the cache used to reuse completions of prompts already sent to the completion backends.
+    /// Only semantic functions created after calling this method use the cache.
+    /// </summary>
+    /// <param name="completionCache">Completion cache to use, or NULL to disable caching.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetCompletionCache(CompletionCache? completionCache)
+    {
+        this._completionCache = completionCache;
+        return this;
+    }
+
+    /// <summary>
+    /// Set the cache used to reuse completions of prompts similar to prompts already sent to the completion backends.
+    /// Only semantic functions with <see cref="SemanticFunctions.PromptTemplateConfig.UseSemanticCache"/> enabled, and
+    /// created after calling this method, use the cache.
+    /// </summary>
+    /// <param name="semanticCompletionCache">Semantic completion cache to use, or NULL to disable it.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetSemanticCompletionCache(SemanticCompletionCache? semanticCompletionCache)
+    {
+        this._semanticCompletionCache = semanticCompletionCache;
+        return this;
+    }
+
+    /// <summary>
+    /// Enable batching of completion requests: concurrent requests of the same semantic function,
+    /// e.g. when processing multiple partitions of a text, are sent with a single request.
+    /// Only semantic functions created after calling this method use batching.
+    /// </summary>
+    /// <param name="maxBatchSize">Max number of prompts sent with a single request, 1 to disable batching.</param>
+    /// <param name="maxDelay">Max time a request waits for other requests to batch with.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetCompletionBatching(int maxBatchSize = BatchingTextCompletion.DefaultMaxBatchSize, TimeSpan? maxDelay = null)
+    {
+        if (maxBatchSize < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxBatchSize), "The batch size must be greater than zero");
+        }
+
+        this._completionBatchSize = maxBatchSize;
+        this._completionBatchDelay = maxDelay ?? BatchingTextCompletion.DefaultMaxDelay;
+        return this;
+    }
+
+    /// <summary>
+    /// Set the tokenizer used to check that prompts and <see cref="CompleteRequestSettings.MaxTokens"/> fit in the
+    /// model context window, failing with <see cref="AIException.ErrorCodes.InvalidRequest"/> without sending the request.
+    /// Only semantic functions created after calling this method use the tokenizer.
+    /// </summary>
+    /// <param name="tokenizer">Tokenizer matching the completion models, or NULL to disable the check.</param>
+    /// <returns>The updated kernel configuration.</returns>
+    public KernelConfig SetCompletionTokenizer(ITokenizer? tokenizer)
+    {
+        this._completionTokenizer = tokenizer;
+        return this;
+    }
+
     /// <summary>
     /// Set the default completion backend to use for the kernel.
     /// </summary>
@@ -398,6 +531,13 @@ public sealed class KernelConfig
     private string? _defaultCompletionBackend;
     private string? _defaultEmbeddingsBackend;
     private IRetryMechanism _retryMechanism = new PassThroughWithoutRetry();
+    private IDelegatingHandlerFactory _httpHandlerFactory = new DefaultHttpRetryHandlerFactory();
+    private HttpHedgingHandlerFactory? _httpHedgingHandlerFactory;
+    private CompletionCache? _completionCache;
+    private SemanticCompletionCache? _semanticCompletionCache;
+    private int _completionBatchSize = 1;
+    private TimeSpan _completionBatchDelay = BatchingTextCompletion.DefaultMaxDelay;
+    private ITokenizer? _completionTokenizer;
 
     #endregion
 }
@@ -1,6 +1,12 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
+using System.Collections.Generic;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Tokenizers;
 using Microsoft.SemanticKernel.KernelExtensions;
 using Microsoft.SemanticKernel.Orchestration;
 using Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
@@ -24,16 +30,42 @@ public class ConversationSummarySkill
     /// </summary>
     private const int MaxTokens = 1024;
 
+    /// <summary>
+    /// The default max number of transcript chunks processed concurrently.
+    /// </summary>
+    private const int DefaultMaxDegreeOfParallelism = 4;
+
+    /// <summary>
+    /// The max number of partitioned transcripts kept in memory.
+    /// </summary>
+    private const int PartitionCacheSize = 8;
+
+    private readonly ITokenizer _tokenizer;
+    private readonly int _maxDegreeOfParallelism;
     private readonly ISKFunction _summarizeConversationFunction;
     private readonly ISKFunction _conversationActionItemsFunction;
     private readonly ISKFunction _conversationTopicsFunction;
 
+    // Transcript hash => transcript chunks, and transcripts hashes in insertion order
+    private readonly Dictionary<string, IReadOnlyList<string>> _partitionCache = new(StringComparer.Ordinal);
+    private readonly Queue<string> _partitionCacheKeys = new();
+
     /// <summary>
     /// Initializes a new instance of the <see cref="ConversationSummarySkill"/> class.
     /// </summary>
     /// <param name="kernel">Kernel instance</param>
-    public ConversationSummarySkill(IKernel kernel)
+    /// <param name="tokenizer">Tokenizer used to split transcripts in chunks, by default an estimate not requiring a vocabulary</param>
+    /// <param name="maxDegreeOfParallelism">Max number of transcript chunks processed concurrently</param>
+    public ConversationSummarySkill(IKernel kernel, ITokenizer? tokenizer = null, int maxDegreeOfParallelism = DefaultMaxDegreeOfParallelism)
     {
+        if (maxDegreeOfParallelism < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxDegreeOfParallelism), "The max degree of parallelism must be greater than zero");
+        }
+
+        this._tokenizer = tokenizer ?? HeuristicTokenizer.Instance;
+        this._maxDegreeOfParallelism = maxDegreeOfParallelism;
+
         this._summarizeConversationFunction = kernel.CreateSemanticFunction(
             SemanticFunctionConstants.SummarizeConversationDefinition,
             skillName: nameof(ConversationSummarySkill),
@@ -69,11 +101,27 @@ public class ConversationSummarySkill
     [SKFunctionInput(Description = "A long conversation transcript.")]
     public Task<SKContext> SummarizeConversationAsync(string input, SKContext context)
     {
-        System.Collections.Generic.List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(input, MaxTokens);
-        System.Collections.Generic.List<string> paragraphs = SemanticTextPartitioner.SplitPlainTextParagraphs(lines, MaxTokens);
+        IReadOnlyList<string> paragraphs = this.GetPartitions(input);
 
         return this._summarizeConversationFunction
-            .AggregatePartitionedResultsAsync(paragraphs, context);
+            .AggregatePartitionedResultsAsync(paragraphs, context, this._maxDegreeOfParallelism);
+    }
+
+    /// <summary>
+    /// Given a very long conversation transcript, summarize the conversation, summarizing again
+    /// the partial summaries until the summary fits the max number of tokens.
+    /// </summary>
+    /// <param name="input">A very long conversation transcript.</param>
+    /// <param name="context">The SKContext for function execution.</param>
+    [SKFunction("Given a very long conversation transcript, summarize the conversation in a single short summary.")]
+    [SKFunctionName("SummarizeConversationRecursively")]
+    [SKFunctionInput(Description = "A very long conversation transcript.")]
+    public Task<SKContext> SummarizeConversationRecursivelyAsync(string input, SKContext context)
+    {
+        IReadOnlyList<string> paragraphs = this.GetPartitions(input);
+
+        return this._summarizeConversationFunction
+            .ReducePartitionedResultsAsync(paragraphs, context, this._tokenizer, MaxTokens, this._maxDegreeOfParallelism);
     }
 
     /// <summary>
@@ -86,11 +134,10 @@ public class ConversationSummarySkill
     [SKFunctionInput(Description = "A long conversation transcript.")]
     public Task<SKContext> GetConversationActionItemsAsync(string input, SKContext context)
     {
-        System.Collections.Generic.List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(input, MaxTokens);
-        System.Collections.Generic.List<string> paragraphs = SemanticTextPartitioner.SplitPlainTextParagraphs(lines, MaxTokens);
+        IReadOnlyList<string> paragraphs = this.GetPartitions(input);
 
         return this._conversationActionItemsFunction
-            .AggregatePartitionedResultsAsync(paragraphs, context);
+            .AggregatePartitionedResultsAsync(paragraphs, context, this._maxDegreeOfParallelism);
     }
 
     /// <summary>
@@ -103,10 +150,119 @@ public class ConversationSummarySkill
     [SKFunctionInput(Description = "A long conversation transcript.")]
     public Task<SKContext> GetConversationTopicsAsync(string input, SKContext context)
     {
-        System.Collections.Generic.List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(input, MaxTokens);
-        System.Collections.Generic.List<string> paragraphs = SemanticTextPartitioner.SplitPlainTextParagraphs(lines, MaxTokens);
+        IReadOnlyList<string> paragraphs = this.GetPartitions(input);
 
         return this._conversationTopicsFunction
-            .AggregatePartitionedResultsAsync(paragraphs, context);
+            .AggregatePartitionedResultsAsync(paragraphs, context, this._maxDegreeOfParallelism);
+    }
+
+    /// <summary>
+    /// Given a long conversation transcript, summarize the conversation, identify action items and identify topics,
+    /// splitting the transcript only once and running the three analyses concurrently.
+    /// The results are stored in the "summary", "actionItems" and "topics" variables, and the summary is also the output.
+    /// </summary>
+    /// <param name="input">A long conversation transcript.</param>
+    /// <param name="context">The SKContext for function execution.</param>
+    [SKFunction("Given a long conversation transcript, summarize the conversation, identify action items and topics worth remembering.")]
+    [SKFunctionName("AnalyzeConversation")]
+    [SKFunctionInput(Description = "A long conversation transcript.")]
+    public async Task<SKContext> AnalyzeConversationAsync(string input, SKContext context)
+    {
+        IReadOnlyList<string> paragraphs = this.GetPartitions(input);
+
+        // The first analysis failing cancels the other ones
+        using var cancellation = CancellationTokenSource.CreateLinkedTokenSource(context.CancellationToken);
+        SKContext? failure = null;
+
+        async Task<string> AnalyzeAsync(ISKFunction function)
+        {
+            try
+            {
+                SKContext result = await function.AggregatePartitionedResultsAsync(
+                    paragraphs, CreateChildContext(context, cancellation.Token), this._maxDegreeOfParallelism);
+                if (result.ErrorOccurred)
+                {
+                    Interlocked.CompareExchange(ref failure, result, null);
+                    cancellation.Cancel();
+                }
+
+                return result.Result;
+            }
+            catch (OperationCanceledException) when (failure != null && !context.CancellationToken.IsCancellationRequested)
+            {
+                return string.Empty;
+            }
+        }
+
+        string[] results = await Task.WhenAll(
+            AnalyzeAsync(this._summarizeConversationFunction),
+            AnalyzeAsync(this._conversationActionItemsFunction),
+            AnalyzeAsync(this._conversationTopicsFunction));
+
+        if (failure != null)
+        {
+            return context.Fail(failure.LastErrorDescription, failure.LastException);
+        }
+
+        context.Variables.Set(SummaryVariable, results[0]);
+        context.Variables.Set(ActionItemsVariable, results[1]);
+        context.Variables.Set(TopicsVariable, results[2]);
+        context.Variables.Update(results[0]);
+
+        return context;
     }
+
+    #region private ================================================================================
+
+    private const string SummaryVariable = "summary";
+    private const string ActionItemsVariable = "actionItems";
+    private const string TopicsVariable = "topics";
+
+    private static SKContext CreateChildContext(SKContext context, CancellationToken cancellationToken)
+    {
+        return new SKContext(context.Variables.Clone(), context.Memory, context.Skills, context.Log, cancellationToken);
+    }
+
+    /// <summary>
+    /// Split a transcript in chunks, reusing the chunks of recently processed transcripts.
+    /// The chunks are read-only, because they are shared by all the callers processing the same transcript.
+    /// </summary>
+    private IReadOnlyList<string> GetPartitions(string input)
+    {
+        string key = ComputeHash(input);
+        lock (this._partitionCache)
+        {
+            if (this._partitionCache.TryGetValue(key, out IReadOnlyList<string>? cached))
+            {
+                return cached;
+            }
+        }
+
+        List<string> lines = SemanticTextPartitioner.SplitPlainTextLines(input, MaxTokens, this._tokenizer);
+        IReadOnlyList<string> paragraphs = SemanticTextPartitioner.SplitPlainTextParagraphs(lines, MaxTokens, this._tokenizer).AsReadOnly();
+
+        lock (this._partitionCache)
+        {
+            if (!this._partitionCache.ContainsKey(key))
+            {
+                if (this._partitionCacheKeys.Count >= PartitionCacheSize)
+                {
+                    this._partitionCache.Remove(this._partitionCacheKeys.Dequeue());
+                }
+
+                this._partitionCache[key] = paragraphs;
+                this._partitionCacheKeys.Enqueue(key);
+            }
+        }
+
+        return paragraphs;
+    }
+
+    private static string ComputeHash(string input)
+    {
+        using var sha256 = SHA256.Create();
+        return Convert.ToBase64String(sha256.ComputeHash(Encoding.UTF8.GetBytes(input)));
+    }
+
+    #endregion
 }
@@ -5,6 +5,7 @@ using System.Collections.Generic;
 using System.Text.Json;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
+using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.Diagnostics;
 using Microsoft.SemanticKernel.KernelExtensions;
 using Microsoft.SemanticKernel.Orchestration;
@@ -37,7 +38,7 @@ public class PlannerSkill
     /// <summary>
     /// the functions to exclude from the skill collection
     /// </summary>
-    private static readonly List<string> s_excludedFunctions = new() { "CreatePlan", "ExecutePlan" };
+    private static readonly List<string> s_excludedFunctions = new() { "CreatePlan", "ExecutePlan", "RunPlan" };
 
     /// <summary>
     /// the function flow runner, which executes plans that leverage functions
@@ -54,14 +55,32 @@ public class PlannerSkill
     /// </summary>
     private readonly ISKFunction _functionFlowFunction;
 
+    /// <summary>
+    /// the cache of plans executed successfully, reused for similar goals
+    /// </summary>
+    private readonly PlanCache? _planCache;
+
+    /// <summary>
+    /// the index of the functions, used to describe in the prompt only the functions relevant to the goal
+    /// </summary>
+    private readonly FunctionIndex? _functionIndex;
+
     /// <summary>
     /// Initializes a new instance of the <see cref="PlannerSkill"/> class.
     /// </summary>
     /// <param name="kernel"> The kernel to use </param>
     /// <param name="maxTokens"> The maximum number of tokens to use for the semantic functions </param>
-    public PlannerSkill(IKernel kernel, int maxTokens = 1024)
+    /// <param name="planCache"> Optional cache of plans, to reuse plans executed successfully instead of creating new plans for similar goals </param>
+    /// <param name="functionIndex"> Optional index of the functions, to include in the plan prompt only the functions relevant to the goal </param>
+    /// <remarks>
+    /// The plan cache and the function index are not disposed by the planner. When they use the same embedding generator,
+    /// the goal is embedded only once.
+    /// </remarks>
+    public PlannerSkill(IKernel kernel, int maxTokens = 1024, PlanCache? planCache = null, FunctionIndex? functionIndex = null)
     {
         this._functionFlowRunner = new(kernel);
+        this._planCache = planCache;
+        this._functionIndex = functionIndex;
 
         this._bucketFunction = kernel.CreateSemanticFunction(
             promptTemplate: SemanticFunctionConstants.BucketFunctionDefinition,
@@ -164,22 +183,63 @@ public class PlannerSkill
     /// <returns> The context with the plan </returns>
     /// <remarks>
     /// The plan is stored in the context as a string. The plan is also stored in the context as a Plan object.
+    /// When a plan cache is used, the plan of a similar goal executed successfully is reused, if the available functions didn't change.
     /// </remarks>
     [SKFunction("Create a plan using registered functions to accomplish a goal.")]
     [SKFunctionName("CreatePlan")]
     public async Task<SKContext> CreatePlanAsync(SKContext context)
     {
         var goal = context.Variables.Input;
+        var planId = Guid.NewGuid().ToString("N");
 
-        string relevantFunctionsManual = context.GetFunctionsManual(s_excludedSkills, s_excludedFunctions);
-        context.Variables.Set("available_functions", relevantFunctionsManual);
+        string? plan = null;
+        string collection = string.Empty;
+        string cachedPlanId = string.Empty;
+        Embedding<float>? goalEmbedding = null;
+        if (this._planCache != null)
+        {
+            // Plans are grouped by all the functions available, not only the relevant ones, so that similar goals
+            // share plans. The manual is rebuilt, and hashed, only when the version of the skill collection changes.
+            collection = PlanCache.GetCollectionName(context.GetFunctionsManual(s_excludedSkills, s_excludedFunctions));
+            try
+            {
+                goalEmbedding = await this._planCache.GenerateEmbeddingAsync(goal, context.CancellationToken);
+                (plan, cachedPlanId) = await this._planCache.TryGetAsync(collection, goal, goalEmbedding.Value, context.CancellationToken);
+            }
+            catch (Exception e) when (!e.IsCriticalException() && !context.CancellationToken.IsCancellationRequested)
+            {
+                // Cache miss: the plan is created, and stored only if the goal embedding is available
+                context.Log.LogWarning(e, "Unable to look up the plan cache: {0}", e.Message);
+            }
+        }
 
-        var plan = await this._functionFlowFunction.InvokeAsync(context);
+        if (plan == null)
+        {
+            // The goal embedding is reused by the index only if generated by the same generator
+            Embedding<float>? indexGoalEmbedding = this._planCache != null && this._planCache.EmbeddingGenerator == this._functionIndex?.EmbeddingGenerator
+                ? goalEmbedding
+                : null;
+            string relevantFunctionsManual = await context.GetFunctionsManualAsync(
+                goal, this._functionIndex, s_excludedSkills, s_excludedFunctions, indexGoalEmbedding);
+            context.Variables.Set("available_functions", relevantFunctionsManual);
+
+            var result = await this._functionFlowFunction.InvokeAsync(context);
+            plan = result.ToString().Trim();
+            if (!result.ErrorOccurred && goalEmbedding.HasValue)
+            {
+                this._planCache?.AddPendingPlan(planId, collection, goal, goalEmbedding.Value, plan);
+            }
+        }
+        else
+        {
+            // A reused plan is removed from the cache if it fails
+            this._planCache!.AddPendingPlan(planId, collection, goal, goalEmbedding!.Value, plan, cachedPlanId);
+        }
 
-        string fullPlan = $"<{FunctionFlowRunner.GoalTag}>\n{goal}\n</{FunctionFlowRunner.GoalTag}>\n{plan.ToString().Trim()}";
+        string fullPlan = $"<{FunctionFlowRunner.GoalTag}>\n{goal}\n</{FunctionFlowRunner.GoalTag}>\n{plan}";
         _ = context.Variables.UpdateWithPlanEntry(new Plan
         {
-            Id = Guid.NewGuid().ToString("N"),
+            Id = planId,
             Goal = goal,
             PlanString = fullPlan,
         });
@@ -197,12 +257,43 @@ public class PlannerSkill
     /// </remarks>
     [SKFunction("Execute a plan that uses registered functions to accomplish a goal.")]
     [SKFunctionName("ExecutePlan")]
-    public async Task<SKContext> ExecutePlanAsync(SKContext context)
+    public Task<SKContext> ExecutePlanAsync(SKContext context)
+    {
+        return this.ExecutePlanAsync(context, plan => this._functionFlowRunner.ExecuteXmlPlanAsync(context, plan.PlanString));
+    }
+
+    /// <summary>
+    /// Execute all the steps of a plan that uses registered functions to accomplish a goal.
+    /// Unlike <see cref="ExecutePlanAsync(SKContext)"/>, which executes one step per call, the plan is parsed only once.
+    /// </summary>
+    /// <param name="context"> The context to use </param>
+    /// <returns> The context with the plan </returns>
+    /// <remarks>
+    /// The plan is stored in the context as a string. The plan is also stored in the context as a Plan object.
+    /// Independent steps run concurrently: when a step fails, the steps that ran with it stay in the plan and are
+    /// executed again when the plan is resumed.
+    /// </remarks>
+    [SKFunction("Execute all the steps of a plan that uses registered functions to accomplish a goal.")]
+    [SKFunctionName("RunPlan")]
+    [SKFunctionContextParameter(Name = MaxStepsParam, Description = "The maximum number of steps to execute.", DefaultValue = "")]
+    public Task<SKContext> RunPlanAsync(SKContext context)
+    {
+        int maxSteps = context.Variables.Get(MaxStepsParam, out string value) && int.TryParse(value, out int steps) ? steps : int.MaxValue;
+
+        return this.ExecutePlanAsync(context, plan => this._functionFlowRunner.ExecutePlanAsync(
+            this._functionFlowRunner.Compile(plan.PlanString, context), context, maxSteps));
+    }
+
+    #region private ================================================================================
+
+    private const string MaxStepsParam = "maxSteps";
+
+    private async Task<SKContext> ExecutePlanAsync(SKContext context, Func<Plan, Task<SKContext>> execute)
     {
         var planToExecute = context.Variables.ToPlan();
         try
         {
-            var executeResultContext = await this._functionFlowRunner.ExecuteXmlPlanAsync(context, planToExecute.PlanString);
+            var executeResultContext = await execute(planToExecute);
             _ = executeResultContext.Variables.Get(Plan.PlanKey, out var planProgress);
             _ = executeResultContext.Variables.Get(Plan.ResultKey, out var results);
 
@@ -211,6 +302,11 @@ public class PlannerSkill
             var isSuccessful = !executeResultContext.ErrorOccurred &&
                                planProgress.Contains($"<{FunctionFlowRunner.SolutionTag}>", StringComparison.InvariantCultureIgnoreCase);
 
+            if (isComplete || executeResultContext.ErrorOccurred)
+            {
+                await this.CompletePlanAsync(planToExecute, isComplete && isSuccessful, context);
+            }
+
             if (string.IsNullOrEmpty(results) && isComplete && isSuccessful)
             {
                 results = executeResultContext.Variables.ToString();
@@ -238,6 +334,7 @@ public class PlannerSkill
             {
                 case PlanningException.ErrorCodes.InvalidPlan:
                     context.Log.LogWarning("[InvalidPlan] Error executing plan: {0} ({1})", e.Message, e.GetType().Name);
+                    await this.CompletePlanAsync(planToExecute, false, context);
                     _ = context.Variables.UpdateWithPlanEntry(new Plan
                     {
                         Id = Guid.NewGuid().ToString("N"),
@@ -252,6 +349,7 @@ public class PlannerSkill
                 case PlanningException.ErrorCodes.UnknownError:
                 case PlanningException.ErrorCodes.InvalidConfiguration:
                     context.Log.LogWarning("[UnknownError] Error executing plan: {0} ({1})", e.Message, e.GetType().Name);
+                    await this.CompletePlanAsync(planToExecute, false, context);
                     break;
                 default:
                     throw;
@@ -260,6 +358,7 @@ public class PlannerSkill
         catch (Exception e) when (!e.IsCriticalException())
         {
             context.Log.LogWarning("Error executing plan: {0} ({1})", e.Message, e.GetType().Name);
+            await this.CompletePlanAsync(planToExecute, false, context);
             _ = context.Variables.UpdateWithPlanEntry(new Plan
             {
                 Id = Guid.NewGuid().ToString("N"),
@@ -275,4 +374,16 @@ public class PlannerSkill
 
         return context;
     }
+
+    /// <summary>
+    /// Stop tracking a plan in the plan cache: plans executed successfully are stored, reused plans that failed are removed.
+    /// </summary>
+    private Task CompletePlanAsync(Plan plan, bool isSuccessful, SKContext context)
+    {
+        if (this._planCache == null) { return Task.CompletedTask; }
+
+        return this._planCache.CompletePlanAsync(plan.Id, isSuccessful, context.CancellationToken);
+    }
+
+    #endregion
 }
@@ -142,6 +142,21 @@ public interface IKernel
         CancellationToken cancellationToken,
         params ISKFunction[] pipeline);
 
+    /// <summary>
+    /// Run a pipeline of functions with declared inputs and outputs, executing independent steps concurrently.
+    /// Each step receives a copy of the variables, updated with the outputs of the steps it depends on.
+    /// The returned context contains the output variables of all the steps, and the result of the last step.
+    /// When a step fails, the steps still running are cancelled and the context contains the error.
+    /// </summary>
+    /// <param name="pipeline">Pipeline to run</param>
+    /// <param name="variables">Input to process</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>Result of the pipeline</returns>
+    Task<SKContext> RunAsync(
+        Pipeline pipeline,
+        ContextVariables? variables = null,
+        CancellationToken cancellationToken = default);
+
     /// <summary>
     /// Access registered functions by skill + name. Not case sensitive.
     /// The function might be native or semantic, it's up to the caller handling it.
@@ -8,6 +8,7 @@ using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Extensions.Logging;
 using Microsoft.SemanticKernel.AI;
+using Microsoft.SemanticKernel.AI.Caching;
 using Microsoft.SemanticKernel.AI.OpenAI.Services;
 using Microsoft.SemanticKernel.Configuration;
 using Microsoft.SemanticKernel.Diagnostics;
@@ -196,6 +197,57 @@ public sealed class Kernel : IKernel, IDisposable
         return context;
     }
 
+    /// <inheritdoc/>
+    public async Task<SKContext> RunAsync(
+        Pipeline pipeline,
+        ContextVariables? variables = null,
+        CancellationToken cancellationToken = default)
+    {
+        Verify.NotNull(pipeline, "The pipeline cannot be NULL");
+        variables ??= new ContextVariables();
+
+        // Cancelled when a step fails, to stop the other branches
+        using var cancel = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken);
+        var run = new PipelineRun(pipeline, variables, cancel);
+
+        // Steps are added after their dependencies, so each step can wait for the tasks created before it
+        for (int i = 0; i < pipeline.Steps.Count; i++)
+        {
+            run.Steps[i] = this.RunPipelineStepAsync(run, i);
+        }
+
+        SKContext?[] results = await Task.WhenAll(run.Steps);
+
+        // Merge in pipeline order, so the result doesn't depend on which steps completed first
+        var context = new SKContext(
+            variables.Clone(),
+            this._memory,
+            this._skillCollection.ReadOnlySkillCollection,
+            this._log,
+            cancellationToken);
+
+        for (int i = 0; i < results.Length; i++)
+        {
+            SKContext? result = results[i];
+            if (result == null || result.ErrorOccurred) { continue; }
+
+            context.Variables.Set(pipeline.Steps[i].OutputVariable, result.Result);
+            context.Variables.Update(result.Result);
+        }
+
+        if (run.FirstFailure >= 0)
+        {
+            SKContext failed = results[run.FirstFailure]!;
+            context.Fail(failed.LastErrorDescription, failed.LastException);
+        }
+        else if (results.Any(x => x == null))
+        {
+            context.Fail("The pipeline has been cancelled", new OperationCanceledException(cancellationToken));
+        }
+
+        return context;
+    }
+
     /// <inheritdoc/>
     public ISKFunction Func(string skillName, string functionName)
     {
@@ -227,6 +279,16 @@ public sealed class Kernel : IKernel, IDisposable
 
         // ReSharper disable once SuspiciousTypeConversion.Global
         if (this._skillCollection is IDisposable reg) { reg.Dispose(); }
+
+        lock (this._backendClients)
+        {
+            foreach (ITextCompletionClient client in this._backendClients.Values)
+            {
+                if (client is IDisposable disposable) { disposable.Dispose(); }
+            }
+
+            this._backendClients.Clear();
+        }
     }
 
     #region private ================================================================================
@@ -237,6 +299,113 @@ public sealed class Kernel : IKernel, IDisposable
     private ISemanticTextMemory _memory;
     private readonly IPromptTemplateEngine _promptTemplateEngine;
 
+    // Completion clients shared by all the functions using the same backend, so that concurrent requests
+    // are batched together and share connections. The clients are disposed with the kernel.
+    private readonly Dictionary<IBackendConfig, ITextCompletionClient> _backendClients = new();
+
+    // Routers shared by the functions using the same backends, by backend labels
+    private readonly Dictionary<string, (IBackendConfig[] Backends, ITextCompletionClient Client)> _routers = new(StringComparer.OrdinalIgnoreCase);
+
+    /// <summary>
+    /// Client shared by multiple functions, hiding the inner client disposal from the functions.
+    /// </summary>
+    private sealed class SharedTextCompletionClient : ITextCompletionClient
+    {
+        internal SharedTextCompletionClient(ITextCompletionClient client)
+        {
+            this._client = client;
+        }
+
+        public Task<string> CompleteAsync(string text, CompleteRequestSettings requestSettings, CancellationToken cancellationToken = default)
+        {
+            return this._client.CompleteAsync(text, requestSettings, cancellationToken);
+        }
+
+        private readonly ITextCompletionClient _client;
+    }
+
+    private sealed class PipelineRun
+    {
+        internal PipelineRun(Pipeline pipeline, ContextVariables variables, CancellationTokenSource cancel)
+        {
+            this.Pipeline = pipeline;
+            this.Variables = variables;
+            this.Cancel = cancel;
+            this.Steps = new Task<SKContext?>[pipeline.Steps.Count];
+        }
+
+        internal Pipeline Pipeline { get; }
+
+        internal ContextVariables Variables { get; }
+
+        internal CancellationTokenSource Cancel { get; }
+
+        // NULL results are steps not executed, because a dependency failed or the pipeline has been cancelled
+        internal Task<SKContext?>[] Steps { get; }
+
+        internal int FirstFailure = -1;
+    }
+
+    private async Task<SKContext?> RunPipelineStepAsync(PipelineRun run, int index)
+    {
+        PipelineStep step = run.Pipeline.Steps[index];
+
+        SKContext?[] dependencies = await Task.WhenAll(step.Dependencies.Select(x => run.Steps[x]));
+        if (dependencies.Any(x => x == null || x.ErrorOccurred) || run.Cancel.IsCancellationRequested) { return null; }
+
+        // Native functions can block: return to the caller, i.e. the loop starting the steps or the step
+        // completing the dependencies, so that the other ready steps start without waiting for this one
+        await Task.Yield();
+
+        // Each branch works on its own copy of the variables
+        ContextVariables variables = run.Variables.Clone();
+        foreach (int ancestor in step.Ancestors)
+        {
+            SKContext result = (await run.Steps[ancestor])!;
+            variables.Set(run.Pipeline.Steps[ancestor].OutputVariable, result.Result);
+        }
+
+        if (step.InputVariables.Count > 0 && variables.Get(step.InputVariables[0], out string input))
+        {
+            variables.Update(input);
+        }
+
+        var context = new SKContext(
+            variables,
+            this._memory,
+            this._skillCollection.ReadOnlySkillCollection,
+            this._log,
+            run.Cancel.Token);
+
+        try
+        {
+            await this._config.RetryMechanism.ExecuteWithRetryAsync(
+                async () => { context = await step.Function.InvokeAsync(context); },
+                this._log,
+                run.Cancel.Token);
+        }
+#pragma warning disable CA1031 // We need to catch all exceptions to handle the execution state
+        catch (Exception e) when (!e.IsCriticalException())
+        {
+            context.Fail(e.Message, e);
+        }
+#pragma warning restore CA1031
+
+        if (context.ErrorOccurred)
+        {
+            // Steps cancelled because of this failure report it as the first failure
+            if (Interlocked.CompareExchange(ref run.FirstFailure, index, -1) == -1)
+            {
+                this._log.LogError(context.LastException,
+                    "Function call fail during pipeline step {0}: {1}.{2}. Error: {3}",
+                    index, step.Function.SkillName, step.Function.Name, context.LastErrorDescription);
+                run.Cancel.Cancel();
+            }
+        }
+
+        return context;
+    }
+
     private ISKFunction CreateSemanticFunction(
         string skillName,
         string functionName,
@@ -258,35 +427,135 @@ public sealed class Kernel : IKernel, IDisposable
         func.SetAIConfiguration(CompleteRequestSettings.FromCompletionConfig(functionConfig.PromptTemplateConfig.Completion));
 
         // TODO: allow to postpone this (e.g. use lazy init), allow to create semantic functions without a default backend
-        var backend = this._config.GetCompletionBackend(functionConfig.PromptTemplateConfig.DefaultBackends.FirstOrDefault());
+        // Requests are spread across all the backends listed only when the function opts in
+        List<string>? labels = functionConfig.PromptTemplateConfig.DefaultBackends;
+        IBackendConfig[] backends = labels is { Count: > 1 } && functionConfig.PromptTemplateConfig.RouteAcrossBackends
+            ? labels.Select(label => this._config.GetCompletionBackend(label)).Distinct().ToArray()
+            : new[] { this._config.GetCompletionBackend(labels?.FirstOrDefault()) };
+
+        foreach (IBackendConfig backend in backends)
+        {
+            if (backend is not AzureOpenAIConfig && backend is not OpenAIConfig)
+            {
+                throw new AIException(
+                    AIException.ErrorCodes.InvalidConfiguration,
+                    $"Unknown/unsupported backend configuration type {backend.GetType():G}, unable to prepare semantic function. " +
+                    $"Function description: {functionConfig.PromptTemplateConfig.Description}");
+            }
+        }
+
+        func.SetAIBackend(() => this.CreateCompletionClient(backends, functionConfig.PromptTemplateConfig.UseSemanticCache));
+
+        return func;
+    }
+
+    /// <summary>
+    /// Create the completion client of a semantic function, routing requests across the backends if there are
+    /// more than one, and adding batching and the completion caches when enabled. Exact matches are looked up
+    /// first, because they don't require generating an embedding, and only cache misses are batched.
+    /// </summary>
+    private ITextCompletionClient CreateCompletionClient(IBackendConfig[] backends, bool useSemanticCache)
+    {
+        ITextCompletionClient result = backends.Length == 1 ? this.GetBackendClient(backends[0]) : this.GetRouter(backends);
+
+        // The backends are equivalent, so the cache entries are shared by the functions using the same backends
+        string backendLabel = string.Join(",", backends.Select(x => x.Label));
+        string modelId = string.Join(",", backends.Select(GetModelId));
+
+        SemanticCompletionCache? semanticCache = this._config.SemanticCompletionCache;
+        if (useSemanticCache && semanticCache != null)
+        {
+            result = new SemanticCachedTextCompletion(result, semanticCache, backendLabel, modelId);
+        }
+
+        CompletionCache? cache = this._config.CompletionCache;
+        return cache == null ? result : new CachedTextCompletion(result, cache, backendLabel, modelId);
+    }
+
+    /// <summary>
+    /// Get the client shared by the functions using a backend, adding batching when enabled.
+    /// </summary>
+    private ITextCompletionClient GetBackendClient(IBackendConfig backend)
+    {
+        lock (this._backendClients)
+        {
+            if (!this._backendClients.TryGetValue(backend, out ITextCompletionClient? client))
+            {
+                client = this.CreateBackendClient(backend);
+                if (this._config.CompletionBatchSize > 1 && client is ITextBatchCompletionClient batchClient)
+                {
+                    client = new BatchingTextCompletion(
+                        batchClient, this._config.CompletionBatchSize, this._config.CompletionBatchDelay,
+                        this._config.CompletionTokenizer, GetModelId(backend));
+                }
 
+                this._backendClients[backend] = client;
+            }
+
+            return new SharedTextCompletionClient(client);
+        }
+    }
+
+    /// <summary>
+    /// Get the router shared by the functions using the same backends, so that the backends latency
+    /// and health are tracked across all the requests.
+    /// </summary>
+    private ITextCompletionClient GetRouter(IBackendConfig[] backends)
+    {
+        string key = string.Join("\n", backends.Select(x => x.Label));
+        lock (this._routers)
+        {
+            // The backends are compared too, in case a label has been registered again with a different configuration
+            if (!this._routers.TryGetValue(key, out (IBackendConfig[] Backends, ITextCompletionClient Client) router)
+                || !router.Backends.SequenceEqual(backends))
+            {
+                // The router doesn't own the shared backend clients, so it doesn't need to be disposed
+                router = (backends, new RoutingTextCompletionClient(backends.Select(this.GetBackendClient).ToList(), log: this._log));
+                this._routers[key] = router;
+            }
+
+            return new SharedTextCompletionClient(router.Client);
+        }
+    }
+
+    private ITextCompletionClient CreateBackendClient(IBackendConfig backend)
+    {
         switch (backend)
         {
             case AzureOpenAIConfig azureBackendConfig:
-                func.SetAIBackend(() => new AzureTextCompletion(
+                return new AzureTextCompletion(
                     azureBackendConfig.DeploymentName,
                     azureBackendConfig.Endpoint,
                     azureBackendConfig.APIKey,
                     azureBackendConfig.APIVersion,
-                    this._log));
-                break;
+                    this._log,
+                    this._config.HttpHandlerFactory,
+                    this._config.CompletionTokenizer);
 
             case OpenAIConfig openAiConfig:
-                func.SetAIBackend(() => new OpenAITextCompletion(
+                return new OpenAITextCompletion(
                     openAiConfig.ModelId,
                     openAiConfig.APIKey,
                     openAiConfig.OrgId,
-                    this._log));
-                break;
+                    this._log,
+                    this._config.HttpHandlerFactory,
+                    this._config.CompletionTokenizer);
 
             default:
                 throw new AIException(
                     AIException.ErrorCodes.InvalidConfiguration,
-                    $"Unknown/unsupported backend configuration type {backend.GetType():G}, unable to prepare semantic function. " +
-                    $"Function description: {functionConfig.PromptTemplateConfig.Description}");
+                    $"Unknown/unsupported backend configuration type {backend.GetType():G}");
         }
+    }
 
-        return func;
+    private static string GetModelId(IBackendConfig backend)
+    {
+        return backend switch
+        {
+            AzureOpenAIConfig azureBackendConfig => azureBackendConfig.DeploymentName,
+            OpenAIConfig openAiConfig => openAiConfig.ModelId,
+            _ => string.Empty
+        };
     }
 
     /// <summary>
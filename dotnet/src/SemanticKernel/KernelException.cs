@@ -59,6 +59,11 @@ public class KernelException : Exception<KernelException.ErrorCodes>
         /// Skill collection not set.
         /// </summary>
         SkillCollectionNotSet,
+
+        /// <summary>
+        /// Invalid pipeline definition.
+        /// </summary>
+        InvalidPipeline,
     }
 
     /// <summary>
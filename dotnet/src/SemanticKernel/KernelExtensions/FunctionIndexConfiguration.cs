@@ -0,0 +1,37 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Diagnostics.CodeAnalysis;
+using Microsoft.SemanticKernel.Planning;
+
+namespace Microsoft.SemanticKernel.KernelExtensions;
+
+/// <summary>
+/// Kernel extension to create the index of functions used by the planner to select the functions relevant to a goal
+/// </summary>
+public static class FunctionIndexConfiguration
+{
+    /// <summary>
+    /// Create an index of the functions using the kernel's default embeddings backend.
+    /// </summary>
+    /// <param name="kernel">Kernel instance</param>
+    /// <param name="maxFunctions">Max number of functions described in the plan prompt</param>
+    /// <returns>The function index, to pass to the planner, and to dispose when not needed anymore</returns>
+    public static FunctionIndex CreateFunctionIndex(this IKernel kernel, int maxFunctions = FunctionIndex.DefaultMaxFunctions)
+    {
+        return CreateFunctionIndex(kernel, kernel.Config.DefaultEmbeddingsBackend, maxFunctions);
+    }
+
+    /// <summary>
+    /// Create an index of the functions using the given embeddings backend.
+    /// </summary>
+    /// <param name="kernel">Kernel instance</param>
+    /// <param name="embeddingsBackendLabel">Kernel backend label for embedding generation</param>
+    /// <param name="maxFunctions">Max number of functions described in the plan prompt</param>
+    /// <returns>The function index, to pass to the planner, and to dispose when not needed anymore</returns>
+    [SuppressMessage("Reliability", "CA2000:Dispose objects before losing scope",
+        Justification = "The embedding generator is used for the lifetime of the index")]
+    public static FunctionIndex CreateFunctionIndex(this IKernel kernel, string? embeddingsBackendLabel, int maxFunctions = FunctionIndex.DefaultMaxFunctions)
+    {
+        return new FunctionIndex(MemoryConfiguration.CreateEmbeddingGenerator(kernel, embeddingsBackendLabel), maxFunctions);
+    }
+}
@@ -34,6 +34,32 @@ public static class MemoryConfiguration
     [SuppressMessage("Reliability", "CA2000:Dispose objects before losing scope",
         Justification = "The embeddingGenerator object is disposed by the kernel")]
     public static void UseMemory(this IKernel kernel, string? embeddingsBackendLabel, IMemoryStore<float> storage)
+    {
+        UseMemory(kernel, CreateEmbeddingGenerator(kernel, embeddingsBackendLabel), storage);
+    }
+
+    /// <summary>
+    /// Set the semantic memory to use the given memory storage and embedding generator.
+    /// </summary>
+    /// <param name="kernel">Kernel instance</param>
+    /// <param name="embeddingGenerator">Embedding generator</param>
+    /// <param name="storage">Memory storage</param>
+    [SuppressMessage("Reliability", "CA2000:Dispose objects before losing scope", Justification = "The embeddingGenerator object is disposed by the kernel")]
+    public static void UseMemory(this IKernel kernel, IEmbeddingGenerator<string, float> embeddingGenerator, IMemoryStore<float> storage)
+    {
+        Verify.NotNull(storage, "The storage instance provided is NULL");
+        Verify.NotNull(embeddingGenerator, "The embedding generator is NULL");
+
+        kernel.RegisterMemory(new SemanticTextMemory(storage, embeddingGenerator));
+    }
+
+    /// <summary>
+    /// Create the embedding generator of an embeddings backend configured in the kernel.
+    /// </summary>
+    /// <param name="kernel">Kernel instance</param>
+    /// <param name="embeddingsBackendLabel">Kernel backend label for embedding generation</param>
+    /// <returns>Embedding generator</returns>
+    internal static IEmbeddingGenerator<string, float> CreateEmbeddingGenerator(IKernel kernel, string? embeddingsBackendLabel)
     {
         Verify.NotEmpty(embeddingsBackendLabel, "The embedding backend label is empty");
 
@@ -51,7 +77,8 @@ public static class MemoryConfiguration
                     azureAIConfig.Endpoint,
                     azureAIConfig.APIKey,
                     azureAIConfig.APIVersion,
-                    kernel.Log);
+                    kernel.Log,
+                    kernel.Config.HttpHandlerFactory);
                 break;
 
             case OpenAIConfig openAIConfig:
@@ -59,30 +86,16 @@ public static class MemoryConfiguration
                     openAIConfig.ModelId,
                     openAIConfig.APIKey,
                     openAIConfig.OrgId,
-                    kernel.Log);
+                    kernel.Log,
+                    kernel.Config.HttpHandlerFactory);
                 break;
 
             default:
                 throw new AIException(
                     AIException.ErrorCodes.InvalidConfiguration,
-                    $"Unknown/unsupported backend type {embeddingsBackendCfg.GetType():G}, unable to prepare semantic memory");
+                    $"Unknown/unsupported backend type {embeddingsBackendCfg.GetType():G}, unable to prepare the embedding generator");
         }
 
-        UseMemory(kernel, embeddingGenerator, storage);
-    }
-
-    /// <summary>
-    /// Set the semantic memory to use the given memory storage and embedding generator.
-    /// </summary>
-    /// <param name="kernel">Kernel instance</param>
-    /// <param name="embeddingGenerator">Embedding generator</param>
-    /// <param name="storage">Memory storage</param>
-    [SuppressMessage("Reliability", "CA2000:Dispose objects before losing scope", Justification = "The embeddingGenerator object is disposed by the kernel")]
-    public static void UseMemory(this IKernel kernel, IEmbeddingGenerator<string, float> embeddingGenerator, IMemoryStore<float> storage)
-    {
-        Verify.NotNull(storage, "The storage instance provided is NULL");
-        Verify.NotNull(embeddingGenerator, "The embedding generator is NULL");
-
-        kernel.RegisterMemory(new SemanticTextMemory(storage, embeddingGenerator));
+        return embeddingGenerator;
     }
 }
@@ -70,6 +70,42 @@ public interface ISemanticTextMemory
         double minRelevanceScore = 0.7,
         CancellationToken cancel = default);
 
+    /// <summary>
+    /// Find some information in memory, using the given search strategy.
+    /// </summary>
+    /// <param name="collection">Collection to search</param>
+    /// <param name="query">What to search for</param>
+    /// <param name="mode">Search strategy: semantic, lexical (keywords) or hybrid</param>
+    /// <param name="limit">How many results to return</param>
+    /// <param name="minRelevanceScore">Minimum relevance score, from 0 to 1, where 1 means exact match.
+    /// In lexical mode the relevance is relative to the best match. In hybrid mode the threshold applies
+    /// to the semantic candidates only.</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>Memories found</returns>
+    public IAsyncEnumerable<MemoryQueryResult> SearchAsync(
+        string collection,
+        string query,
+        MemorySearchMode mode,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        CancellationToken cancel = default);
+
+    /// <summary>
+    /// Find some information in memory for each of the given queries, scanning the memory once for all of them.
+    /// </summary>
+    /// <param name="collection">Collection to search</param>
+    /// <param name="queries">What to search for</param>
+    /// <param name="limit">How many results to return for each query</param>
+    /// <param name="minRelevanceScore">Minimum relevance score, from 0 to 1, where 1 means exact match.</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>Memories found for each query, in the same order as the queries</returns>
+    public Task<IList<IList<MemoryQueryResult>>> SearchBatchAsync(
+        string collection,
+        IList<string> queries,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        CancellationToken cancel = default);
+
     /// <summary>
     /// Gets a group of all available collection names.
     /// </summary>
@@ -0,0 +1,197 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Microsoft.SemanticKernel.Memory.Lexical;
+
+/// <summary>
+/// In-memory inverted index ranking documents with Okapi BM25.
+/// The index is updated incrementally and is safe to use from multiple threads.
+/// </summary>
+/// <remarks>
+/// https://en.wikipedia.org/wiki/Okapi_BM25
+/// </remarks>
+internal sealed class BM25Index
+{
+    /// <summary>
+    /// Term frequency saturation parameter.
+    /// </summary>
+    internal const double K1 = 1.2;
+
+    /// <summary>
+    /// Document length normalization parameter.
+    /// </summary>
+    internal const double B = 0.75;
+
+    /// <summary>
+    /// Number of documents in the index.
+    /// </summary>
+    public int Count
+    {
+        get
+        {
+            lock (this._lock) { return this._documentLengths.Count; }
+        }
+    }
+
+    /// <summary>
+    /// Add a document to the index, replacing any previous version of the same document.
+    /// </summary>
+    /// <param name="id">Document identifier</param>
+    /// <param name="text">Document content</param>
+    public void Upsert(string id, string text)
+    {
+        // Tokenize outside of the lock, it's the expensive part
+        var termFrequencies = new Dictionary<string, int>(StringComparer.Ordinal);
+        int length = 0;
+        foreach (string term in Tokenize(text))
+        {
+            termFrequencies.TryGetValue(term, out int tf);
+            termFrequencies[term] = tf + 1;
+            length++;
+        }
+
+        lock (this._lock)
+        {
+            this.RemoveInternal(id);
+
+            foreach (KeyValuePair<string, int> tf in termFrequencies)
+            {
+                if (!this._postings.TryGetValue(tf.Key, out var posting))
+                {
+                    posting = new Dictionary<string, int>(StringComparer.Ordinal);
+                    this._postings[tf.Key] = posting;
+                }
+
+                posting[id] = tf.Value;
+            }
+
+            this._documentTerms[id] = termFrequencies.Keys.ToArray();
+            this._documentLengths[id] = length;
+            this._totalLength += length;
+        }
+    }
+
+    /// <summary>
+    /// Remove a document from the index.
+    /// </summary>
+    /// <param name="id">Document identifier</param>
+    public void Remove(string id)
+    {
+        lock (this._lock)
+        {
+            this.RemoveInternal(id);
+        }
+    }
+
+    /// <summary>
+    /// Find the documents matching at least one of the query terms, sorted by BM25 score.
+    /// </summary>
+    /// <param name="query">Keywords to search for</param>
+    /// <param name="limit">Max number of results</param>
+    /// <returns>Document IDs and BM25 scores, highest score first</returns>
+    public IList<(string Id, double Score)> Search(string query, int limit)
+    {
+        if (limit < 1) { return Array.Empty<(string, double)>(); }
+
+        var queryTerms = new HashSet<string>(Tokenize(query), StringComparer.Ordinal);
+        var scores = new Dictionary<string, double>(StringComparer.Ordinal);
+
+        lock (this._lock)
+        {
+            int documentCount = this._documentLengths.Count;
+            if (documentCount == 0 || queryTerms.Count == 0) { return Array.Empty<(string, double)>(); }
+
+            double averageLength = Math.Max(1.0, (double)this._totalLength / documentCount);
+
+            foreach (string term in queryTerms)
+            {
+                if (!this._postings.TryGetValue(term, out var posting)) { continue; }
+
+                double idf = Math.Log(1 + ((documentCount - posting.Count + 0.5) / (posting.Count + 0.5)));
+                foreach (KeyValuePair<string, int> doc in posting)
+                {
+                    double tf = doc.Value;
+                    double norm = K1 * (1 - B + (B * this._documentLengths[doc.Key] / averageLength));
+                    double termScore = idf * (tf * (K1 + 1)) / (tf + norm);
+
+                    scores.TryGetValue(doc.Key, out double score);
+                    scores[doc.Key] = score + termScore;
+                }
+            }
+        }
+
+        return scores
+            .OrderByDescending(x => x.Value)
+            .ThenBy(x => x.Key, StringComparer.Ordinal)
+            .Take(limit)
+            .Select(x => (x.Key, x.Value))
+            .ToList();
+    }
+
+    /// <summary>
+    /// Split text into lowercase terms, using any char other than letters and digits as a separator.
+    /// </summary>
+    /// <param name="text">Text to tokenize</param>
+    /// <returns>List of terms</returns>
+    internal static IEnumerable<string> Tokenize(string? text)
+    {
+        if (string.IsNullOrEmpty(text)) { yield break; }
+
+        int start = -1;
+        for (int i = 0; i <= text!.Length; i++)
+        {
+            bool isTermChar = i < text.Length && char.IsLetterOrDigit(text[i]);
+            if (isTermChar)
+            {
+                if (start < 0) { start = i; }
+
+                continue;
+            }
+
+            if (start >= 0)
+            {
+                yield return text.Substring(start, i - start).ToLowerInvariant();
+                start = -1;
+            }
+        }
+    }
+
+    #region private ================================================================================
+
+    private readonly object _lock = new();
+
+    // term => (document ID => term frequency)
+    private readonly Dictionary<string, Dictionary<string, int>> _postings = new(StringComparer.Ordinal);
+
+    // document ID => distinct terms, used to clean up the postings when a document is replaced
+    private readonly Dictionary<string, string[]> _documentTerms = new(StringComparer.Ordinal);
+
+    // document ID => number of terms
+    private readonly Dictionary<string, int> _documentLengths = new(StringComparer.Ordinal);
+
+    private long _totalLength;
+
+    private void RemoveInternal(string id)
+    {
+        if (!this._documentTerms.TryGetValue(id, out string[]? terms)) { return; }
+
+        foreach (string term in terms)
+        {
+            if (this._postings.TryGetValue(term, out var posting)
+                && posting.Remove(id)
+                && posting.Count == 0)
+            {
+                this._postings.Remove(term);
+            }
+        }
+
+        this._totalLength -= this._documentLengths[id];
+        this._documentLengths.Remove(id);
+        this._documentTerms.Remove(id);
+    }
+
+    #endregion
+}
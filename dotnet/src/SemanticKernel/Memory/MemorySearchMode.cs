@@ -0,0 +1,25 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+namespace Microsoft.SemanticKernel.Memory;
+
+/// <summary>
+/// Strategy used to search the semantic memory.
+/// </summary>
+public enum MemorySearchMode
+{
+    /// <summary>
+    /// Embedding similarity search. Requires an embedding for the query.
+    /// </summary>
+    Semantic = 0,
+
+    /// <summary>
+    /// Keyword search over the memory text and description, ranked with BM25.
+    /// Does not require an embedding for the query.
+    /// </summary>
+    Lexical = 1,
+
+    /// <summary>
+    /// Semantic and lexical search, merged with reciprocal rank fusion.
+    /// </summary>
+    Hybrid = 2,
+}
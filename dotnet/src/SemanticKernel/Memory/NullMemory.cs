@@ -60,6 +60,30 @@ public sealed class NullMemory : ISemanticTextMemory
         return AsyncEnumerable.Empty<MemoryQueryResult>();
     }
 
+    /// <inheritdoc/>
+    public IAsyncEnumerable<MemoryQueryResult> SearchAsync(
+        string collection,
+        string query,
+        MemorySearchMode mode,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        CancellationToken cancel = default)
+    {
+        return AsyncEnumerable.Empty<MemoryQueryResult>();
+    }
+
+    /// <inheritdoc/>
+    public Task<IList<IList<MemoryQueryResult>>> SearchBatchAsync(
+        string collection,
+        IList<string> queries,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        CancellationToken cancel = default)
+    {
+        IList<IList<MemoryQueryResult>> result = queries.Select(_ => new List<MemoryQueryResult>() as IList<MemoryQueryResult>).ToList();
+        return Task.FromResult(result);
+    }
+
     /// <inheritdoc/>
     public Task<IList<string>> GetCollectionsAsync(
         CancellationToken cancel = default)
@@ -1,12 +1,15 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
 using System.Runtime.CompilerServices;
 using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Memory.Lexical;
 using Microsoft.SemanticKernel.Memory.Storage;
 
 namespace Microsoft.SemanticKernel.Memory;
@@ -14,6 +17,12 @@ namespace Microsoft.SemanticKernel.Memory;
 /// <summary>
 /// Implementation of <see cref="ISemanticTextMemory"/>./>.
 /// </summary>
+/// <remarks>
+/// Lexical and hybrid searches use a BM25 index kept in memory, one per collection. The index is
+/// loaded from the storage the first time a collection is searched, and then kept up to date by
+/// the Save methods of this instance. Records written to the storage by other clients after the
+/// index has been loaded are not visible to lexical searches.
+/// </remarks>
 public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
 {
     private readonly IEmbeddingGenerator<string, float> _embeddingGenerator;
@@ -35,10 +44,11 @@ public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
         string? description = null,
         CancellationToken cancel = default)
     {
-        var embeddings = await this._embeddingGenerator.GenerateEmbeddingAsync(text);
+        var embeddings = await this._embeddingGenerator.GenerateEmbeddingAsync(text, cancel);
         MemoryRecord data = MemoryRecord.LocalRecord(id, text, description, embeddings);
 
         await this._storage.PutValueAsync(collection, key: id, value: data, cancel: cancel);
+        await this.UpdateLexicalIndexAsync(collection, data);
     }
 
     /// <inheritdoc/>
@@ -50,10 +60,11 @@ public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
         string? description = null,
         CancellationToken cancel = default)
     {
-        var embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(text);
+        var embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(text, cancel);
         var data = MemoryRecord.ReferenceRecord(externalId: externalId, sourceName: externalSourceName, description, embedding);
 
         await this._storage.PutValueAsync(collection, key: externalId, value: data, cancel: cancel);
+        await this.UpdateLexicalIndexAsync(collection, data);
     }
 
     /// <inheritdoc/>
@@ -79,7 +90,7 @@ public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
         double minRelevanceScore = 0.7,
         [EnumeratorCancellation] CancellationToken cancel = default)
     {
-        Embedding<float> queryEmbedding = await this._embeddingGenerator.GenerateEmbeddingAsync(query);
+        Embedding<float> queryEmbedding = await this._embeddingGenerator.GenerateEmbeddingAsync(query, cancel);
 
         IAsyncEnumerable<(IEmbeddingWithMetadata<float>, double)> results = this._storage.GetNearestMatchesAsync(
             collection, queryEmbedding, limit: limit, minRelevanceScore: minRelevanceScore);
@@ -90,6 +101,63 @@ public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
         }
     }
 
+    /// <inheritdoc/>
+    public async IAsyncEnumerable<MemoryQueryResult> SearchAsync(
+        string collection,
+        string query,
+        MemorySearchMode mode,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        [EnumeratorCancellation] CancellationToken cancel = default)
+    {
+        IAsyncEnumerable<MemoryQueryResult> results;
+        switch (mode)
+        {
+            case MemorySearchMode.Semantic:
+                results = this.SearchAsync(collection, query, limit, minRelevanceScore, cancel);
+                break;
+
+            case MemorySearchMode.Lexical:
+                results = this.LexicalSearchAsync(collection, query, limit, minRelevanceScore, cancel);
+                break;
+
+            case MemorySearchMode.Hybrid:
+                results = this.HybridSearchAsync(collection, query, limit, minRelevanceScore, cancel);
+                break;
+
+            default:
+                throw new ArgumentOutOfRangeException(nameof(mode), mode, "Unknown search mode");
+        }
+
+        await foreach (MemoryQueryResult result in results.WithCancellation(cancel))
+        {
+            yield return result;
+        }
+    }
+
+    /// <inheritdoc/>
+    public async Task<IList<IList<MemoryQueryResult>>> SearchBatchAsync(
+        string collection,
+        IList<string> queries,
+        int limit = 1,
+        double minRelevanceScore = 0.7,
+        CancellationToken cancel = default)
+    {
+        Verify.NotNull(queries, "The list of queries cannot be NULL");
+        if (queries.Count == 0) { return new List<IList<MemoryQueryResult>>(); }
+
+        IList<Embedding<float>> queryEmbeddings = await this._embeddingGenerator.GenerateEmbeddingsAsync(queries, cancel);
+
+        IList<IList<(IEmbeddingWithMetadata<float>, double)>> results = await this._storage.GetNearestMatchesBatchAsync(
+            collection, queryEmbeddings, limit: limit, minRelevanceScore: minRelevanceScore, cancel: cancel);
+
+        return results
+            .Select(matches => (IList<MemoryQueryResult>)matches
+                .Select(x => MemoryQueryResult.FromMemoryRecord((MemoryRecord)x.Item1, x.Item2))
+                .ToList())
+            .ToList();
+    }
+
     /// <inheritdoc/>
     public async Task<IList<string>> GetCollectionsAsync(CancellationToken cancel = default)
     {
@@ -104,4 +172,163 @@ public sealed class SemanticTextMemory : ISemanticTextMemory, IDisposable
         // ReSharper disable once SuspiciousTypeConversion.Global
         if (this._storage is IDisposable storage) { storage.Dispose(); }
     }
+
+    #region private ================================================================================
+
+    /// <summary>
+    /// Constant used by reciprocal rank fusion to dampen the weight of the top ranks.
+    /// </summary>
+    private const int RrfK = 60;
+
+    /// <summary>
+    /// How many candidates each search strategy contributes to the hybrid search, relative to the requested limit.
+    /// </summary>
+    private const int HybridCandidatesFactor = 4;
+
+    // Collection name => BM25 index, loaded on first use
+    private readonly ConcurrentDictionary<string, Lazy<Task<BM25Index>>> _lexicalIndexes = new(StringComparer.Ordinal);
+
+    private async IAsyncEnumerable<MemoryQueryResult> LexicalSearchAsync(
+        string collection,
+        string query,
+        int limit,
+        double minRelevanceScore,
+        [EnumeratorCancellation] CancellationToken cancel)
+    {
+        IList<(MemoryRecord Record, double Score)> matches = await this.GetLexicalMatchesAsync(collection, query, limit, cancel);
+        if (matches.Count == 0) { yield break; }
+
+        // BM25 scores are unbounded: the relevance is computed relative to the best match
+        double topScore = matches[0].Score;
+        foreach ((MemoryRecord record, double score) in matches)
+        {
+            double relevance = score / topScore;
+            if (relevance < minRelevanceScore) { break; }
+
+            yield return MemoryQueryResult.FromMemoryRecord(record, relevance);
+        }
+    }
+
+    private async IAsyncEnumerable<MemoryQueryResult> HybridSearchAsync(
+        string collection,
+        string query,
+        int limit,
+        double minRelevanceScore,
+        [EnumeratorCancellation] CancellationToken cancel)
+    {
+        if (limit < 1) { yield break; }
+
+        int candidates = limit * HybridCandidatesFactor;
+
+        Task<IList<(MemoryRecord Record, double Score)>> lexicalTask = this.GetLexicalMatchesAsync(collection, query, candidates, cancel);
+        List<MemoryQueryResult> semantic = await this.SearchAsync(collection, query, candidates, minRelevanceScore, cancel).ToListAsync(cancel);
+        IList<(MemoryRecord Record, double Score)> lexical = await lexicalTask;
+
+        var fused = new Dictionary<string, (MemoryQueryResult Result, double Score)>(StringComparer.Ordinal);
+        for (int rank = 0; rank < semantic.Count; rank++)
+        {
+            fused[semantic[rank].Id] = (semantic[rank], 1.0 / (RrfK + rank + 1));
+        }
+
+        for (int rank = 0; rank < lexical.Count; rank++)
+        {
+            MemoryRecord record = lexical[rank].Record;
+            double score = 1.0 / (RrfK + rank + 1);
+            fused[record.Id] = fused.TryGetValue(record.Id, out var existing)
+                ? (existing.Result, existing.Score + score)
+                : (MemoryQueryResult.FromMemoryRecord(record, 0), score);
+        }
+
+        // A record ranked first by both strategies gets relevance 1
+        const double MaxScore = 2.0 / (RrfK + 1);
+        foreach (var item in fused.Values.OrderByDescending(x => x.Score).Take(limit))
+        {
+            MemoryQueryResult r = item.Result;
+            yield return new MemoryQueryResult(r.IsReference, r.ExternalSourceName, r.Id, r.Description, r.Text, item.Score / MaxScore);
+        }
+    }
+
+    private async Task<IList<(MemoryRecord Record, double Score)>> GetLexicalMatchesAsync(
+        string collection,
+        string query,
+        int limit,
+        CancellationToken cancel)
+    {
+        BM25Index index = await this.GetLexicalIndexAsync(collection, cancel);
+
+        var result = new List<(MemoryRecord, double)>();
+        foreach ((string id, double score) in index.Search(query, limit))
+        {
+            DataEntry<IEmbeddingWithMetadata<float>>? entry = await this._storage.GetAsync(collection, id, cancel);
+            if (entry?.Value is not MemoryRecord record)
+            {
+                // The record has been removed from the storage
+                index.Remove(id);
+                continue;
+            }
+
+            result.Add((record, score));
+        }
+
+        return result;
+    }
+
+    private Task<BM25Index> GetLexicalIndexAsync(string collection, CancellationToken cancel)
+    {
+        // The index is shared by all the searches, so its loading is not bound to the caller cancellation token
+        Lazy<Task<BM25Index>> index = this._lexicalIndexes.GetOrAdd(collection,
+            c => new Lazy<Task<BM25Index>>(() => this.LoadLexicalIndexAsync(c)));
+
+        Task<BM25Index> task = index.Value;
+
+        // Don't cache failures, so the next search can retry
+        if (task.IsFaulted || task.IsCanceled)
+        {
+            ((ICollection<KeyValuePair<string, Lazy<Task<BM25Index>>>>)this._lexicalIndexes).Remove(
+                new KeyValuePair<string, Lazy<Task<BM25Index>>>(collection, index));
+        }
+
+        cancel.ThrowIfCancellationRequested();
+        return task;
+    }
+
+    private async Task<BM25Index> LoadLexicalIndexAsync(string collection)
+    {
+        var index = new BM25Index();
+        await foreach (DataEntry<IEmbeddingWithMetadata<float>> entry in this._storage.GetAllAsync(collection))
+        {
+            if (entry.Value is MemoryRecord record)
+            {
+                index.Upsert(entry.Key, GetLexicalContent(record));
+            }
+        }
+
+        return index;
+    }
+
+    private async Task UpdateLexicalIndexAsync(string collection, MemoryRecord record)
+    {
+        // Collections not loaded yet will read the new record from the storage
+        if (!this._lexicalIndexes.TryGetValue(collection, out Lazy<Task<BM25Index>>? index)
+            || !index.IsValueCreated) { return; }
+
+        // If the index is still loading, wait for it, the record might have been read before being updated
+        Task<BM25Index> load = index.Value;
+        await Task.WhenAny(load);
+
+        // If the index failed to load, it will be reloaded from the storage on the next search
+        if (load.Status == TaskStatus.RanToCompletion)
+        {
+            load.Result.Upsert(record.Id, GetLexicalContent(record));
+        }
+    }
+
+    private static string GetLexicalContent(MemoryRecord record)
+    {
+        return string.IsNullOrEmpty(record.Description)
+            ? record.Text
+            : $"{record.Text}\n{record.Description}";
+    }
+
+    #endregion
 }
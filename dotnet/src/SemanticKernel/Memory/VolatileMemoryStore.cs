@@ -1,9 +1,14 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+using System.Threading.Tasks;
 using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
+using Microsoft.SemanticKernel.Diagnostics;
 using Microsoft.SemanticKernel.Memory.Storage;
 
 namespace Microsoft.SemanticKernel.Memory;
@@ -23,101 +28,166 @@ public class VolatileMemoryStore<TEmbedding> : VolatileDataStore<IEmbeddingWithM
         int limit = 1,
         double minRelevanceScore = 0)
     {
-        IEnumerable<DataEntry<IEmbeddingWithMetadata<TEmbedding>>>? embeddingCollection = null;
-        if (this.TryGetCollection(collection, out var collectionDict))
+        IList<(IEmbeddingWithMetadata<TEmbedding>, double)> matches = this.GetNearestMatches(
+            collection, new[] { embedding }, limit, minRelevanceScore, CancellationToken.None)[0];
+
+        return matches.ToAsyncEnumerable();
+    }
+
+    /// <inheritdoc/>
+    public Task<IList<IList<(IEmbeddingWithMetadata<TEmbedding>, double)>>> GetNearestMatchesBatchAsync(
+        string collection,
+        IList<Embedding<TEmbedding>> embeddings,
+        int limit = 1,
+        double minRelevanceScore = 0,
+        CancellationToken cancel = default)
+    {
+        Verify.NotNull(embeddings, "The list of embeddings cannot be NULL");
+
+        return Task.FromResult(this.GetNearestMatches(collection, embeddings.ToArray(), limit, minRelevanceScore, cancel));
+    }
+
+    #region private ================================================================================
+
+    /// <summary>
+    /// Size in bytes of the block of records scored at once against all the queries, chosen to fit in the CPU cache.
+    /// </summary>
+    private const int RecordBlockBytes = 128 * 1024;
+
+    private static readonly int s_embeddingItemSize = Marshal.SizeOf<TEmbedding>();
+
+    /// <summary>
+    /// Score all the records in a collection against a list of queries, keeping the top N records for each query.
+    /// </summary>
+    private IList<IList<(IEmbeddingWithMetadata<TEmbedding>, double)>> GetNearestMatches(
+        string collection,
+        Embedding<TEmbedding>[] queries,
+        int limit,
+        double minRelevanceScore,
+        CancellationToken cancel)
+    {
+        var topN = new TopNCollection<IEmbeddingWithMetadata<TEmbedding>>[queries.Length];
+        for (int q = 0; q < queries.Length; q++)
         {
-            embeddingCollection = collectionDict.Values;
+            topN[q] = new TopNCollection<IEmbeddingWithMetadata<TEmbedding>>(limit);
         }
 
-        if (embeddingCollection == null || !embeddingCollection.Any())
+        if (queries.Length == 0 || limit < 1 || !this.TryGetCollection(collection, out var collectionDict))
         {
-            return AsyncEnumerable.Empty<(IEmbeddingWithMetadata<TEmbedding>, double)>();
+            return topN.Select(x => x.ToList()).ToArray();
         }
 
-        EmbeddingReadOnlySpan<TEmbedding> embeddingSpan = new(embedding.AsReadOnlySpan());
-
-        TopNSortedList<IEmbeddingWithMetadata<TEmbedding>> sortedEmbeddings = new(limit);
-        foreach (var item in embeddingCollection)
+        double[] queryLengths = queries.Select(x => x.AsReadOnlySpan().EuclideanLength()).ToArray();
+        int blockSize = Math.Max(CosineSimilarityBatchOperation.QueryGroupSize,
+            RecordBlockBytes / Math.Max(1, queries[0].Count * s_embeddingItemSize));
+        blockSize = Math.Max(1, Math.Min(blockSize, collectionDict.Count));
+
+        // Records are scored one block at a time while enumerating the collection, without copying the whole collection
+        var records = new IEmbeddingWithMetadata<TEmbedding>[blockSize];
+        var recordEmbeddings = new Embedding<TEmbedding>[blockSize];
+        double[] scores = new double[blockSize * queries.Length];
+        int count = 0;
+        foreach (KeyValuePair<string, DataEntry<IEmbeddingWithMetadata<TEmbedding>>> entry in collectionDict)
         {
-            if (item.Value != null)
+            if (entry.Value.Value == null) { continue; }
+
+            records[count] = entry.Value.Value;
+            recordEmbeddings[count] = entry.Value.Value.Embedding;
+            if (++count == blockSize)
             {
-                EmbeddingReadOnlySpan<TEmbedding> itemSpan = new(item.Value.Embedding.AsReadOnlySpan());
-                double similarity = embeddingSpan.CosineSimilarity(itemSpan);
-                if (similarity >= minRelevanceScore)
-                {
-                    sortedEmbeddings.Add(similarity, item.Value);
-                }
+                cancel.ThrowIfCancellationRequested();
+                ScoreBlock(records, recordEmbeddings, count, queries, queryLengths, scores, minRelevanceScore, topN);
+                count = 0;
             }
         }
 
-        return sortedEmbeddings.Select(x => (x.Value, x.Key)).ToAsyncEnumerable();
-    }
+        if (count > 0)
+        {
+            ScoreBlock(records, recordEmbeddings, count, queries, queryLengths, scores, minRelevanceScore, topN);
+        }
 
-    #region private ================================================================================
+        return topN.Select(x => x.ToList()).ToArray();
+    }
 
     /// <summary>
-    /// Calculates the cosine similarity between an <see cref="Embedding{TEmbedding}"/> and an <see cref="IEmbeddingWithMetadata{TEmbedding}"/>
+    /// Score a block of records against all the queries, adding the records relevant enough to the top N of each query.
     /// </summary>
-    /// <param name="embedding">The input <see cref="Embedding{TEmbedding}"/> to be compared.</param>
-    /// <param name="embeddingWithData">The input <see cref="IEmbeddingWithMetadata{TEmbedding}"/> to be compared.</param>
-    /// <returns>A tuple consisting of the <see cref="IEmbeddingWithMetadata{TEmbedding}"/> cosine similarity result.</returns>
-    private (IEmbeddingWithMetadata<TEmbedding>, double) PairEmbeddingWithSimilarity(Embedding<TEmbedding> embedding,
-        IEmbeddingWithMetadata<TEmbedding> embeddingWithData)
+    private static void ScoreBlock(
+        IEmbeddingWithMetadata<TEmbedding>[] records,
+        Embedding<TEmbedding>[] recordEmbeddings,
+        int count,
+        Embedding<TEmbedding>[] queries,
+        double[] queryLengths,
+        double[] scores,
+        double minRelevanceScore,
+        TopNCollection<IEmbeddingWithMetadata<TEmbedding>>[] topN)
     {
-        var similarity = embedding.Vector.ToArray().CosineSimilarity(embeddingWithData.Embedding.Vector.ToArray());
-        return (embeddingWithData, similarity);
+        CosineSimilarityBatchOperation.CosineSimilarityBlock<TEmbedding>(
+            recordEmbeddings.AsSpan(0, count), queries, queryLengths, scores);
+
+        for (int q = 0; q < queries.Length; q++)
+        {
+            for (int r = 0; r < count; r++)
+            {
+                double similarity = scores[(q * count) + r];
+                if (similarity >= minRelevanceScore)
+                {
+                    topN[q].Add(similarity, records[r]);
+                }
+            }
+        }
     }
 
     /// <summary>
-    /// A sorted list that only keeps the top N items.
+    /// A list sorted by score, descending, that only keeps the top N items.
+    /// Items with the same score are kept in insertion order.
     /// </summary>
-    /// <typeparam name="T"></typeparam>
-    private class TopNSortedList<T> : SortedList<double, T>
+    /// <typeparam name="T">Type of the items</typeparam>
+    private sealed class TopNCollection<T>
     {
         /// <summary>
-        /// Creates an instance of the <see cref="TopNSortedList{T}"/> class.
+        /// Creates an instance of the <see cref="TopNCollection{T}"/> class.
         /// </summary>
-        /// <param name="maxSize"></param>
-        public TopNSortedList(int maxSize)
-            : base(new DescendingDoubleComparer())
+        /// <param name="maxSize">Max number of items to keep</param>
+        public TopNCollection(int maxSize)
         {
             this._maxSize = maxSize;
+            this._items = new List<(T, double)>(Math.Min(maxSize, 64));
         }
 
         /// <summary>
-        /// Adds a new item to the list.
+        /// Adds a new item to the list, if its score is high enough.
         /// </summary>
         /// <param name="score">The item's score</param>
         /// <param name="value">The item's value</param>
-        public new void Add(double score, T value)
+        public void Add(double score, T value)
         {
-            if (this.Count >= this._maxSize)
+            if (this._maxSize < 1) { return; }
+
+            // If the list is full and the score is not greater than the smallest score, we don't need to add it.
+            if (this._items.Count >= this._maxSize)
             {
-                if (score < this.Keys.Last())
-                {
-                    // If the key is less than the smallest key in the list, then we don't need to add it.
-                    return;
-                }
+                if (score <= this._items[this._items.Count - 1].Item2) { return; }
 
-                // Remove the smallest key.
-                this.RemoveAt(this.Count - 1);
+                this._items.RemoveAt(this._items.Count - 1);
             }
 
-            base.Add(score, value);
-        }
+            int index = this._items.Count;
+            while (index > 0 && this._items[index - 1].Item2 < score) { index--; }
 
-        private readonly int _maxSize;
+            this._items.Insert(index, (value, score));
+        }
 
-        private class DescendingDoubleComparer : IComparer<double>
+        /// <summary>
+        /// Items sorted by score, descending.
+        /// </summary>
+        public IList<(T, double)> ToList()
         {
-            public int Compare(double x, double y)
-            {
-                int compareResult = Comparer<double>.Default.Compare(x, y);
-
-                // Invert the result for descending order.
-                return 0 - compareResult;
-            }
+            return this._items;
         }
+
+        private readonly int _maxSize;
+        private readonly List<(T, double)> _items;
     }
 
     #endregion
@@ -0,0 +1,79 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.Orchestration;
+
+/// <summary>
+/// Pipeline of functions where each step declares the variables it reads and the variable where its result
+/// is stored. A step depends on the steps producing its input variables, and steps without dependencies
+/// between them run concurrently, so the pipeline takes as long as its slowest chain of dependent steps.
+/// </summary>
+/// <example>
+/// Three recalls feeding a final prompt: the recalls run concurrently, the prompt runs when all of them completed.
+/// <code>
+/// var pipeline = new Pipeline()
+///     .Add(recallFacts, "facts", "input")
+///     .Add(recallHistory, "history", "input")
+///     .Add(recallPreferences, "preferences", "input")
+///     .Add(answer, "answer", "facts", "history", "preferences");
+/// </code>
+/// </example>
+public sealed class Pipeline
+{
+    /// <summary>
+    /// Steps of the pipeline, in the order they have been added.
+    /// </summary>
+    public IReadOnlyList<PipelineStep> Steps => this._steps;
+
+    /// <summary>
+    /// Add a step to the pipeline. Input variables produced by steps already in the pipeline make the new step
+    /// depend on those steps; the other input variables are read from the variables passed to the pipeline.
+    /// </summary>
+    /// <param name="function">Function to execute</param>
+    /// <param name="outputVariable">Variable where the result of the function is stored, unique within the pipeline</param>
+    /// <param name="inputVariables">Variables read by the function. The first variable is passed to the function as $input.</param>
+    /// <returns>The current instance</returns>
+    public Pipeline Add(ISKFunction function, string outputVariable, params string[] inputVariables)
+    {
+        Verify.NotNull(function, "The function cannot be NULL");
+        Verify.NotEmpty(outputVariable, "The output variable name is empty");
+        Verify.NotNull(inputVariables, "The input variables cannot be NULL");
+
+        if (this._producers.ContainsKey(outputVariable))
+        {
+            throw new KernelException(
+                KernelException.ErrorCodes.InvalidPipeline,
+                $"The variable `{outputVariable}` is already the output of another step");
+        }
+
+        var dependencies = new SortedSet<int>();
+        var ancestors = new SortedSet<int>();
+        foreach (string variable in inputVariables)
+        {
+            Verify.NotEmpty(variable, "The input variable name is empty");
+            if (!this._producers.TryGetValue(variable, out int producer)) { continue; }
+
+            dependencies.Add(producer);
+            ancestors.Add(producer);
+            ancestors.UnionWith(this._steps[producer].Ancestors);
+        }
+
+        this._producers[outputVariable] = this._steps.Count;
+        this._steps.Add(new PipelineStep(function, outputVariable, inputVariables.ToArray(), dependencies.ToArray(), ancestors.ToArray()));
+
+        return this;
+    }
+
+    #region private ================================================================================
+
+    private readonly List<PipelineStep> _steps = new();
+
+    // Variable name => index of the step producing it. Variable names are case insensitive, like in ContextVariables.
+    private readonly Dictionary<string, int> _producers = new(StringComparer.OrdinalIgnoreCase);
+
+    #endregion
+}
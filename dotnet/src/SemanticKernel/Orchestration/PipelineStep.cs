@@ -0,0 +1,54 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Collections.Generic;
+
+namespace Microsoft.SemanticKernel.Orchestration;
+
+/// <summary>
+/// Step of a <see cref="Pipeline"/>: a function, the variables it reads, and the variable where its result is stored.
+/// </summary>
+public sealed class PipelineStep
+{
+    /// <summary>
+    /// Function executed by the step.
+    /// </summary>
+    public ISKFunction Function { get; }
+
+    /// <summary>
+    /// Variable where the result of the function is stored.
+    /// </summary>
+    public string OutputVariable { get; }
+
+    /// <summary>
+    /// Variables read by the function. The first variable, if any, is passed to the function as $input.
+    /// </summary>
+    public IReadOnlyList<string> InputVariables { get; }
+
+    #region internals ==============================================================================
+
+    internal PipelineStep(
+        ISKFunction function,
+        string outputVariable,
+        IReadOnlyList<string> inputVariables,
+        IReadOnlyList<int> dependencies,
+        IReadOnlyList<int> ancestors)
+    {
+        this.Function = function;
+        this.OutputVariable = outputVariable;
+        this.InputVariables = inputVariables;
+        this.Dependencies = dependencies;
+        this.Ancestors = ancestors;
+    }
+
+    /// <summary>
+    /// Index of the steps producing the input variables.
+    /// </summary>
+    internal IReadOnlyList<int> Dependencies { get; }
+
+    /// <summary>
+    /// Index of all the steps this step depends on, directly or indirectly, in pipeline order.
+    /// </summary>
+    internal IReadOnlyList<int> Ancestors { get; }
+
+    #endregion
+}
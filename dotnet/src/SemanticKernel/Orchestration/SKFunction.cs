@@ -105,13 +105,30 @@ public sealed class SKFunction : ISKFunction, IDisposable
         {
             Verify.NotNull(client, "AI LLM backed is empty");
 
+            // The deadline covers the prompt rendering too, including the functions called by the template
+            using var deadline = CancellationTokenSource.CreateLinkedTokenSource(context.CancellationToken);
+            if (requestSettings.Timeout.HasValue) { deadline.CancelAfter(requestSettings.Timeout.Value); }
+
             try
             {
-                string prompt = await functionConfig.PromptTemplate.RenderAsync(context);
+                SKContext renderContext = requestSettings.Timeout.HasValue
+                    ? new SKContext(context.Variables, context.Memory, context.Skills, context.Log, deadline.Token)
+                    : context;
+                string prompt = await functionConfig.PromptTemplate.RenderAsync(renderContext);
 
-                string completion = await client.CompleteAsync(prompt, requestSettings);
+                string completion = await client.CompleteAsync(prompt, requestSettings, deadline.Token);
                 context.Variables.Update(completion);
             }
+            catch (OperationCanceledException e) when (deadline.IsCancellationRequested && !context.CancellationToken.IsCancellationRequested)
+            {
+                var message = $"The function did not complete within {requestSettings.Timeout}";
+                context.Fail(message, new AIException(AIException.ErrorCodes.RequestTimeout, message, e));
+            }
+            catch (OperationCanceledException) when (context.CancellationToken.IsCancellationRequested)
+            {
+                // Cancellation requested by the caller is not a failure of the function
+                throw;
+            }
 #pragma warning disable CA1031 // We need to catch all exceptions to handle the execution state
             catch (Exception e) when (!e.IsCriticalException())
             {
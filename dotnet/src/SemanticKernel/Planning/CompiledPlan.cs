@@ -0,0 +1,167 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using Microsoft.SemanticKernel.Orchestration;
+
+namespace Microsoft.SemanticKernel.Planning;
+
+/// <summary>
+/// Plan parsed once into the list of steps to execute, with the functions resolved.
+/// The position of the next step is the checkpoint of the execution, and the plan XML with the steps
+/// not executed yet is generated only when requested.
+/// </summary>
+internal sealed class CompiledPlan
+{
+    internal CompiledPlan(string goal, string goalXml)
+    {
+        this.Goal = goal;
+        this._goalXml = goalXml;
+    }
+
+    /// <summary>
+    /// Goal of the plan.
+    /// </summary>
+    internal string Goal { get; }
+
+    /// <summary>
+    /// Function calls of the plan, in order.
+    /// </summary>
+    internal IReadOnlyList<CompiledPlanStep> Steps => this._steps;
+
+    /// <summary>
+    /// Number of steps executed.
+    /// </summary>
+    internal int ExecutedSteps { get; private set; }
+
+    /// <summary>
+    /// Next step to execute, NULL when there are no more steps with registered functions.
+    /// </summary>
+    internal CompiledPlanStep? NextStep
+    {
+        get
+        {
+            this.MoveToNextStep();
+            return this._next < this._steps.Count ? this._steps[this._next] : null;
+        }
+    }
+
+    /// <summary>
+    /// Get the next steps that can run concurrently: the longest sequence of steps, in plan order, where no step
+    /// reads variables written by the previous steps of the sequence. Steps reading variables not defined yet are
+    /// considered dependent on all the previous steps, because functions can set variables not declared in the plan.
+    /// </summary>
+    /// <param name="variables">Context variables before executing the steps</param>
+    /// <param name="maxSteps">Max number of steps to return</param>
+    /// <returns>The next steps, empty when there are no more steps with registered functions</returns>
+    internal IReadOnlyList<CompiledPlanStep> GetNextSteps(ContextVariables variables, int maxSteps)
+    {
+        var steps = new List<CompiledPlanStep>();
+        var written = new HashSet<string>(StringComparer.InvariantCultureIgnoreCase);
+        this.MoveToNextStep();
+        for (int i = this._next; i < this._steps.Count && steps.Count < maxSteps; i++)
+        {
+            CompiledPlanStep step = this._steps[i];
+            if (step.IsExecuted || step.Function == null) { continue; }
+
+            if (steps.Count > 0 && step.Reads.Any(x => written.Contains(x) || !variables.ContainsKey(x))) { break; }
+
+            steps.Add(step);
+            written.UnionWith(step.Writes);
+        }
+
+        return steps;
+    }
+
+    /// <summary>
+    /// Serialize the goal and the parts of the plan not executed yet.
+    /// </summary>
+    /// <returns>Plan XML</returns>
+    internal string ToXml()
+    {
+        const string INDENT = "  ";
+        var xml = new StringBuilder();
+        xml.Append(this._goalXml);
+        xml.Append($"<{FunctionFlowRunner.SolutionTag}>\n");
+        foreach (Node node in this._nodes)
+        {
+            if (node.Step?.IsExecuted == true) { continue; }
+
+            if (node.IsText) { xml.Append(node.Xml).Append('\n'); }
+            else { xml.Append(INDENT).Append(node.Xml).Append('\n'); }
+        }
+
+        xml.Append($"</{FunctionFlowRunner.SolutionTag}>\n");
+        return xml.Replace("\r\n", "\n").ToString().Trim();
+    }
+
+    #region internals ==============================================================================
+
+    internal void AddText(string text)
+    {
+        this._nodes.Add(new Node(text, isText: true, step: null));
+    }
+
+    internal void AddElement(string xml)
+    {
+        this._nodes.Add(new Node(xml, isText: false, step: null));
+    }
+
+    internal void AddStep(CompiledPlanStep step)
+    {
+        this._nodes.Add(new Node(step.Xml, isText: false, step));
+        this._steps.Add(step);
+    }
+
+    /// <summary>
+    /// Mark a step as executed, so that it's not returned by <see cref="NextStep"/> and <see cref="GetNextSteps"/>
+    /// and it's removed from the plan XML.
+    /// </summary>
+    internal void MarkExecuted(CompiledPlanStep step)
+    {
+        if (step.IsExecuted) { return; }
+
+        step.IsExecuted = true;
+        this.ExecutedSteps++;
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    private sealed class Node
+    {
+        internal Node(string xml, bool isText, CompiledPlanStep? step)
+        {
+            this.Xml = xml;
+            this.IsText = isText;
+            this.Step = step;
+        }
+
+        internal string Xml { get; }
+
+        internal bool IsText { get; }
+
+        internal CompiledPlanStep? Step { get; }
+    }
+
+    private readonly string _goalXml;
+    private readonly List<Node> _nodes = new();
+    private readonly List<CompiledPlanStep> _steps = new();
+
+    // Position of the next step to execute. Steps are executed in plan order, so the position only moves
+    // forward, and finding the next step doesn't scan the steps already executed.
+    private int _next;
+
+    private void MoveToNextStep()
+    {
+        while (this._next < this._steps.Count && (this._steps[this._next].IsExecuted || this._steps[this._next].Function == null))
+        {
+            this._next++;
+        }
+    }
+
+    #endregion
+}
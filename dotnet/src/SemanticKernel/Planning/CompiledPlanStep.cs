@@ -0,0 +1,117 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Microsoft.SemanticKernel.Orchestration;
+
+namespace Microsoft.SemanticKernel.Planning;
+
+/// <summary>
+/// Function call of a <see cref="CompiledPlan"/>, with the function resolved and the attributes parsed.
+/// </summary>
+internal sealed class CompiledPlanStep
+{
+    /// <summary>
+    /// Parameter passed to the function: either a constant value, or the concatenation of context variables.
+    /// </summary>
+    internal sealed class Binding
+    {
+        internal Binding(string name, string value, IReadOnlyList<string>? variableNames)
+        {
+            this.Name = name;
+            this.Value = value;
+            this.VariableNames = variableNames;
+        }
+
+        /// <summary>
+        /// Name of the function parameter.
+        /// </summary>
+        internal string Name { get; }
+
+        /// <summary>
+        /// Constant value, used when the parameter is not bound to variables.
+        /// </summary>
+        internal string Value { get; }
+
+        /// <summary>
+        /// Names of the context variables concatenated into the parameter value, NULL for constant values.
+        /// </summary>
+        internal IReadOnlyList<string>? VariableNames { get; }
+    }
+
+    internal CompiledPlanStep(
+        string xml,
+        string skillName,
+        string functionName,
+        ISKFunction? function,
+        IReadOnlyList<Binding> bindings,
+        string outputVariable,
+        string appendToResult)
+    {
+        this.Xml = xml;
+        this.SkillName = skillName;
+        this.FunctionName = functionName;
+        this.Function = function;
+        this.Bindings = bindings;
+        this.OutputVariable = outputVariable;
+        this.AppendToResult = appendToResult;
+
+        // Without an explicit input, the function receives the result of the previous step
+        this.Reads = bindings.SelectMany(x => x.VariableNames ?? Array.Empty<string>())
+            .Concat(bindings.Any(x => x.Name.Equals(InputVariable, StringComparison.OrdinalIgnoreCase)) ? Array.Empty<string>() : new[] { InputVariable })
+            .ToList();
+
+        var writes = new List<string> { InputVariable };
+        if (!string.IsNullOrEmpty(outputVariable)) { writes.Add(outputVariable); }
+        if (!string.IsNullOrEmpty(appendToResult)) { writes.Add(Plan.ResultKey); }
+        this.Writes = writes;
+    }
+
+    /// <summary>
+    /// XML of the step, used to serialize the steps not executed yet.
+    /// </summary>
+    internal string Xml { get; }
+
+    internal string SkillName { get; }
+
+    internal string FunctionName { get; }
+
+    /// <summary>
+    /// Function to execute, NULL if the function is not registered: the step is then kept in the plan and never executed.
+    /// </summary>
+    internal ISKFunction? Function { get; }
+
+    /// <summary>
+    /// Function parameters, in the order they appear in the plan.
+    /// </summary>
+    internal IReadOnlyList<Binding> Bindings { get; }
+
+    /// <summary>
+    /// Context variable where the result is stored, empty if not set.
+    /// </summary>
+    internal string OutputVariable { get; }
+
+    /// <summary>
+    /// Header used to append the result to the plan result, empty if the result is not appended.
+    /// </summary>
+    internal string AppendToResult { get; }
+
+    internal bool IsExecuted { get; set; }
+
+    /// <summary>
+    /// Context variables read by the step.
+    /// </summary>
+    internal IReadOnlyList<string> Reads { get; }
+
+    /// <summary>
+    /// Context variables written by the step. Functions can set other variables too, which are not known in advance.
+    /// </summary>
+    internal IReadOnlyList<string> Writes { get; }
+
+    #region private ================================================================================
+
+    private const string InputVariable = "input";
+
+    #endregion
+}
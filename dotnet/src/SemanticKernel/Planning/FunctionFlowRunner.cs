@@ -58,202 +58,286 @@ internal class FunctionFlowRunner
     /// <returns>The resulting plan xml after executing a step in the plan.</returns>
     /// <context>
     /// Brief overview of how it works:
-    /// 1. The plan xml is parsed into an XmlDocument.
-    /// 2. The Goal node is extracted from the plan xml.
-    /// 3. The Solution node is extracted from the plan xml.
-    /// 4. The first function node in the Solution node is processed.
-    /// 5. The resulting plan xml is returned.
+    /// 1. The plan xml is compiled into a list of steps.
+    /// 2. The first step with a registered function is executed.
+    /// 3. The resulting plan xml, without the executed step, is stored in the context.
     /// </context>
     /// <exception cref="PlanningException">Thrown when the plan xml is invalid.</exception>
     public async Task<SKContext> ExecuteXmlPlanAsync(SKContext context, string planPayload)
     {
         try
         {
-            XmlDocument xmlDoc = new();
-            try
-            {
-                xmlDoc.LoadXml("<xml>" + planPayload + "</xml>");
-            }
-            catch (XmlException e)
-            {
-                throw new PlanningException(PlanningException.ErrorCodes.InvalidPlan, "Failed to parse plan xml.", e);
-            }
+            CompiledPlan plan = this.Compile(planPayload, context);
+            await this.ExecuteNextStepAsync(plan, context);
+            context.Variables.Set(Plan.PlanKey, plan.ToXml());
 
-            // Get the Goal
-            var (goalTxt, goalXmlString) = GatherGoal(xmlDoc);
+            return context;
+        }
+        catch (Exception e) when (!e.IsCriticalException())
+        {
+            context.Log.LogError(e, "Plan execution failed: {0}", e.Message);
+            throw;
+        }
+    }
 
-            // Get the Solution
-            XmlNodeList solution = xmlDoc.GetElementsByTagName(SolutionTag);
+    /// <summary>
+    /// Parse a plan xml and resolve the functions it calls, so that the plan can be executed without parsing it again.
+    /// </summary>
+    /// <param name="planPayload">The plan xml.</param>
+    /// <param name="context">The context providing the registered functions.</param>
+    /// <returns>The compiled plan</returns>
+    /// <exception cref="PlanningException">Thrown when the plan xml is invalid.</exception>
+    internal CompiledPlan Compile(string planPayload, SKContext context)
+    {
+        XmlDocument xmlDoc = new();
+        try
+        {
+            xmlDoc.LoadXml("<xml>" + planPayload + "</xml>");
+        }
+        catch (XmlException e)
+        {
+            throw new PlanningException(PlanningException.ErrorCodes.InvalidPlan, "Failed to parse plan xml.", e);
+        }
 
-            // Prepare content for the new plan xml
-            var solutionContent = new StringBuilder();
-            _ = solutionContent.AppendLine($"<{SolutionTag}>");
+        // Get the Goal
+        var (goalTxt, goalXmlString) = GatherGoal(xmlDoc);
+        var plan = new CompiledPlan(goalTxt, goalXmlString);
 
-            // Use goal as default function {{INPUT}} -- check and see if it's a plan in Input, if so, use goalTxt, otherwise, use the input.
-            if (!context.Variables.Get("PLAN__INPUT", out var planInput))
+        // Get the Solution
+        foreach (XmlNode o in xmlDoc.GetElementsByTagName(SolutionTag))
+        {
+            context.Log.LogTrace("{0}: found node", o.Name);
+            foreach (XmlNode o2 in o.ChildNodes)
             {
-                // planInput should then be the context.Variables.ToString() only if it's not a plan json
-                try
+                if (o2.Name == "#text")
                 {
-                    var plan = Plan.FromJson(context.Variables.ToString());
-                    planInput = string.IsNullOrEmpty(plan.Goal) ? context.Variables.ToString() : goalTxt;
+                    if (o2.Value != null) { plan.AddText(o2.Value.Trim()); }
+
+                    continue;
                 }
-                catch (Exception e) when (!e.IsCriticalException())
+
+                if (o2.Name.StartsWith(FunctionTag, StringComparison.InvariantCultureIgnoreCase))
                 {
-                    planInput = context.Variables.ToString();
+                    plan.AddStep(CompileStep(o2, context));
+                    continue;
                 }
+
+                plan.AddElement(o2.OuterXml);
             }
+        }
 
-            string functionInput = string.IsNullOrEmpty(planInput) ? goalTxt : planInput;
+        return plan;
+    }
 
-            //
-            // Process Solution nodes
-            //
-            context.Log.LogDebug("Processing solution");
+    /// <summary>
+    /// Executes the steps of a compiled plan, stopping when a step fails.
+    /// Consecutive steps that don't depend on each other run concurrently, see <see cref="CompiledPlan.GetNextSteps"/>,
+    /// and their results are applied in plan order, so when all the steps succeed the outcome is the same as executing
+    /// the steps one at a time. When a step fails, the steps after it in the same group have already run, but their
+    /// results are discarded and they stay in the plan: resuming the plan executes them again, so functions with side
+    /// effects outside of the context can see them twice. The results can't be kept, because every step writes the
+    /// input read by the failed step when it's executed again.
+    /// </summary>
+    /// <param name="plan">The compiled plan, updated as steps are executed.</param>
+    /// <param name="context">The context to execute the plan in.</param>
+    /// <param name="maxSteps">Max number of steps to execute.</param>
+    /// <returns>The context, containing the resulting plan xml.</returns>
+    internal async Task<SKContext> ExecutePlanAsync(
+        CompiledPlan plan,
+        SKContext context,
+        int maxSteps = int.MaxValue)
+    {
+        int executed = 0;
+        while (executed < maxSteps)
+        {
+            context.CancellationToken.ThrowIfCancellationRequested();
 
-            // Process the solution nodes
-            string stepResults = await this.ProcessNodeListAsync(solution, functionInput, context);
-            // Add the solution and variable updates to the new plan xml
-            _ = solutionContent.Append(stepResults)
-                .AppendLine($"</{SolutionTag}>");
-            // Update the plan xml
-            var updatedPlan = goalXmlString + solutionContent.Replace("\r\n", "\n");
-            updatedPlan = updatedPlan.Trim();
+            IReadOnlyList<CompiledPlanStep> steps = plan.GetNextSteps(context.Variables, maxSteps - executed);
+            if (steps.Count == 0) { break; }
 
-            context.Variables.Set(Plan.PlanKey, updatedPlan);
-            context.Variables.Set("PLAN__INPUT", context.Variables.ToString());
+            context.Log.LogTrace("Processing {0} functions", steps.Count);
 
-            return context;
+            // All the steps see the variables as they were before the group started
+            string functionInput = GetFunctionInput(plan, context);
+            ContextVariables[] stepVariables = steps.Select(x => PrepareStepVariables(x, functionInput, context)).ToArray();
+            List<string>[] keysToIgnore = stepVariables.Select(x => x.Select(v => v.Key).ToList()).ToArray();
+            SKContext[] results = steps.Count == 1
+                ? new[] { await this._kernel.RunAsync(stepVariables[0], context.CancellationToken, steps[0].Function!) }
+                : await Task.WhenAll(steps.Select((x, i) => this.RunConcurrentStepAsync(x, stepVariables[i], context)));
+
+            for (int i = 0; i < steps.Count; i++)
+            {
+                if (results[i].ErrorOccurred)
+                {
+                    // The failed step and the following ones stay in the plan, and the results of the following
+                    // ones are discarded: they are executed again when the plan is resumed
+                    context.Fail(results[i].LastErrorDescription, results[i].LastException);
+                    break;
+                }
+
+                ApplyStepResult(steps[i], stepVariables[i], keysToIgnore[i], results[i], context);
+                plan.MarkExecuted(steps[i]);
+                context.Variables.Set("PLAN__INPUT", context.Variables.ToString());
+                executed++;
+            }
+
+            if (context.ErrorOccurred) { break; }
         }
-        catch (Exception e) when (!e.IsCriticalException())
+
+        // The plan xml is generated only once, after the last step
+        context.Variables.Set(Plan.PlanKey, plan.ToXml());
+        return context;
+    }
+
+    /// <summary>
+    /// Executes the next step of a compiled plan.
+    /// </summary>
+    /// <param name="plan">The compiled plan.</param>
+    /// <param name="context">The context to execute the plan in.</param>
+    /// <returns>The context of the function executed, or NULL if there are no steps to execute.</returns>
+    internal async Task<SKContext?> ExecuteNextStepAsync(CompiledPlan plan, SKContext context)
+    {
+        SKContext? result = null;
+        CompiledPlanStep? step = plan.NextStep;
+        if (step != null)
         {
-            context.Log.LogError(e, "Plan execution failed: {0}", e.Message);
-            throw;
+            context.Log.LogTrace("Processing function {0}.{1}", step.SkillName, step.FunctionName);
+            ContextVariables functionVariables = PrepareStepVariables(step, GetFunctionInput(plan, context), context);
+
+            // capture current keys before running function
+            var keysToIgnore = functionVariables.Select(x => x.Key).ToList();
+
+            result = await this._kernel.RunAsync(functionVariables, context.CancellationToken, step.Function!);
+            ApplyStepResult(step, functionVariables, keysToIgnore, result, context);
+            plan.MarkExecuted(step);
         }
+
+        context.Variables.Set("PLAN__INPUT", context.Variables.ToString());
+        return result;
+    }
+
+    #region private ================================================================================
+
+    private async Task<SKContext> RunConcurrentStepAsync(CompiledPlanStep step, ContextVariables variables, SKContext context)
+    {
+        // Native functions can block: return to the caller first, so that the other steps of the group start too
+        await Task.Yield();
+        return await this._kernel.RunAsync(variables, context.CancellationToken, step.Function!);
     }
 
-    private async Task<string> ProcessNodeListAsync(XmlNodeList nodeList, string functionInput, SKContext context)
+    private static CompiledPlanStep CompileStep(XmlNode node, SKContext context)
     {
-        var stepAndTextResults = new StringBuilder();
-        var processFunctions = true;
-        const string INDENT = "  ";
-        foreach (XmlNode o in nodeList)
+        var skillFunctionName = node.Name.Split(FunctionTag)?[1] ?? string.Empty;
+        GetSkillFunctionNames(skillFunctionName, out var skillName, out var functionName);
+
+        ISKFunction? skillFunction = null;
+        if (!string.IsNullOrEmpty(functionName) && context.IsFunctionRegistered(skillName, functionName, out var registeredFunction))
         {
-            var parentNodeName = o.Name;
+            skillFunction = registeredFunction;
+        }
 
-            context.Log.LogTrace("{0}: found node", parentNodeName);
-            foreach (XmlNode o2 in o.ChildNodes)
+        var bindings = new List<CompiledPlanStep.Binding>();
+        var variableTargetName = string.Empty;
+        var appendToResultName = string.Empty;
+        if (node.Attributes is not null)
+        {
+            foreach (XmlAttribute attr in node.Attributes)
             {
-                if (o2.Name == "#text")
+                if (attr.InnerText.StartsWith("$", StringComparison.InvariantCultureIgnoreCase))
                 {
-                    context.Log.LogTrace("{0}: appending text node", parentNodeName);
-                    if (o2.Value != null)
-                    {
-                        _ = stepAndTextResults.AppendLine(o2.Value.Trim());
-                    }
-
-                    continue;
+                    // Split the attribute value on the comma or ; character
+                    var variableNames = attr.InnerText
+                        .Split(new char[] { ',', ';' }, StringSplitOptions.RemoveEmptyEntries)
+                        .Select(x => x[1..])
+                        .ToList();
+                    bindings.Add(new CompiledPlanStep.Binding(attr.Name, string.Empty, variableNames));
                 }
-
-                if (o2.Name.StartsWith(FunctionTag, StringComparison.InvariantCultureIgnoreCase))
+                else if (attr.Name.Equals(SetContextVariableTag, StringComparison.OrdinalIgnoreCase))
                 {
-                    var skillFunctionName = o2.Name.Split(FunctionTag)?[1] ?? string.Empty;
-                    context.Log.LogTrace("{0}: found skill node {1}", parentNodeName, skillFunctionName);
-                    GetSkillFunctionNames(skillFunctionName, out var skillName, out var functionName);
-                    if (processFunctions && !string.IsNullOrEmpty(functionName) && context.IsFunctionRegistered(skillName, functionName, out var skillFunction))
-                    {
-                        Verify.NotNull(functionName, nameof(functionName));
-                        Verify.NotNull(skillFunction, nameof(skillFunction));
-                        context.Log.LogTrace("{0}: processing function {1}.{2}", parentNodeName, skillName, functionName);
-
-                        var functionVariables = new ContextVariables(functionInput);
-                        var variableTargetName = string.Empty;
-                        var appendToResultName = string.Empty;
-                        if (o2.Attributes is not null)
-                        {
-                            foreach (XmlAttribute attr in o2.Attributes)
-                            {
-                                context.Log.LogTrace("{0}: processing attribute {1}", parentNodeName, attr.ToString());
-                                if (attr.InnerText.StartsWith("$", StringComparison.InvariantCultureIgnoreCase))
-                                {
-                                    // Split the attribute value on the comma or ; character
-                                    var attrValues = attr.InnerText.Split(new char[] { ',', ';' }, StringSplitOptions.RemoveEmptyEntries);
-                                    if (attrValues.Length > 0)
-                                    {
-                                        // If there are multiple values, create a list of the values
-                                        var attrValueList = new List<string>();
-                                        foreach (var attrValue in attrValues)
-                                        {
-                                            if (context.Variables.Get(attrValue[1..], out var variableReplacement))
-                                            {
-                                                attrValueList.Add(variableReplacement);
-                                            }
-                                        }
-
-                                        if (attrValueList.Count > 0)
-                                        {
-                                            functionVariables.Set(attr.Name, string.Concat(attrValueList));
-                                        }
-                                    }
-                                }
-                                else if (attr.Name.Equals(SetContextVariableTag, StringComparison.OrdinalIgnoreCase))
-                                {
-                                    variableTargetName = attr.InnerText;
-                                }
-                                else if (attr.Name.Equals(AppendToResultTag, StringComparison.OrdinalIgnoreCase))
-                                {
-                                    appendToResultName = attr.InnerText;
-                                }
-                                else
-                                {
-                                    functionVariables.Set(attr.Name, attr.InnerText);
-                                }
-                            }
-                        }
-
-                        // capture current keys before running function
-                        var keysToIgnore = functionVariables.Select(x => x.Key).ToList();
-
-                        var result = await this._kernel.RunAsync(functionVariables, skillFunction);
-
-                        // copy all values for VariableNames in functionVariables not in keysToIgnore to context.Variables
-                        foreach (var (key, _) in functionVariables)
-                        {
-                            if (!keysToIgnore.Contains(key, StringComparer.InvariantCultureIgnoreCase) && functionVariables.Get(key, out var value))
-                            {
-                                context.Variables.Set(key, value);
-                            }
-                        }
-
-                        _ = context.Variables.Update(result.ToString());
-                        if (!string.IsNullOrEmpty(variableTargetName))
-                        {
-                            context.Variables.Set(variableTargetName, result.ToString());
-                        }
-
-                        if (!string.IsNullOrEmpty(appendToResultName))
-                        {
-                            _ = context.Variables.Get(Plan.ResultKey, out var resultsSoFar);
-                            context.Variables.Set(Plan.ResultKey,
-                                string.Join(Environment.NewLine + Environment.NewLine, resultsSoFar, appendToResultName, result.ToString()).Trim());
-                        }
-
-                        processFunctions = false;
-                    }
-                    else
-                    {
-                        context.Log.LogTrace("{0}: appending function node {1}", parentNodeName, skillFunctionName);
-                        _ = stepAndTextResults.Append(INDENT).AppendLine(o2.OuterXml);
-                    }
-
-                    continue;
+                    variableTargetName = attr.InnerText;
+                }
+                else if (attr.Name.Equals(AppendToResultTag, StringComparison.OrdinalIgnoreCase))
+                {
+                    appendToResultName = attr.InnerText;
                 }
+                else
+                {
+                    bindings.Add(new CompiledPlanStep.Binding(attr.Name, attr.InnerText, null));
+                }
+            }
+        }
+
+        return new CompiledPlanStep(node.OuterXml, skillName, functionName, skillFunction, bindings, variableTargetName, appendToResultName);
+    }
 
-                _ = stepAndTextResults.Append(INDENT).AppendLine(o2.OuterXml);
+    private static string GetFunctionInput(CompiledPlan plan, SKContext context)
+    {
+        // Use goal as default function {{INPUT}} -- check and see if it's a plan in Input, if so, use goalTxt, otherwise, use the input.
+        if (!context.Variables.Get("PLAN__INPUT", out var planInput))
+        {
+            // planInput should then be the context.Variables.ToString() only if it's not a plan json
+            try
+            {
+                var planJson = Plan.FromJson(context.Variables.ToString());
+                planInput = string.IsNullOrEmpty(planJson.Goal) ? context.Variables.ToString() : plan.Goal;
             }
+            catch (Exception e) when (!e.IsCriticalException())
+            {
+                planInput = context.Variables.ToString();
+            }
+        }
+
+        return string.IsNullOrEmpty(planInput) ? plan.Goal : planInput;
+    }
+
+    private static ContextVariables PrepareStepVariables(CompiledPlanStep step, string functionInput, SKContext context)
+    {
+        var functionVariables = new ContextVariables(functionInput);
+        foreach (CompiledPlanStep.Binding binding in step.Bindings)
+        {
+            if (binding.VariableNames == null)
+            {
+                functionVariables.Set(binding.Name, binding.Value);
+                continue;
+            }
+
+            // If there are multiple values, concatenate the values
+            var values = new List<string>();
+            foreach (string variableName in binding.VariableNames)
+            {
+                if (context.Variables.Get(variableName, out var variableReplacement)) { values.Add(variableReplacement); }
+            }
+
+            if (values.Count > 0) { functionVariables.Set(binding.Name, string.Concat(values)); }
         }
 
-        return stepAndTextResults.Replace("\r\n", "\n").ToString();
+        return functionVariables;
+    }
+
+    private static void ApplyStepResult(
+        CompiledPlanStep step, ContextVariables functionVariables, List<string> keysToIgnore, SKContext result, SKContext context)
+    {
+        // copy all values for VariableNames in functionVariables not in keysToIgnore to context.Variables
+        foreach (var (key, _) in functionVariables)
+        {
+            if (!keysToIgnore.Contains(key, StringComparer.InvariantCultureIgnoreCase) && functionVariables.Get(key, out var value))
+            {
+                context.Variables.Set(key, value);
+            }
+        }
+
+        _ = context.Variables.Update(result.ToString());
+        if (!string.IsNullOrEmpty(step.OutputVariable))
+        {
+            context.Variables.Set(step.OutputVariable, result.ToString());
+        }
+
+        if (!string.IsNullOrEmpty(step.AppendToResult))
+        {
+            _ = context.Variables.Get(Plan.ResultKey, out var resultsSoFar);
+            context.Variables.Set(Plan.ResultKey,
+                string.Join(Environment.NewLine + Environment.NewLine, resultsSoFar, step.AppendToResult, result.ToString()).Trim());
+        }
     }
 
     private static (string goalTxt, string goalXmlString) GatherGoal(XmlDocument xmlDoc)
@@ -278,4 +362,6 @@ internal class FunctionFlowRunner
         skillName = skillFunctionNameParts?.Length > 0 ? skillFunctionNameParts[0] : string.Empty;
         functionName = skillFunctionNameParts?.Length > 1 ? skillFunctionNameParts[1] : skillFunctionName;
     }
+
+    #endregion
 }
@@ -0,0 +1,211 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.AI.Embeddings.VectorOperations;
+using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.SkillDefinition;
+
+namespace Microsoft.SemanticKernel.Planning;
+
+/// <summary>
+/// Index of the functions descriptions and parameters, used by the planner to include in the prompt
+/// only the functions relevant to the goal. Functions are embedded the first time they are searched,
+/// and embedded again only when their name, description or parameters change.
+/// Disposing the index disposes the embedding generator.
+/// </summary>
+public sealed class FunctionIndex : IDisposable
+{
+    /// <summary>
+    /// Default max number of functions returned by a search.
+    /// </summary>
+    public const int DefaultMaxFunctions = 20;
+
+    /// <summary>
+    /// Create a new index.
+    /// </summary>
+    /// <param name="embeddingGenerator">Generator used to embed functions and goals</param>
+    /// <param name="maxFunctions">Max number of functions returned by a search</param>
+    /// <param name="minRelevance">Min cosine similarity of a function to the goal</param>
+    public FunctionIndex(
+        IEmbeddingGenerator<string, float> embeddingGenerator,
+        int maxFunctions = DefaultMaxFunctions,
+        double minRelevance = 0)
+    {
+        Verify.NotNull(embeddingGenerator, "The embedding generator cannot be NULL");
+        if (maxFunctions < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxFunctions), "The max number of functions must be greater than zero");
+        }
+
+        this._embeddingGenerator = embeddingGenerator;
+        this.MaxFunctions = maxFunctions;
+        this.MinRelevance = minRelevance;
+    }
+
+    /// <summary>
+    /// Max number of functions returned by a search.
+    /// </summary>
+    public int MaxFunctions { get; }
+
+    /// <summary>
+    /// Min cosine similarity of a function to the goal.
+    /// </summary>
+    public double MinRelevance { get; }
+
+    /// <summary>
+    /// Get the functions most relevant to a goal. When there are no more functions than <see cref="MaxFunctions"/>,
+    /// all the functions are returned without generating embeddings.
+    /// </summary>
+    /// <param name="goal">Goal to plan</param>
+    /// <param name="functions">Functions available</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>The relevant functions, in the same order as <paramref name="functions"/></returns>
+    public Task<IList<FunctionView>> GetRelevantFunctionsAsync(
+        string goal, IEnumerable<FunctionView> functions, CancellationToken cancel = default)
+    {
+        return this.GetRelevantFunctionsAsync(goal, null, functions, cancel);
+    }
+
+    /// <summary>
+    /// Dispose the embedding generator.
+    /// </summary>
+    public void Dispose()
+    {
+        // ReSharper disable once SuspiciousTypeConversion.Global
+        if (this._embeddingGenerator is IDisposable emb) { emb.Dispose(); }
+    }
+
+    #region internals ==============================================================================
+
+    /// <summary>
+    /// Generator used to embed functions and goals.
+    /// </summary>
+    internal IEmbeddingGenerator<string, float> EmbeddingGenerator => this._embeddingGenerator;
+
+    /// <summary>
+    /// Get the functions most relevant to a goal, reusing the embedding of the goal if already available.
+    /// </summary>
+    /// <param name="goal">Goal to plan</param>
+    /// <param name="goalEmbedding">Embedding of the goal, generated by <see cref="EmbeddingGenerator"/>, or NULL to generate it when needed</param>
+    /// <param name="functions">Functions available</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>The relevant functions, in the same order as <paramref name="functions"/></returns>
+    internal async Task<IList<FunctionView>> GetRelevantFunctionsAsync(
+        string goal, Embedding<float>? goalEmbedding, IEnumerable<FunctionView> functions, CancellationToken cancel = default)
+    {
+        Verify.NotNull(functions, "The functions cannot be NULL");
+
+        List<FunctionView> available = functions.ToList();
+        if (available.Count <= this.MaxFunctions) { return available; }
+
+        IReadOnlyDictionary<string, Embedding<float>> embeddings = await this.UpdateAsync(available, cancel);
+        goalEmbedding ??= await this._embeddingGenerator.GenerateEmbeddingAsync(goal, cancel);
+
+        HashSet<string> relevant = available
+            .Select(x => (Key: GetKey(x), Score: goalEmbedding.Value.AsReadOnlySpan().CosineSimilarity(embeddings[GetKey(x)].AsReadOnlySpan())))
+            .Where(x => x.Score >= this.MinRelevance)
+            .OrderByDescending(x => x.Score)
+            .Take(this.MaxFunctions)
+            .Select(x => x.Key)
+            .ToHashSet(StringComparer.OrdinalIgnoreCase);
+
+        return available.Where(x => relevant.Contains(GetKey(x))).ToList();
+    }
+
+    /// <summary>
+    /// Number of functions embedded.
+    /// </summary>
+    internal int Count
+    {
+        get
+        {
+            lock (this._lock) { return this._entries.Count; }
+        }
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    private readonly IEmbeddingGenerator<string, float> _embeddingGenerator;
+    private readonly object _lock = new();
+
+    // Function embeddings, by function fully qualified name
+    private readonly Dictionary<string, Entry> _entries = new(StringComparer.OrdinalIgnoreCase);
+
+    private sealed class Entry
+    {
+        public Entry(string text, Embedding<float> embedding)
+        {
+            this.Text = text;
+            this.Embedding = embedding;
+        }
+
+        public string Text { get; }
+        public Embedding<float> Embedding { get; }
+    }
+
+    /// <summary>
+    /// Embed new and changed functions, and remove the functions not available anymore.
+    /// </summary>
+    /// <returns>The embeddings of the functions</returns>
+    private async Task<IReadOnlyDictionary<string, Embedding<float>>> UpdateAsync(List<FunctionView> functions, CancellationToken cancel)
+    {
+        Dictionary<string, string> texts = functions.ToDictionary(GetKey, GetText, StringComparer.OrdinalIgnoreCase);
+
+        var result = new Dictionary<string, Embedding<float>>(StringComparer.OrdinalIgnoreCase);
+        var changed = new List<string>();
+        lock (this._lock)
+        {
+            foreach (KeyValuePair<string, string> text in texts)
+            {
+                if (this._entries.TryGetValue(text.Key, out Entry? entry) && entry.Text == text.Value)
+                {
+                    result[text.Key] = entry.Embedding;
+                }
+                else
+                {
+                    changed.Add(text.Key);
+                }
+            }
+        }
+
+        IList<Embedding<float>> embeddings = changed.Count > 0
+            ? await this._embeddingGenerator.GenerateEmbeddingsAsync(changed.Select(x => texts[x]).ToList(), cancel)
+            : Array.Empty<Embedding<float>>();
+
+        lock (this._lock)
+        {
+            for (int i = 0; i < changed.Count; i++)
+            {
+                this._entries[changed[i]] = new Entry(texts[changed[i]], embeddings[i]);
+                result[changed[i]] = embeddings[i];
+            }
+
+            foreach (string key in this._entries.Keys.Where(x => !texts.ContainsKey(x)).ToList())
+            {
+                this._entries.Remove(key);
+            }
+        }
+
+        return result;
+    }
+
+    private static string GetKey(FunctionView function)
+    {
+        return $"{function.SkillName}.{function.Name}";
+    }
+
+    private static string GetText(FunctionView function)
+    {
+        string parameters = string.Join("\n", function.Parameters.Select(p => $"{p.Name}: {p.Description}"));
+        return $"{function.SkillName}.{function.Name}: {function.Description}\n{parameters}";
+    }
+
+    #endregion
+}
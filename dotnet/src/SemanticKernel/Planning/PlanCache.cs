@@ -0,0 +1,466 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Runtime.CompilerServices;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Xml;
+using Microsoft.SemanticKernel.AI.Embeddings;
+using Microsoft.SemanticKernel.Diagnostics;
+using Microsoft.SemanticKernel.Memory;
+using Microsoft.SemanticKernel.Memory.Storage;
+
+namespace Microsoft.SemanticKernel.Planning;
+
+/// <summary>
+/// Cache of plans created by the planner, returning the plan of the most similar goal already planned,
+/// when the similarity of the goals embeddings is above a threshold. Plans are grouped by functions manual,
+/// so that registering, removing or changing a function invalidates the plans created before.
+/// Only plans executed successfully are reused, and a reused plan that fails is removed.
+/// The cache keeps up to <see cref="MaxEntries"/> plans, evicting the least recently used.
+/// </summary>
+/// <remarks>
+/// A reused plan is re-parameterized only where a step argument is exactly the goal of the cached plan. A plan with other
+/// argument values taken from the cached goal, e.g. names or dates, is reused only if the new goal contains the same values,
+/// otherwise the lookup is a miss.
+/// </remarks>
+public sealed class PlanCache
+{
+    /// <summary>
+    /// Default min cosine similarity of goals sharing a plan.
+    /// </summary>
+    public const double DefaultMinSimilarity = 0.95;
+
+    /// <summary>
+    /// Default max number of plans stored.
+    /// </summary>
+    public const int DefaultMaxEntries = 1000;
+
+    /// <summary>
+    /// Create a new cache.
+    /// </summary>
+    /// <param name="embeddingGenerator">Generator used to embed goals</param>
+    /// <param name="storage">Storage of the goals embeddings and plans, by default an in-memory store</param>
+    /// <param name="minSimilarity">Min cosine similarity of two goals to reuse a plan</param>
+    /// <param name="maxEntries">Max number of plans stored, the least recently used are removed first</param>
+    public PlanCache(
+        IEmbeddingGenerator<string, float> embeddingGenerator,
+        IMemoryStore<float>? storage = null,
+        double minSimilarity = DefaultMinSimilarity,
+        int maxEntries = DefaultMaxEntries)
+        : this(embeddingGenerator, storage, minSimilarity, maxEntries, null)
+    {
+    }
+
+    /// <summary>
+    /// Min cosine similarity of two goals to reuse a plan.
+    /// </summary>
+    public double MinSimilarity { get; }
+
+    /// <summary>
+    /// Max number of plans stored.
+    /// </summary>
+    public int MaxEntries { get; }
+
+    /// <summary>
+    /// Number of plans stored.
+    /// </summary>
+    public int Count
+    {
+        get
+        {
+            lock (this._lock) { return this._entries.Count; }
+        }
+    }
+
+    /// <summary>
+    /// Number of lookups returning a plan.
+    /// </summary>
+    public long Hits => Interlocked.Read(ref this._hits);
+
+    /// <summary>
+    /// Number of lookups not finding a plan.
+    /// </summary>
+    public long Misses => Interlocked.Read(ref this._misses);
+
+    /// <summary>
+    /// Get the plan of the most similar goal, with the steps inputs matching the cached goal replaced by the new goal.
+    /// </summary>
+    /// <param name="goal">Goal to plan</param>
+    /// <param name="functionsManual">Description of the functions available to the plan</param>
+    /// <param name="cancel">Cancellation token</param>
+    /// <returns>The plan, without the goal, or NULL if there are no similar goals</returns>
+    public async Task<string?> TryGetAsync(string goal, string functionsManual, CancellationToken cancel = default)
+    {
+        Embedding<float> embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(goal, cancel);
+        (string? plan, string _) = await this.TryGetAsync(GetCollectionName(functionsManual), goal, embedding, cancel);
+        return plan;
+    }
+
+    /// <summary>
+    /// Store the plan of a goal.
+    /// </summary>
+    /// <param name="goal">Goal planned</param>
+    /// <param name="functionsManual">Description of the functions available to the plan</param>
+    /// <param name="plan">Plan to cache, without the goal</param>
+    /// <param name="cancel">Cancellation token</param>
+    public async Task SetAsync(string goal, string functionsManual, string plan, CancellationToken cancel = default)
+    {
+        Embedding<float> embedding = await this._embeddingGenerator.GenerateEmbeddingAsync(goal, cancel);
+        await this.SetAsync(GetCollectionName(functionsManual), goal, embedding, plan, cancel);
+    }
+
+    #region internals ==============================================================================
+
+    /// <summary>
+    /// Max number of plans created and not executed yet, tracked to be stored once executed successfully.
+    /// When the limit is reached the oldest plans are not tracked anymore.
+    /// </summary>
+    internal const int MaxPendingPlans = 1000;
+
+    /// <summary>
+    /// How long plans created and not executed yet are tracked.
+    /// </summary>
+    internal static readonly TimeSpan s_pendingPlanTimeToLive = TimeSpan.FromHours(1);
+
+    /// <summary>
+    /// Constructor allowing to replace the clock, used to test expirations.
+    /// </summary>
+    internal PlanCache(
+        IEmbeddingGenerator<string, float> embeddingGenerator,
+        IMemoryStore<float>? storage,
+        double minSimilarity,
+        int maxEntries,
+        Func<DateTimeOffset>? clock)
+    {
+        Verify.NotNull(embeddingGenerator, "The embedding generator cannot be NULL");
+        if (minSimilarity is <= 0 or > 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(minSimilarity), "The min similarity must be greater than 0 and less or equal to 1");
+        }
+
+        if (maxEntries < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxEntries), "The max number of entries must be greater than zero");
+        }
+
+        this._embeddingGenerator = embeddingGenerator;
+        this._storage = storage ?? new VolatileMemoryStore();
+        this.MinSimilarity = minSimilarity;
+        this.MaxEntries = maxEntries;
+        this._clock = clock ?? (() => DateTimeOffset.UtcNow);
+    }
+
+    /// <summary>
+    /// Generator used to embed goals.
+    /// </summary>
+    internal IEmbeddingGenerator<string, float> EmbeddingGenerator => this._embeddingGenerator;
+
+    internal Task<Embedding<float>> GenerateEmbeddingAsync(string goal, CancellationToken cancel = default)
+    {
+        return this._embeddingGenerator.GenerateEmbeddingAsync(goal, cancel);
+    }
+
+    /// <summary>
+    /// Get the name of the collection storing the plans created with the given functions.
+    /// The hash is computed once per manual instance: the planner reuses the same manual until
+    /// the version of the skill collection changes.
+    /// </summary>
+    internal static string GetCollectionName(string functionsManual)
+    {
+        return s_collectionNames.GetValue(functionsManual, x => "plans-" + ComputeHash(x));
+    }
+
+    /// <summary>
+    /// Get the plan of the most similar goal.
+    /// </summary>
+    /// <returns>The plan, and the ID of the cached plan to pass to <see cref="AddPendingPlan"/></returns>
+    internal async Task<(string? Plan, string Id)> TryGetAsync(string collection, string goal, Embedding<float> embedding, CancellationToken cancel = default)
+    {
+        cancel.ThrowIfCancellationRequested();
+        (IEmbeddingWithMetadata<float>? match, double _) = await this._storage.GetNearestMatchAsync(collection, embedding, this.MinSimilarity);
+        if (match is MemoryRecord record && ReplaceGoal(record.Description, record.Text, goal) is string plan)
+        {
+            this.Touch(collection, record.Id);
+            Interlocked.Increment(ref this._hits);
+            return (plan, record.Id);
+        }
+
+        Interlocked.Increment(ref this._misses);
+        return (null, string.Empty);
+    }
+
+    internal async Task SetAsync(string collection, string goal, Embedding<float> embedding, string plan, CancellationToken cancel = default)
+    {
+        // The ID is the hash of the goal, so that the same goal is stored only once
+        string id = ComputeHash(goal);
+        MemoryRecord record = MemoryRecord.LocalRecord(id, goal, plan, embedding);
+
+        await this._storage.PutValueAsync(collection, key: id, value: record, cancel: cancel);
+
+        foreach (Entry evicted in this.Track(collection, id))
+        {
+            await this._storage.RemoveAsync(evicted.Collection, evicted.Id, cancel);
+        }
+    }
+
+    /// <summary>
+    /// Track a plan until its execution is complete, see <see cref="CompletePlanAsync"/>.
+    /// </summary>
+    /// <param name="planId">ID of the plan created by the planner</param>
+    /// <param name="collection">Collection of the plan</param>
+    /// <param name="goal">Goal planned</param>
+    /// <param name="embedding">Embedding of the goal</param>
+    /// <param name="plan">Plan, without the goal</param>
+    /// <param name="cachedPlanId">ID of the cached plan reused, empty for new plans</param>
+    internal void AddPendingPlan(string planId, string collection, string goal, Embedding<float> embedding, string plan, string cachedPlanId = "")
+    {
+        DateTimeOffset now = this._clock();
+        lock (this._lock)
+        {
+            // Plans never executed, or whose execution was abandoned, are dropped oldest first
+            while (this._pendingLru.First != null &&
+                   (this._pendingPlans.Count >= MaxPendingPlans || this._pendingLru.First.Value.Expiration <= now))
+            {
+                this._pendingPlans.Remove(this._pendingLru.First.Value.PlanId);
+                this._pendingLru.RemoveFirst();
+            }
+
+            if (this._pendingPlans.TryGetValue(planId, out LinkedListNode<PendingPlan>? existing))
+            {
+                this._pendingLru.Remove(existing);
+            }
+
+            var pending = new PendingPlan(planId, collection, goal, embedding, plan, cachedPlanId, now + s_pendingPlanTimeToLive);
+            this._pendingPlans[planId] = this._pendingLru.AddLast(pending);
+        }
+    }
+
+    /// <summary>
+    /// Stop tracking a plan once its execution is complete. A new plan executed successfully is stored,
+    /// a cached plan that failed is removed.
+    /// </summary>
+    internal async Task CompletePlanAsync(string planId, bool isSuccessful, CancellationToken cancel = default)
+    {
+        PendingPlan pending;
+        lock (this._lock)
+        {
+            if (!this._pendingPlans.TryGetValue(planId, out LinkedListNode<PendingPlan>? node)) { return; }
+
+            this._pendingPlans.Remove(planId);
+            this._pendingLru.Remove(node);
+            pending = node.Value;
+        }
+
+        bool isReused = pending.CachedPlanId.Length > 0;
+        if (isSuccessful && !isReused)
+        {
+            await this.SetAsync(pending.Collection, pending.Goal, pending.Embedding, pending.Plan, cancel);
+        }
+        else if (!isSuccessful && isReused)
+        {
+            this.Untrack(pending.Collection, pending.CachedPlanId);
+            await this._storage.RemoveAsync(pending.Collection, pending.CachedPlanId, cancel);
+        }
+    }
+
+    internal int PendingPlansCount
+    {
+        get
+        {
+            lock (this._lock) { return this._pendingPlans.Count; }
+        }
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    // Collection names by functions manual, so that the same manual is hashed only once
+    private static readonly ConditionalWeakTable<string, string> s_collectionNames = new();
+
+    private readonly IEmbeddingGenerator<string, float> _embeddingGenerator;
+    private readonly IMemoryStore<float> _storage;
+    private readonly Func<DateTimeOffset> _clock;
+    private readonly object _lock = new();
+
+    // Plans stored by this instance, most recently used first
+    private readonly LinkedList<Entry> _lru = new();
+    private readonly Dictionary<string, LinkedListNode<Entry>> _entries = new(StringComparer.Ordinal);
+
+    // Plans not executed yet, oldest first
+    private readonly LinkedList<PendingPlan> _pendingLru = new();
+    private readonly Dictionary<string, LinkedListNode<PendingPlan>> _pendingPlans = new(StringComparer.Ordinal);
+
+    private long _hits;
+    private long _misses;
+
+    private sealed class Entry
+    {
+        internal Entry(string collection, string id)
+        {
+            this.Collection = collection;
+            this.Id = id;
+        }
+
+        internal string Collection { get; }
+        internal string Id { get; }
+        internal string Key => GetKey(this.Collection, this.Id);
+    }
+
+    private sealed class PendingPlan
+    {
+        internal PendingPlan(
+            string planId, string collection, string goal, Embedding<float> embedding, string plan, string cachedPlanId, DateTimeOffset expiration)
+        {
+            this.PlanId = planId;
+            this.Collection = collection;
+            this.Goal = goal;
+            this.Embedding = embedding;
+            this.Plan = plan;
+            this.CachedPlanId = cachedPlanId;
+            this.Expiration = expiration;
+        }
+
+        internal string PlanId { get; }
+        internal string Collection { get; }
+        internal string Goal { get; }
+        internal Embedding<float> Embedding { get; }
+        internal string Plan { get; }
+        internal string CachedPlanId { get; }
+        internal DateTimeOffset Expiration { get; }
+    }
+
+    private static string GetKey(string collection, string id)
+    {
+        return $"{collection}/{id}";
+    }
+
+    private static string ComputeHash(string text)
+    {
+        using var sha256 = SHA256.Create();
+        byte[] hash = sha256.ComputeHash(Encoding.UTF8.GetBytes(text));
+
+        var result = new StringBuilder(hash.Length * 2);
+        foreach (byte b in hash) { result.Append(b.ToString("x2", CultureInfo.InvariantCulture)); }
+
+        return result.ToString();
+    }
+
+    /// <summary>
+    /// Track a new plan, returning the plans to remove from the storage to stay within the limit.
+    /// Plans of functions not available anymore are never used again, so they are the first to be removed.
+    /// </summary>
+    private List<Entry> Track(string collection, string id)
+    {
+        var evicted = new List<Entry>();
+        var entry = new Entry(collection, id);
+        lock (this._lock)
+        {
+            if (this._entries.TryGetValue(entry.Key, out LinkedListNode<Entry>? existing))
+            {
+                this._lru.Remove(existing);
+            }
+
+            this._entries[entry.Key] = this._lru.AddFirst(entry);
+
+            while (this._entries.Count > this.MaxEntries && this._lru.Last != null)
+            {
+                evicted.Add(this._lru.Last.Value);
+                this._entries.Remove(this._lru.Last.Value.Key);
+                this._lru.RemoveLast();
+            }
+        }
+
+        return evicted;
+    }
+
+    /// <summary>
+    /// Mark a plan as recently used. Plans stored by other instances sharing the storage are not tracked.
+    /// </summary>
+    private void Touch(string collection, string id)
+    {
+        lock (this._lock)
+        {
+            if (!this._entries.TryGetValue(GetKey(collection, id), out LinkedListNode<Entry>? node)) { return; }
+
+            this._lru.Remove(node);
+            this._lru.AddFirst(node);
+        }
+    }
+
+    private void Untrack(string collection, string id)
+    {
+        lock (this._lock)
+        {
+            if (!this._entries.TryGetValue(GetKey(collection, id), out LinkedListNode<Entry>? node)) { return; }
+
+            this._entries.Remove(node.Value.Key);
+            this._lru.Remove(node);
+        }
+    }
+
+    /// <summary>
+    /// Re-parameterize a cached plan: step inputs set to the goal of the cached plan are set to the new goal.
+    /// Other argument values are not changed, see the remarks of <see cref="PlanCache"/>.
+    /// </summary>
+    /// <returns>The plan for the new goal, or NULL if the plan uses values of the cached goal missing from the new goal</returns>
+    private static string? ReplaceGoal(string plan, string cachedGoal, string goal)
+    {
+        if (string.Equals(cachedGoal.Trim(), goal.Trim(), StringComparison.Ordinal)) { return plan; }
+
+        var xmlDoc = new XmlDocument();
+        try
+        {
+            xmlDoc.LoadXml("<xml>" + plan + "</xml>");
+        }
+        catch (XmlException)
+        {
+            return plan;
+        }
+
+        bool replaced = false;
+        foreach (XmlNode node in xmlDoc.SelectNodes("//*")!)
+        {
+            if (node.Attributes == null) { continue; }
+
+            foreach (XmlAttribute attr in node.Attributes)
+            {
+                string value = attr.Value.Trim();
+                if (string.Equals(value, cachedGoal.Trim(), StringComparison.OrdinalIgnoreCase))
+                {
+                    attr.Value = goal.Trim();
+                    replaced = true;
+                }
+                else if (IsTakenFromGoal(attr.Name, value, cachedGoal) && goal.IndexOf(value, StringComparison.OrdinalIgnoreCase) < 0)
+                {
+                    return null;
+                }
+            }
+        }
+
+        return replaced ? xmlDoc.DocumentElement!.InnerXml : plan;
+    }
+
+    /// <summary>
+    /// Whether an argument is a literal value copied from the goal, as opposed to variable names and references.
+    /// </summary>
+    private static bool IsTakenFromGoal(string name, string value, string goal)
+    {
+        if (value.Length == 0 || value[0] == '$') { return false; }
+
+        if (name.Equals(FunctionFlowRunner.SetContextVariableTag, StringComparison.OrdinalIgnoreCase)
+            || name.Equals(FunctionFlowRunner.AppendToResultTag, StringComparison.OrdinalIgnoreCase))
+        {
+            return false;
+        }
+
+        return goal.IndexOf(value, StringComparison.OrdinalIgnoreCase) >= 0;
+    }
+
+    #endregion
+}
@@ -1,7 +1,12 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Embeddings;
 using Microsoft.SemanticKernel.Orchestration;
 using Microsoft.SemanticKernel.Orchestration.Extensions;
 using Microsoft.SemanticKernel.SkillDefinition;
@@ -15,34 +20,107 @@ internal static class SKContextExtensions
         List<string>? excludedSkills = null,
         List<string>? excludedFunctions = null)
     {
-        var functions = context.GetAvailableFunctions(excludedSkills, excludedFunctions);
+        return context.GetFunctionsSnapshot(excludedSkills, excludedFunctions).Manual;
+    }
 
-        return string.Join("\n\n",
-            functions.Select(
-                x =>
-                {
-                    var inputs = string.Join("\n", x.Parameters.Select(p => $"    -${p.Name}: {p.Description}"));
-                    return $"  {x.SkillName}.{x.Name}:\n    description: {x.Description}\n    inputs:\n{inputs}";
-                }));
+    /// <summary>
+    /// Get the manual of the functions relevant to a goal, or of all the functions if no index is provided.
+    /// The embedding of the goal, if already generated by the generator of the index, avoids embedding the goal again.
+    /// </summary>
+    internal static async Task<string> GetFunctionsManualAsync(
+        this SKContext context,
+        string goal,
+        FunctionIndex? functionIndex,
+        List<string>? excludedSkills = null,
+        List<string>? excludedFunctions = null,
+        Embedding<float>? goalEmbedding = null)
+    {
+        FunctionsSnapshot snapshot = context.GetFunctionsSnapshot(excludedSkills, excludedFunctions);
+        if (functionIndex == null) { return snapshot.Manual; }
+
+        return ToManual(await functionIndex.GetRelevantFunctionsAsync(goal, goalEmbedding, snapshot.Functions, context.CancellationToken));
     }
 
-    // TODO: support more strategies, e.g. searching for relevant functions (by goal, by user preferences, etc.)
-    internal static List<FunctionView> GetAvailableFunctions(
+    // TODO: support more strategies, e.g. searching for relevant functions by user preferences
+    internal static IReadOnlyList<FunctionView> GetAvailableFunctions(
         this SKContext context,
         List<string>? excludedSkills = null,
         List<string>? excludedFunctions = null)
+    {
+        return context.GetFunctionsSnapshot(excludedSkills, excludedFunctions).Functions;
+    }
+
+    #region private ================================================================================
+
+    /// <summary>
+    /// Snapshots of the available functions, by skill collection and by exclusions.
+    /// Snapshots are replaced when the version of the skill collection changes.
+    /// </summary>
+    private static readonly ConditionalWeakTable<IReadOnlySkillCollection, ConcurrentDictionary<string, FunctionsSnapshot>> s_snapshots = new();
+
+    /// <summary>
+    /// Immutable list of the functions available at a version of the skill collection, and their manual.
+    /// </summary>
+    private sealed class FunctionsSnapshot
+    {
+        private string? _manual;
+
+        public FunctionsSnapshot(long version, IReadOnlyList<FunctionView> functions)
+        {
+            this.Version = version;
+            this.Functions = functions;
+        }
+
+        public long Version { get; }
+
+        public IReadOnlyList<FunctionView> Functions { get; }
+
+        // Concurrent readers might build the manual more than once, returning equal strings
+        public string Manual => this._manual ??= ToManual(this.Functions);
+    }
+
+    private static FunctionsSnapshot GetFunctionsSnapshot(
+        this SKContext context,
+        List<string>? excludedSkills,
+        List<string>? excludedFunctions)
     {
         excludedSkills ??= new();
         excludedFunctions ??= new();
 
         context.ThrowIfSkillCollectionNotSet();
+        IReadOnlySkillCollection skills = context.Skills!;
 
-        var functionsView = context.Skills!.GetFunctionsView();
+        // The version is read before listing the functions: functions added meanwhile cause a refresh at the next call
+        long version = skills.Version;
+        string key = string.Join("\n", excludedSkills) + "\n\n" + string.Join("\n", excludedFunctions);
+        ConcurrentDictionary<string, FunctionsSnapshot> snapshots = s_snapshots.GetValue(skills, _ => new(StringComparer.Ordinal));
+        if (snapshots.TryGetValue(key, out FunctionsSnapshot? snapshot) && snapshot.Version == version)
+        {
+            return snapshot;
+        }
 
-        return functionsView.SemanticFunctions
+        var functionsView = skills.GetFunctionsView();
+        snapshot = new FunctionsSnapshot(version, functionsView.SemanticFunctions
             .Concat(functionsView.NativeFunctions)
             .SelectMany(x => x.Value)
             .Where(s => !excludedSkills.Contains(s.SkillName) && !excludedFunctions.Contains(s.Name))
-            .ToList();
+            .ToList()
+            .AsReadOnly());
+
+        snapshots[key] = snapshot;
+        return snapshot;
+    }
+
+    private static string ToManual(IEnumerable<FunctionView> functions)
+    {
+        return string.Join("\n\n",
+            functions.Select(
+                x =>
+                {
+                    var inputs = string.Join("\n", x.Parameters.Select(p => $"    -${p.Name}: {p.Description}"));
+                    return $"  {x.SkillName}.{x.Name}:\n    description: {x.Description}\n    inputs:\n{inputs}";
+                }));
     }
+
+    #endregion
 }
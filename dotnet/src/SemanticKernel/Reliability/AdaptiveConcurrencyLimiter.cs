@@ -0,0 +1,277 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Limits the number of requests in flight to a backend endpoint, adapting the limit to the observed
+/// latency and to the throttling signals of the backend (AIMD): the limit grows by one request per
+/// round of successful requests, and is reduced when the backend throttles or the latency grows well
+/// above the latency observed without load. Requests above the limit wait in a FIFO queue.
+/// </summary>
+public sealed class AdaptiveConcurrencyLimiter
+{
+    /// <summary>
+    /// Result of a request, used to adapt the limit.
+    /// </summary>
+    public enum Outcome
+    {
+        /// <summary>
+        /// The request succeeded, its latency is used to adapt the limit.
+        /// </summary>
+        Success = 0,
+
+        /// <summary>
+        /// The backend is overloaded, e.g. 408, 429 and 5xx responses.
+        /// </summary>
+        Overload = 1,
+
+        /// <summary>
+        /// The request failed for reasons unrelated to the load, e.g. invalid requests. The limit is not changed.
+        /// </summary>
+        Ignore = 2,
+    }
+
+    /// <summary>
+    /// Permission to send a request, to release when the request is complete.
+    /// </summary>
+    public sealed class Lease
+    {
+        /// <summary>
+        /// Release the lease, letting the next queued request in.
+        /// </summary>
+        /// <param name="outcome">Result of the request</param>
+        public void Release(Outcome outcome)
+        {
+            if (Interlocked.Exchange(ref this._released, 1) == 1) { return; }
+
+            this._limiter.Release(this._startTime, outcome);
+        }
+
+        internal Lease(AdaptiveConcurrencyLimiter limiter, TimeSpan startTime)
+        {
+            this._limiter = limiter;
+            this._startTime = startTime;
+        }
+
+        private readonly AdaptiveConcurrencyLimiter _limiter;
+        private readonly TimeSpan _startTime;
+        private int _released;
+    }
+
+    /// <summary>
+    /// Create a new limiter.
+    /// </summary>
+    /// <param name="initialLimit">Initial number of requests allowed in flight</param>
+    /// <param name="minLimit">Min number of requests allowed in flight</param>
+    /// <param name="maxLimit">Max number of requests allowed in flight</param>
+    /// <param name="latencyTolerance">Ratio between the latency and the latency without load above which the limit is reduced</param>
+    /// <param name="backoffRatio">Ratio applied to the limit when the backend is overloaded</param>
+    public AdaptiveConcurrencyLimiter(
+        int initialLimit = 10,
+        int minLimit = 1,
+        int maxLimit = 200,
+        double latencyTolerance = 2.0,
+        double backoffRatio = 0.7)
+        : this(initialLimit, minLimit, maxLimit, latencyTolerance, backoffRatio, null)
+    {
+    }
+
+    /// <summary>
+    /// Current number of requests allowed in flight.
+    /// </summary>
+    public int CurrentLimit
+    {
+        get
+        {
+            lock (this._lock) { return (int)this._limit; }
+        }
+    }
+
+    /// <summary>
+    /// Number of requests in flight.
+    /// </summary>
+    public int InFlight
+    {
+        get
+        {
+            lock (this._lock) { return this._inFlight; }
+        }
+    }
+
+    /// <summary>
+    /// Number of requests waiting for a lease.
+    /// </summary>
+    public int QueueDepth
+    {
+        get
+        {
+            lock (this._lock) { return this._queue.Count; }
+        }
+    }
+
+    /// <summary>
+    /// Wait until a request can be sent.
+    /// </summary>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>The lease to release when the request is complete</returns>
+    public async Task<Lease> AcquireAsync(CancellationToken cancellationToken = default)
+    {
+        var waiter = new TaskCompletionSource<Lease>(TaskCreationOptions.RunContinuationsAsynchronously);
+        LinkedListNode<TaskCompletionSource<Lease>> node;
+        lock (this._lock)
+        {
+            if (this._queue.Count == 0 && this._inFlight < (int)this._limit)
+            {
+                this._inFlight++;
+                return new Lease(this, this._clock());
+            }
+
+            node = this._queue.AddLast(waiter);
+        }
+
+        using (cancellationToken.Register(() =>
+               {
+                   lock (this._lock)
+                   {
+                       // Leases already granted are not revoked
+                       if (node.List == null) { return; }
+
+                       this._queue.Remove(node);
+                   }
+
+                   waiter.TrySetCanceled(cancellationToken);
+               }))
+        {
+            return await waiter.Task;
+        }
+    }
+
+    #region internals ==============================================================================
+
+    internal AdaptiveConcurrencyLimiter(
+        int initialLimit,
+        int minLimit,
+        int maxLimit,
+        double latencyTolerance,
+        double backoffRatio,
+        Func<TimeSpan>? clock)
+    {
+        if (minLimit < 1) { throw new ArgumentOutOfRangeException(nameof(minLimit), "The min limit must be greater than zero"); }
+
+        if (maxLimit < minLimit) { throw new ArgumentOutOfRangeException(nameof(maxLimit), "The max limit must not be lower than the min limit"); }
+
+        if (latencyTolerance < 1) { throw new ArgumentOutOfRangeException(nameof(latencyTolerance), "The latency tolerance must be at least 1"); }
+
+        if (backoffRatio <= 0 || backoffRatio >= 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(backoffRatio), "The backoff ratio must be greater than 0 and lower than 1");
+        }
+
+        this._minLimit = minLimit;
+        this._maxLimit = maxLimit;
+        this._limit = Math.Min(maxLimit, Math.Max(minLimit, initialLimit));
+        this._latencyTolerance = latencyTolerance;
+        this._backoffRatio = backoffRatio;
+
+        if (clock == null)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            clock = () => stopwatch.Elapsed;
+        }
+
+        this._clock = clock;
+        this._lastDecrease = TimeSpan.MinValue;
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    // Rate at which the latency without load drifts towards the latest latencies, so that the
+    // limiter adapts when the backend becomes permanently slower, e.g. because of longer prompts
+    private const double BaselineDrift = 0.01;
+
+    private readonly object _lock = new();
+    private readonly LinkedList<TaskCompletionSource<Lease>> _queue = new();
+    private readonly Func<TimeSpan> _clock;
+    private readonly int _minLimit;
+    private readonly int _maxLimit;
+    private readonly double _latencyTolerance;
+    private readonly double _backoffRatio;
+    private double _limit;
+    private int _inFlight;
+    private double _baselineLatency = double.MaxValue;
+    private TimeSpan _lastDecrease;
+
+    private void Release(TimeSpan startTime, Outcome outcome)
+    {
+        var granted = new List<TaskCompletionSource<Lease>>();
+        lock (this._lock)
+        {
+            this._inFlight--;
+
+            TimeSpan now = this._clock();
+            double latency = (now - startTime).TotalMilliseconds;
+
+            switch (outcome)
+            {
+                case Outcome.Overload:
+                    this.Decrease(startTime, now, this._backoffRatio);
+                    break;
+
+                case Outcome.Success:
+                    this._baselineLatency = latency < this._baselineLatency
+                        ? latency
+                        : this._baselineLatency + ((latency - this._baselineLatency) * BaselineDrift);
+
+                    if (latency > this._baselineLatency * this._latencyTolerance)
+                    {
+                        // Requests are queueing inside the service: back off gently
+                        this.Decrease(startTime, now, Math.Sqrt(this._backoffRatio));
+                    }
+                    else if (this._inFlight + 1 >= this._limit / 2)
+                    {
+                        // Grow by one request per round of requests, only when the limit is in use
+                        this._limit = Math.Min(this._maxLimit, this._limit + (1 / this._limit));
+                    }
+
+                    break;
+            }
+
+            while (this._queue.Count > 0 && this._inFlight < (int)this._limit)
+            {
+                var waiter = this._queue.First!.Value;
+                this._queue.RemoveFirst();
+                this._inFlight++;
+                granted.Add(waiter);
+            }
+        }
+
+        foreach (var waiter in granted)
+        {
+            if (!waiter.TrySetResult(new Lease(this, this._clock())))
+            {
+                // Should not happen, cancelled waiters are removed from the queue
+                this.Release(TimeSpan.Zero, Outcome.Ignore);
+            }
+        }
+    }
+
+    private void Decrease(TimeSpan startTime, TimeSpan now, double ratio)
+    {
+        // Reduce the limit once per round: requests sent before the last decrease
+        // reflect the previous limit and don't reduce it again
+        if (startTime < this._lastDecrease) { return; }
+
+        this._limit = Math.Max(this._minLimit, this._limit * ratio);
+        this._lastDecrease = now;
+    }
+
+    #endregion
+}
@@ -0,0 +1,56 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Net;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// HTTP handler limiting the requests in flight to the endpoints registered with
+/// <see cref="RateLimiterRegistry.SetConcurrencyLimiter"/>. The handler runs inside the retry and hedging
+/// handlers, so that every attempt holds its own lease, no lease is held during the retry delays,
+/// and the limiter sees the latency and the status code of each attempt.
+/// </summary>
+internal sealed class ConcurrencyLimitingHandler : DelegatingHandler
+{
+    /// <inheritdoc/>
+    protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+    {
+        AdaptiveConcurrencyLimiter? limiter = request.RequestUri == null
+            ? null
+            : RateLimiterRegistry.GetConcurrencyLimiter(request.RequestUri.ToString());
+        if (limiter == null) { return await base.SendAsync(request, cancellationToken); }
+
+        // Cancelled attempts, e.g. the slower attempt of a hedged request, and network errors don't change the limit
+        var outcome = AdaptiveConcurrencyLimiter.Outcome.Ignore;
+        AdaptiveConcurrencyLimiter.Lease lease = await limiter.AcquireAsync(cancellationToken);
+        try
+        {
+            HttpResponseMessage response = await base.SendAsync(request, cancellationToken);
+            outcome = GetOutcome(response.StatusCode);
+            return response;
+        }
+        finally
+        {
+            lease.Release(outcome);
+        }
+    }
+
+    #region internals ==============================================================================
+
+    internal static AdaptiveConcurrencyLimiter.Outcome GetOutcome(HttpStatusCode statusCode)
+    {
+        int status = (int)statusCode;
+        if (statusCode is HttpStatusCode.TooManyRequests or HttpStatusCode.RequestTimeout || status >= 500)
+        {
+            return AdaptiveConcurrencyLimiter.Outcome.Overload;
+        }
+
+        return status < 400 ? AdaptiveConcurrencyLimiter.Outcome.Success : AdaptiveConcurrencyLimiter.Outcome.Ignore;
+    }
+
+    #endregion
+}
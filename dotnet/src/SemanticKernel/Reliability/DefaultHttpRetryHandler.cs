@@ -0,0 +1,189 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.Linq;
+using System.Net.Http;
+using System.Runtime.ExceptionServices;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Logging.Abstractions;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// HTTP handler retrying requests failed because of throttling, transient errors, and attempts exceeding
+/// <see cref="HttpRetryConfig.AttemptTimeout"/>. Requests cancelled by the caller or by the HttpClient timeout are not retried.
+/// The delay between retries is taken from the Retry-After, retry-after-ms and x-ms-retry-after-ms
+/// response headers when available, otherwise it uses exponential backoff with decorrelated jitter.
+/// When the retry budget or the max retry time stop the retries, the last response is returned, or the error of the last attempt is rethrown.
+/// </summary>
+public sealed class DefaultHttpRetryHandler : DelegatingHandler
+{
+    /// <summary>
+    /// Create a new handler, with a retry budget not shared with other handlers.
+    /// </summary>
+    /// <param name="config">Retry settings</param>
+    /// <param name="log">Logger</param>
+    public DefaultHttpRetryHandler(HttpRetryConfig? config = null, ILogger? log = null)
+        : this(config ?? new HttpRetryConfig(), null, log)
+    {
+    }
+
+    #region internals ==============================================================================
+
+    internal DefaultHttpRetryHandler(
+        HttpRetryConfig config,
+        RetryBudget? budget,
+        ILogger? log,
+        Func<TimeSpan, CancellationToken, Task>? delayProvider = null,
+        Func<double>? random = null)
+    {
+        this._config = config;
+        this._budget = budget ?? new RetryBudget(config.RetryBudgetRatio, config.MinRetryBudget);
+        this._log = log ?? NullLogger.Instance;
+        this._delayProvider = delayProvider ?? Task.Delay;
+        this._random = random ?? NextRandom;
+    }
+
+    #endregion
+
+    /// <inheritdoc/>
+    protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+    {
+        var stopwatch = Stopwatch.StartNew();
+        TimeSpan previousDelay = this._config.MinRetryDelay;
+        this._budget.Deposit();
+
+        for (int retryCount = 0; ; retryCount++)
+        {
+            HttpResponseMessage? response = null;
+            ExceptionDispatchInfo? error = null;
+            using (var attemptCancel = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken))
+            {
+                if (this._config.AttemptTimeout.HasValue) { attemptCancel.CancelAfter(this._config.AttemptTimeout.Value); }
+
+                try
+                {
+                    response = await base.SendAsync(request, attemptCancel.Token);
+                    if (!this._config.RetryableStatusCodes.Contains(response.StatusCode)) { return response; }
+                }
+                catch (Exception e) when (this.IsRetryable(e, cancellationToken) && retryCount < this._config.MaxRetryCount)
+                {
+                    this._log.LogWarning(e, "HTTP request failed: {0}", e.Message);
+                    error = ExceptionDispatchInfo.Capture(e);
+                }
+            }
+
+            if (retryCount >= this._config.MaxRetryCount)
+            {
+                this._log.LogWarning("HTTP request failed with status {0}, max number of retries reached", response!.StatusCode);
+                return response;
+            }
+
+            TimeSpan delay = GetRetryAfter(response) ?? this.GetBackoffDelay(previousDelay);
+            previousDelay = delay;
+
+            if (this._config.MaxTotalRetryTime.HasValue && stopwatch.Elapsed + delay > this._config.MaxTotalRetryTime.Value)
+            {
+                this._log.LogWarning("HTTP request failed, the retry delay {0} exceeds the max retry time", delay);
+                return response ?? Rethrow(error!);
+            }
+
+            if (!this._budget.TryWithdraw())
+            {
+                this._log.LogWarning("HTTP request failed, retry budget exhausted");
+                return response ?? Rethrow(error!);
+            }
+
+            this._log.LogWarning("Retrying HTTP request in {0} ms, retry {1} of {2}",
+                (int)delay.TotalMilliseconds, retryCount + 1, this._config.MaxRetryCount);
+
+            response?.Dispose();
+            await this._delayProvider(delay, cancellationToken);
+        }
+    }
+
+    #region private ================================================================================
+
+    private static readonly string[] s_retryAfterMsHeaders = { "retry-after-ms", "x-ms-retry-after-ms" };
+
+    [ThreadStatic]
+    private static Random? s_random;
+
+    private readonly HttpRetryConfig _config;
+    private readonly RetryBudget _budget;
+    private readonly ILogger _log;
+    private readonly Func<TimeSpan, CancellationToken, Task> _delayProvider;
+    private readonly Func<double> _random;
+
+    private static double NextRandom()
+    {
+        s_random ??= new Random(Guid.NewGuid().GetHashCode());
+        return s_random.NextDouble();
+    }
+
+    /// <summary>
+    /// Throw the error of the last attempt, with its original stack trace, when no more retries are allowed.
+    /// </summary>
+    private static HttpResponseMessage Rethrow(ExceptionDispatchInfo error)
+    {
+        error.Throw();
+        throw error.SourceException;
+    }
+
+    private bool IsRetryable(Exception e, CancellationToken cancellationToken)
+    {
+        // The token of the request is cancelled by the caller and by the HttpClient timeout, so a cancellation
+        // not coming from the request token can only be the attempt timeout
+        if (e is OperationCanceledException) { return !cancellationToken.IsCancellationRequested && this._config.AttemptTimeout.HasValue; }
+
+        return this._config.RetryableExceptionTypes.Any(type => type.IsInstanceOfType(e));
+    }
+
+    /// <summary>
+    /// Delay requested by the backend, if any.
+    /// </summary>
+    private static TimeSpan? GetRetryAfter(HttpResponseMessage? response)
+    {
+        if (response == null) { return null; }
+
+        foreach (string header in s_retryAfterMsHeaders)
+        {
+            if (response.Headers.TryGetValues(header, out var values)
+                && double.TryParse(values.FirstOrDefault(), NumberStyles.Float, CultureInfo.InvariantCulture, out double milliseconds)
+                && milliseconds >= 0)
+            {
+                return TimeSpan.FromMilliseconds(milliseconds);
+            }
+        }
+
+        var retryAfter = response.Headers.RetryAfter;
+        if (retryAfter?.Delta != null) { return retryAfter.Delta.Value; }
+
+        if (retryAfter?.Date != null)
+        {
+            TimeSpan delay = retryAfter.Date.Value - DateTimeOffset.UtcNow;
+            return delay > TimeSpan.Zero ? delay : TimeSpan.Zero;
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// Decorrelated jitter: random delay between the min delay and three times the previous delay.
+    /// See https://aws.amazon.com/blogs/architecture/exponential-backoff-and-jitter/
+    /// </summary>
+    private TimeSpan GetBackoffDelay(TimeSpan previousDelay)
+    {
+        double min = this._config.MinRetryDelay.TotalMilliseconds;
+        double max = this._config.UseExponentialBackoff ? Math.Max(min, previousDelay.TotalMilliseconds * 3) : min * 2;
+        double delay = min + (this._random() * (max - min));
+
+        return TimeSpan.FromMilliseconds(Math.Min(delay, this._config.MaxRetryDelay.TotalMilliseconds));
+    }
+
+    #endregion
+}
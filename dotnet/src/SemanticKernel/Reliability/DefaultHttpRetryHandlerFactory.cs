@@ -0,0 +1,40 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Net.Http;
+using Microsoft.Extensions.Logging;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Factory of <see cref="DefaultHttpRetryHandler"/> instances. The handlers created by the same factory
+/// share the retry budget.
+/// </summary>
+public sealed class DefaultHttpRetryHandlerFactory : IDelegatingHandlerFactory
+{
+    /// <summary>
+    /// Create a new factory.
+    /// </summary>
+    /// <param name="config">Retry settings, by default up to 3 retries with exponential backoff</param>
+    public DefaultHttpRetryHandlerFactory(HttpRetryConfig? config = null)
+    {
+        this.Config = config ?? new HttpRetryConfig();
+        this._budget = new RetryBudget(this.Config.RetryBudgetRatio, this.Config.MinRetryBudget);
+    }
+
+    /// <summary>
+    /// Retry settings.
+    /// </summary>
+    public HttpRetryConfig Config { get; }
+
+    /// <inheritdoc/>
+    public DelegatingHandler Create(ILogger? log)
+    {
+        return new DefaultHttpRetryHandler(this.Config, this._budget, log);
+    }
+
+    #region private ================================================================================
+
+    private readonly RetryBudget _budget;
+
+    #endregion
+}
@@ -0,0 +1,20 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Net.Http;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+internal static class DelegatingHandlerExtensions
+{
+    /// <summary>
+    /// Find the last handler of a chain of delegating handlers, where the chain is connected to the HTTP handler.
+    /// </summary>
+    /// <param name="handler">First handler of the chain</param>
+    /// <returns>The last delegating handler of the chain</returns>
+    internal static DelegatingHandler GetInnermostHandler(this DelegatingHandler handler)
+    {
+        while (handler.InnerHandler is DelegatingHandler inner) { handler = inner; }
+
+        return handler;
+    }
+}
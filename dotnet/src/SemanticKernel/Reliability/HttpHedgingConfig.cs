@@ -0,0 +1,47 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Hedging settings of the HTTP requests sent to the AI backends: when a request is slower than
+/// most recent requests to the same endpoint, a duplicate request is sent, and the first response wins.
+/// </summary>
+/// <remarks>
+/// When the deployment has a rate limiter, see <see cref="RateLimiterRegistry"/>, each duplicate is charged the same
+/// estimated tokens as the original request. A duplicate is sent only if the limiter can charge it immediately,
+/// so hedging never makes requests wait for quota nor exceed the limits of the deployment.
+/// </remarks>
+public sealed class HttpHedgingConfig
+{
+    /// <summary>
+    /// Percentile of the recent latencies of the operation after which a duplicate request is sent, between 0 and 1.
+    /// </summary>
+    public double LatencyPercentile { get; set; } = 0.95;
+
+    /// <summary>
+    /// Min delay before sending a duplicate request, regardless of the recent latencies.
+    /// </summary>
+    public TimeSpan MinHedgeDelay { get; set; } = TimeSpan.FromMilliseconds(200);
+
+    /// <summary>
+    /// Number of recent latencies tracked per operation, i.e. per endpoint and path.
+    /// </summary>
+    public int LatencyWindowSize { get; set; } = 200;
+
+    /// <summary>
+    /// Min number of latencies tracked before requests are hedged.
+    /// </summary>
+    public int MinLatencySamples { get; set; } = 20;
+
+    /// <summary>
+    /// Max ratio of duplicate requests over the requests sent, to keep the additional load bounded.
+    /// </summary>
+    public double HedgeBudgetRatio { get; set; } = 0.05;
+
+    /// <summary>
+    /// Initial hedge budget, i.e. number of duplicate requests allowed before the ratio applies.
+    /// </summary>
+    public int MinHedgeBudget { get; set; } = 5;
+}
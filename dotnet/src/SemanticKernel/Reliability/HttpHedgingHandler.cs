@@ -0,0 +1,192 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Net.Http;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Logging.Abstractions;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// HTTP handler cutting tail latency: when a request takes longer than a percentile of the recent
+/// latencies of the same operation, e.g. the completions of a deployment, a duplicate request is sent, the first successful response is used
+/// and the other request is cancelled. The number of duplicates is limited by a hedge budget.
+/// Duplicates of requests sent through a <see cref="TokenBucketRateLimiter"/> are charged to the same limiter,
+/// and are not sent when the limiter has no capacity left.
+/// </summary>
+public sealed class HttpHedgingHandler : DelegatingHandler
+{
+    /// <summary>
+    /// Create a new handler, with latency statistics and hedge budget not shared with other handlers.
+    /// </summary>
+    /// <param name="config">Hedging settings</param>
+    /// <param name="log">Logger</param>
+    public HttpHedgingHandler(HttpHedgingConfig? config = null, ILogger? log = null)
+        : this(config ?? new HttpHedgingConfig(), null, null, log)
+    {
+    }
+
+    #region internals ==============================================================================
+
+    internal HttpHedgingHandler(
+        HttpHedgingConfig config,
+        ConcurrentDictionary<string, LatencyTracker>? latencies,
+        RetryBudget? budget,
+        ILogger? log)
+    {
+        this._config = config;
+        this._latencies = latencies ?? new ConcurrentDictionary<string, LatencyTracker>(StringComparer.OrdinalIgnoreCase);
+        this._budget = budget ?? new RetryBudget(config.HedgeBudgetRatio, config.MinHedgeBudget);
+        this._log = log ?? NullLogger.Instance;
+    }
+
+    #endregion
+
+    /// <inheritdoc/>
+    protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+    {
+        // Latencies are tracked by endpoint and path, i.e. deployment and operation: completions
+        // and embeddings, or different models on the same endpoint, have very different latencies
+        LatencyTracker tracker = this._latencies.GetOrAdd(
+            request.RequestUri?.GetLeftPart(UriPartial.Path) ?? string.Empty,
+            _ => new LatencyTracker(this._config.LatencyWindowSize));
+        this._budget.Deposit();
+
+        // Buffer the content, so that the request can be duplicated
+        byte[]? body = request.Content == null ? null : await request.Content.ReadAsByteArrayAsync();
+
+        using var primaryCancellation = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken);
+        Task<HttpResponseMessage> primary = this.SendTimedAsync(request, tracker, primaryCancellation.Token);
+
+        TimeSpan? hedgeDelay = this.GetHedgeDelay(tracker);
+        if (hedgeDelay == null) { return await primary; }
+
+        using (var delayCancellation = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken))
+        {
+            if (await Task.WhenAny(primary, Task.Delay(hedgeDelay.Value, delayCancellation.Token)) == primary)
+            {
+                delayCancellation.Cancel();
+                return await primary;
+            }
+        }
+
+        cancellationToken.ThrowIfCancellationRequested();
+        if (!this._budget.TryWithdraw()) { return await primary; }
+
+        // The duplicate counts against the quotas of the deployment, and is not sent if it would have to wait
+        if (request.Properties.TryGetValue(TokenBucketRateLimiter.ChargeProperty, out object? value)
+            && value is TokenBucketRateLimiter.Charge charge
+            && !charge.Limiter.TryAcquire(charge.EstimatedTokens))
+        {
+            this._log.LogDebug("HTTP request slower than {0} ms, rate limit reached, not sending a duplicate request", (int)hedgeDelay.Value.TotalMilliseconds);
+            return await primary;
+        }
+
+        this._log.LogDebug("HTTP request slower than {0} ms, sending a duplicate request", (int)hedgeDelay.Value.TotalMilliseconds);
+
+        using var hedgeRequest = CloneRequest(request, body);
+        using var hedgeCancellation = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken);
+        Task<HttpResponseMessage> hedge = this.SendTimedAsync(hedgeRequest, tracker, hedgeCancellation.Token);
+
+        Task<HttpResponseMessage> first = await Task.WhenAny(primary, hedge);
+        Task<HttpResponseMessage> second = first == primary ? hedge : primary;
+        if (IsSuccess(first))
+        {
+            (first == primary ? hedgeCancellation : primaryCancellation).Cancel();
+            DisposeWhenComplete(second);
+            return await first;
+        }
+
+        // The first request failed: use the other one, unless it fails too
+        HttpResponseMessage? firstResponse = first.Status == TaskStatus.RanToCompletion ? first.Result : null;
+
+        // Observe the exception of the first request, which is not rethrown
+        _ = first.Exception;
+        try
+        {
+            HttpResponseMessage response = await second;
+            if (response.IsSuccessStatusCode || firstResponse == null)
+            {
+                firstResponse?.Dispose();
+                return response;
+            }
+
+            response.Dispose();
+            return firstResponse;
+        }
+        catch (Exception) when (firstResponse != null)
+        {
+            return firstResponse;
+        }
+    }
+
+    #region private ================================================================================
+
+    private readonly HttpHedgingConfig _config;
+    private readonly ConcurrentDictionary<string, LatencyTracker> _latencies;
+    private readonly RetryBudget _budget;
+    private readonly ILogger _log;
+
+    private async Task<HttpResponseMessage> SendTimedAsync(HttpRequestMessage request, LatencyTracker tracker, CancellationToken cancellationToken)
+    {
+        var stopwatch = Stopwatch.StartNew();
+        HttpResponseMessage response = await base.SendAsync(request, cancellationToken);
+
+        // Only successful requests describe the normal latency of the endpoint
+        if (response.IsSuccessStatusCode) { tracker.Add(stopwatch.Elapsed); }
+
+        return response;
+    }
+
+    private TimeSpan? GetHedgeDelay(LatencyTracker tracker)
+    {
+        if (tracker.Count < this._config.MinLatencySamples) { return null; }
+
+        TimeSpan? percentile = tracker.GetPercentile(this._config.LatencyPercentile);
+        if (percentile == null) { return null; }
+
+        return percentile.Value > this._config.MinHedgeDelay ? percentile.Value : this._config.MinHedgeDelay;
+    }
+
+    private static bool IsSuccess(Task<HttpResponseMessage> task)
+    {
+        return task.Status == TaskStatus.RanToCompletion && task.Result.IsSuccessStatusCode;
+    }
+
+    private static void DisposeWhenComplete(Task<HttpResponseMessage> task)
+    {
+        _ = task.ContinueWith(t =>
+        {
+            if (t.Status == TaskStatus.RanToCompletion) { t.Result.Dispose(); }
+
+            // Observe the exception of the cancelled request
+            _ = t.Exception;
+        }, TaskScheduler.Default);
+    }
+
+    private static HttpRequestMessage CloneRequest(HttpRequestMessage request, byte[]? body)
+    {
+        var clone = new HttpRequestMessage(request.Method, request.RequestUri) { Version = request.Version };
+        foreach (var header in request.Headers)
+        {
+            clone.Headers.TryAddWithoutValidation(header.Key, header.Value);
+        }
+
+        if (request.Content != null && body != null)
+        {
+            clone.Content = new ByteArrayContent(body);
+            foreach (var header in request.Content.Headers)
+            {
+                clone.Content.Headers.TryAddWithoutValidation(header.Key, header.Value);
+            }
+        }
+
+        return clone;
+    }
+
+    #endregion
+}
@@ -0,0 +1,52 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using System.Net.Http;
+using Microsoft.Extensions.Logging;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Factory of <see cref="HttpHedgingHandler"/> instances. The handlers created by the same factory share
+/// the latency statistics of the operations and the hedge budget. When a retry handler factory is provided,
+/// the hedging handler runs inside the retry handler, so that each retry is hedged too.
+/// </summary>
+public sealed class HttpHedgingHandlerFactory : IDelegatingHandlerFactory
+{
+    /// <summary>
+    /// Create a new factory.
+    /// </summary>
+    /// <param name="config">Hedging settings</param>
+    /// <param name="retryHandlerFactory">Optional factory of the retry handlers wrapping the hedging handlers</param>
+    public HttpHedgingHandlerFactory(HttpHedgingConfig? config = null, IDelegatingHandlerFactory? retryHandlerFactory = null)
+    {
+        this.Config = config ?? new HttpHedgingConfig();
+        this._retryHandlerFactory = retryHandlerFactory;
+        this._budget = new RetryBudget(this.Config.HedgeBudgetRatio, this.Config.MinHedgeBudget);
+    }
+
+    /// <summary>
+    /// Hedging settings.
+    /// </summary>
+    public HttpHedgingConfig Config { get; }
+
+    /// <inheritdoc/>
+    public DelegatingHandler Create(ILogger? log)
+    {
+        var hedgingHandler = new HttpHedgingHandler(this.Config, this._latencies, this._budget, log);
+        if (this._retryHandlerFactory == null) { return hedgingHandler; }
+
+        DelegatingHandler retryHandler = this._retryHandlerFactory.Create(log);
+        retryHandler.GetInnermostHandler().InnerHandler = hedgingHandler;
+        return retryHandler;
+    }
+
+    #region private ================================================================================
+
+    private readonly IDelegatingHandlerFactory? _retryHandlerFactory;
+    private readonly RetryBudget _budget;
+    private readonly ConcurrentDictionary<string, LatencyTracker> _latencies = new(StringComparer.OrdinalIgnoreCase);
+
+    #endregion
+}
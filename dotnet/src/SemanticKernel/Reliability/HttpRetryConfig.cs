@@ -0,0 +1,82 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Generic;
+using System.Net;
+using System.Net.Http;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Retry settings of the HTTP requests sent to the AI backends.
+/// The kernel retries requests by default, using these settings, see <see cref="Configuration.KernelConfig.SetDefaultHttpRetryConfig"/>.
+/// </summary>
+public sealed class HttpRetryConfig
+{
+    /// <summary>
+    /// Max number of retries of a request.
+    /// </summary>
+    public int MaxRetryCount { get; set; } = 3;
+
+    /// <summary>
+    /// Min delay between retries, when the backend doesn't specify a delay.
+    /// </summary>
+    public TimeSpan MinRetryDelay { get; set; } = TimeSpan.FromSeconds(2);
+
+    /// <summary>
+    /// Max delay between retries, when the backend doesn't specify a delay.
+    /// </summary>
+    public TimeSpan MaxRetryDelay { get; set; } = TimeSpan.FromSeconds(60);
+
+    /// <summary>
+    /// Max time spent on a request, including retries and delays. A request is not retried
+    /// if the next attempt would start after this deadline. Null means no deadline.
+    /// The default is shorter than the default HttpClient timeout of 100 seconds, because the HttpClient
+    /// timeout cancels the request including all its retries.
+    /// </summary>
+    public TimeSpan? MaxTotalRetryTime { get; set; } = TimeSpan.FromSeconds(90);
+
+    /// <summary>
+    /// Max time spent on a single attempt. Attempts taking longer are cancelled and retried.
+    /// Null means attempts are limited only by the HttpClient timeout, which is not retried.
+    /// </summary>
+    public TimeSpan? AttemptTimeout { get; set; }
+
+    /// <summary>
+    /// Whether to increase the delay between retries, using exponential backoff with decorrelated jitter.
+    /// When false, the delay is random between <see cref="MinRetryDelay"/> and twice the value.
+    /// </summary>
+    public bool UseExponentialBackoff { get; set; } = true;
+
+    /// <summary>
+    /// Ratio of retries allowed over the number of requests, shared by all the requests of a handler factory,
+    /// to avoid overloading a backend already in trouble. For instance 0.2 allows one retry every five requests.
+    /// </summary>
+    public double RetryBudgetRatio { get; set; } = 0.2;
+
+    /// <summary>
+    /// Initial retry budget, i.e. number of retries allowed before the ratio of retries over requests applies.
+    /// </summary>
+    public int MinRetryBudget { get; set; } = 10;
+
+    /// <summary>
+    /// HTTP status codes worth retrying: request timeouts returned by the backend, throttling and transient service errors.
+    /// </summary>
+    public IList<HttpStatusCode> RetryableStatusCodes { get; set; } = new List<HttpStatusCode>
+    {
+        HttpStatusCode.RequestTimeout,
+        HttpStatusCode.TooManyRequests,
+        HttpStatusCode.InternalServerError,
+        HttpStatusCode.BadGateway,
+        HttpStatusCode.ServiceUnavailable,
+        HttpStatusCode.GatewayTimeout,
+    };
+
+    /// <summary>
+    /// Exceptions worth retrying, e.g. network errors.
+    /// </summary>
+    public IList<Type> RetryableExceptionTypes { get; set; } = new List<Type>
+    {
+        typeof(HttpRequestException),
+    };
+}
@@ -0,0 +1,19 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System.Net.Http;
+using Microsoft.Extensions.Logging;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Factory of HTTP handlers added to the HTTP clients of the AI backends, e.g. to retry failed requests.
+/// </summary>
+public interface IDelegatingHandlerFactory
+{
+    /// <summary>
+    /// Create a new handler. The handler is owned and disposed by the HTTP client using it.
+    /// </summary>
+    /// <param name="log">Logger</param>
+    /// <returns>A new handler</returns>
+    DelegatingHandler Create(ILogger? log);
+}
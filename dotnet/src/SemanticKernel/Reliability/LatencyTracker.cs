@@ -0,0 +1,84 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Sliding window of the latest latencies of an endpoint, used to compute latency percentiles.
+/// Percentiles are computed on a sorted copy of the window, refreshed every few samples rather than
+/// on every query, so that busy endpoints don't sort the window on every request.
+/// </summary>
+internal sealed class LatencyTracker
+{
+    internal LatencyTracker(int windowSize, int? refreshInterval = null)
+    {
+        this._samples = new double[Math.Max(1, windowSize)];
+        this._sorted = new double[this._samples.Length];
+        this._refreshInterval = Math.Max(1, refreshInterval ?? this._samples.Length / 10);
+    }
+
+    /// <summary>
+    /// Number of latencies in the window.
+    /// </summary>
+    internal int Count
+    {
+        get
+        {
+            lock (this._lock) { return this._count; }
+        }
+    }
+
+    /// <summary>
+    /// Add a latency to the window, replacing the oldest one when the window is full.
+    /// </summary>
+    /// <param name="latency">Latency of a request</param>
+    internal void Add(TimeSpan latency)
+    {
+        lock (this._lock)
+        {
+            this._samples[this._next] = latency.TotalMilliseconds;
+            this._next = (this._next + 1) % this._samples.Length;
+            this._count = Math.Min(this._count + 1, this._samples.Length);
+            this._addedSinceSort++;
+        }
+    }
+
+    /// <summary>
+    /// Latency percentile of the window.
+    /// </summary>
+    /// <param name="percentile">Percentile, between 0 and 1</param>
+    /// <returns>The latency, or NULL if the window is empty</returns>
+    internal TimeSpan? GetPercentile(double percentile)
+    {
+        lock (this._lock)
+        {
+            if (this._count == 0) { return null; }
+
+            // Sort only when enough samples changed since the last sort
+            if (this._sortedCount == 0 || this._addedSinceSort >= this._refreshInterval)
+            {
+                Array.Copy(this._samples, this._sorted, this._count);
+                Array.Sort(this._sorted, 0, this._count);
+                this._sortedCount = this._count;
+                this._addedSinceSort = 0;
+            }
+
+            int index = (int)Math.Ceiling(Math.Min(Math.Max(percentile, 0), 1) * this._sortedCount) - 1;
+            return TimeSpan.FromMilliseconds(this._sorted[Math.Max(index, 0)]);
+        }
+    }
+
+    #region private ================================================================================
+
+    private readonly object _lock = new();
+    private readonly double[] _samples;
+    private readonly double[] _sorted;
+    private readonly int _refreshInterval;
+    private int _sortedCount;
+    private int _addedSinceSort;
+    private int _next;
+    private int _count;
+
+    #endregion
+}
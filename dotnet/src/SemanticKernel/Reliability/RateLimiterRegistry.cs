@@ -0,0 +1,127 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Collections.Concurrent;
+using Microsoft.SemanticKernel.Diagnostics;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Process wide rate limiters of the AI backends, one per endpoint and deployment, shared by all the
+/// clients sending requests to the same deployment, e.g. all the Azure OpenAI completion and embedding clients.
+/// Also holds the concurrency limiters of the endpoints, shared by all the clients sending requests to the same host.
+/// </summary>
+public static class RateLimiterRegistry
+{
+    /// <summary>
+    /// Set the quotas of a deployment. Requests sent to the deployment wait when the quotas are used up.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL, e.g. https://contoso.openai.azure.com</param>
+    /// <param name="deploymentName">Name of the deployment, or model ID</param>
+    /// <param name="requestsPerMinute">Max number of requests per minute, zero for no limit</param>
+    /// <param name="tokensPerMinute">Max number of tokens per minute, zero for no limit</param>
+    /// <returns>The rate limiter used for the deployment</returns>
+    public static TokenBucketRateLimiter SetLimits(string endpoint, string deploymentName, int requestsPerMinute, int tokensPerMinute)
+    {
+        var limiter = new TokenBucketRateLimiter(requestsPerMinute, tokensPerMinute);
+        SetLimiter(endpoint, deploymentName, limiter);
+        return limiter;
+    }
+
+    /// <summary>
+    /// Set the rate limiter of a deployment.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL, e.g. https://contoso.openai.azure.com</param>
+    /// <param name="deploymentName">Name of the deployment, or model ID</param>
+    /// <param name="limiter">Rate limiter</param>
+    public static void SetLimiter(string endpoint, string deploymentName, TokenBucketRateLimiter limiter)
+    {
+        Verify.NotNull(limiter, "The rate limiter is NULL");
+        s_limiters[GetKey(endpoint, deploymentName)] = limiter;
+    }
+
+    /// <summary>
+    /// Remove the rate limiter of a deployment.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL</param>
+    /// <param name="deploymentName">Name of the deployment, or model ID</param>
+    /// <returns>True if the deployment had a rate limiter</returns>
+    public static bool RemoveLimiter(string endpoint, string deploymentName)
+    {
+        return s_limiters.TryRemove(GetKey(endpoint, deploymentName), out _);
+    }
+
+    /// <summary>
+    /// Get the rate limiter of a deployment, if any.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL</param>
+    /// <param name="deploymentName">Name of the deployment, or model ID</param>
+    /// <returns>The rate limiter, or NULL if the deployment has no limits</returns>
+    public static TokenBucketRateLimiter? GetLimiter(string endpoint, string deploymentName)
+    {
+        return GetLimiterByKey(GetKey(endpoint, deploymentName));
+    }
+
+    /// <summary>
+    /// Limit the number of requests in flight to an endpoint, adapting the limit to the latency and the throttling of the backend.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL, e.g. https://contoso.openai.azure.com</param>
+    /// <param name="limiter">Concurrency limiter, or NULL to use a limiter with default settings</param>
+    /// <returns>The concurrency limiter used for the endpoint</returns>
+    public static AdaptiveConcurrencyLimiter SetConcurrencyLimiter(string endpoint, AdaptiveConcurrencyLimiter? limiter = null)
+    {
+        limiter ??= new AdaptiveConcurrencyLimiter();
+        s_concurrencyLimiters[GetEndpointKey(endpoint)] = limiter;
+        return limiter;
+    }
+
+    /// <summary>
+    /// Remove the concurrency limiter of an endpoint.
+    /// </summary>
+    /// <param name="endpoint">Endpoint URL</param>
+    /// <returns>True if the endpoint had a concurrency limiter</returns>
+    public static bool RemoveConcurrencyLimiter(string endpoint)
+    {
+        return s_concurrencyLimiters.TryRemove(GetEndpointKey(endpoint), out _);
+    }
+
+    /// <summary>
+    /// Get the concurrency limiter of an endpoint, if any.
+    /// </summary>
+    /// <param name="url">Endpoint URL, or URL of any request sent to the endpoint</param>
+    /// <returns>The concurrency limiter, or NULL if the endpoint has no limiter</returns>
+    public static AdaptiveConcurrencyLimiter? GetConcurrencyLimiter(string url)
+    {
+        if (s_concurrencyLimiters.IsEmpty) { return null; }
+
+        return s_concurrencyLimiters.TryGetValue(GetEndpointKey(url), out var limiter) ? limiter : null;
+    }
+
+    #region private ================================================================================
+
+    private static readonly ConcurrentDictionary<string, TokenBucketRateLimiter> s_limiters = new(StringComparer.OrdinalIgnoreCase);
+
+    private static readonly ConcurrentDictionary<string, AdaptiveConcurrencyLimiter> s_concurrencyLimiters = new(StringComparer.OrdinalIgnoreCase);
+
+    private static string GetEndpointKey(string url)
+    {
+        Verify.NotEmpty(url, "The endpoint cannot be empty");
+        return Uri.TryCreate(url, UriKind.Absolute, out Uri? uri) ? uri.GetLeftPart(UriPartial.Authority) : url.TrimEnd('/');
+    }
+
+    internal static TokenBucketRateLimiter? GetLimiterByKey(string key)
+    {
+        if (s_limiters.IsEmpty) { return null; }
+
+        return s_limiters.TryGetValue(key, out var limiter) ? limiter : null;
+    }
+
+    internal static string GetKey(string endpoint, string deploymentName)
+    {
+        Verify.NotEmpty(endpoint, "The endpoint cannot be empty");
+        Verify.NotEmpty(deploymentName, "The deployment name cannot be empty");
+        return endpoint.TrimEnd('/') + ":" + deploymentName;
+    }
+
+    #endregion
+}
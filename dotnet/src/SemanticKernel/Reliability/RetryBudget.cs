@@ -0,0 +1,57 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Limits the number of retries to a ratio of the requests sent. Each request deposits a fraction
+/// of a retry, and each retry withdraws one, so that retries stop when most requests are failing.
+/// </summary>
+internal sealed class RetryBudget
+{
+    internal RetryBudget(double ratio, int minRetries)
+    {
+        this._ratio = ratio < 0 ? 0 : ratio;
+        this._minRetries = minRetries < 0 ? 0 : minRetries;
+        this._balance = this._minRetries;
+    }
+
+    /// <summary>
+    /// Record a request, adding to the budget.
+    /// </summary>
+    internal void Deposit()
+    {
+        lock (this._lock)
+        {
+            // Cap the balance, so that a long period without errors doesn't allow a storm of retries
+            double max = this._minRetries + (this._ratio * MaxRequestsRemembered);
+            this._balance = System.Math.Min(max, this._balance + this._ratio);
+        }
+    }
+
+    /// <summary>
+    /// Try to take a retry from the budget.
+    /// </summary>
+    /// <returns>True if the retry is allowed</returns>
+    internal bool TryWithdraw()
+    {
+        lock (this._lock)
+        {
+            if (this._balance < 1) { return false; }
+
+            this._balance--;
+            return true;
+        }
+    }
+
+    #region private ================================================================================
+
+    // Number of past requests contributing to the budget
+    private const int MaxRequestsRemembered = 100;
+
+    private readonly object _lock = new();
+    private readonly double _ratio;
+    private readonly int _minRetries;
+    private double _balance;
+
+    #endregion
+}
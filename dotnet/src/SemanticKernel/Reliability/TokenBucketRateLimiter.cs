@@ -0,0 +1,263 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+
+using System;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.SemanticKernel.Reliability;
+
+/// <summary>
+/// Client side rate limiter enforcing a quota of requests per minute and a quota of tokens per minute,
+/// e.g. the quotas of an Azure OpenAI deployment. Requests are charged their estimated tokens up front,
+/// and the charge is corrected once the actual usage is known. Callers are served in FIFO order.
+/// </summary>
+public sealed class TokenBucketRateLimiter
+{
+    /// <summary>
+    /// Default fraction of the quotas used, leaving some room for estimation errors and for other clients.
+    /// </summary>
+    public const double DefaultUtilization = 0.95;
+
+    /// <summary>
+    /// Default time window used to size the buckets, i.e. how much of the quotas can be used in a burst.
+    /// </summary>
+    public static readonly TimeSpan DefaultBurstWindow = TimeSpan.FromSeconds(10);
+
+    /// <summary>
+    /// Create a new rate limiter.
+    /// </summary>
+    /// <param name="requestsPerMinute">Max number of requests per minute, zero for no limit</param>
+    /// <param name="tokensPerMinute">Max number of tokens per minute, zero for no limit</param>
+    /// <param name="utilization">Fraction of the quotas to use, between 0 and 1</param>
+    /// <param name="burstWindow">Time window used to size the buckets, the quotas are refilled continuously</param>
+    public TokenBucketRateLimiter(int requestsPerMinute, int tokensPerMinute, double utilization = DefaultUtilization, TimeSpan? burstWindow = null)
+        : this(requestsPerMinute, tokensPerMinute, utilization, burstWindow, null, null)
+    {
+    }
+
+    /// <summary>
+    /// Max number of requests per minute, zero for no limit.
+    /// </summary>
+    public int RequestsPerMinute { get; }
+
+    /// <summary>
+    /// Max number of tokens per minute, zero for no limit.
+    /// </summary>
+    public int TokensPerMinute { get; }
+
+    /// <summary>
+    /// Wait until a request with the given estimated number of tokens can be sent.
+    /// </summary>
+    /// <param name="estimatedTokens">Estimated tokens used by the request, e.g. prompt tokens plus max completion tokens</param>
+    /// <param name="cancellationToken">Cancellation token</param>
+    /// <returns>A task completed when the request can be sent</returns>
+    public async Task AcquireAsync(int estimatedTokens, CancellationToken cancellationToken = default)
+    {
+        var turn = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+        Task previous;
+        lock (this._lock)
+        {
+            previous = this._queueTail;
+            this._queueTail = turn.Task;
+        }
+
+        try
+        {
+            // Wait for the callers queued before this one
+            if (!previous.IsCompleted)
+            {
+                var cancelled = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+                using (cancellationToken.Register(() => cancelled.TrySetResult(true)))
+                {
+                    await Task.WhenAny(previous, cancelled.Task);
+                }
+
+                cancellationToken.ThrowIfCancellationRequested();
+            }
+
+            while (true)
+            {
+                TimeSpan wait;
+                lock (this._lock)
+                {
+                    this.Refill();
+
+                    // Requests larger than the bucket are sent when the bucket is full
+                    double tokens = Math.Min(Math.Max(estimatedTokens, 0), this._tokens.Capacity);
+                    wait = Max(this._requests.TimeUntil(1), this._tokens.TimeUntil(tokens));
+                    if (wait <= TimeSpan.Zero)
+                    {
+                        this._requests.Take(1);
+                        this._tokens.Take(tokens);
+                        return;
+                    }
+                }
+
+                await this._delayProvider(wait, cancellationToken);
+            }
+        }
+        finally
+        {
+            // Let the next caller in, only after the previous ones, even when this one is cancelled
+            _ = previous.ContinueWith(_ => turn.TrySetResult(true), CancellationToken.None,
+                TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+        }
+    }
+
+    /// <summary>
+    /// Correct the tokens charged for a request, once the actual usage is known.
+    /// </summary>
+    /// <param name="estimatedTokens">Tokens charged when the request was sent</param>
+    /// <param name="actualTokens">Tokens actually used</param>
+    public void Reconcile(int estimatedTokens, int actualTokens)
+    {
+        lock (this._lock)
+        {
+            this.Refill();
+            this._tokens.Take(Math.Min(actualTokens, this._tokens.Capacity) - Math.Min(estimatedTokens, this._tokens.Capacity));
+        }
+    }
+
+    #region internals ==============================================================================
+
+    /// <summary>
+    /// Key of the HTTP request property holding the <see cref="Charge"/> of the request, used by
+    /// <see cref="HttpHedgingHandler"/> to charge the duplicate requests to the same limiter.
+    /// </summary>
+    internal const string ChargeProperty = "SemanticKernel.RateLimiterCharge";
+
+    /// <summary>
+    /// Limiter charged for a request, and the tokens charged.
+    /// </summary>
+    internal sealed class Charge
+    {
+        internal Charge(TokenBucketRateLimiter limiter, int estimatedTokens)
+        {
+            this.Limiter = limiter;
+            this.EstimatedTokens = estimatedTokens;
+        }
+
+        internal TokenBucketRateLimiter Limiter { get; }
+
+        internal int EstimatedTokens { get; }
+    }
+
+    /// <summary>
+    /// Charge a request only if it can be sent immediately, without waiting and without passing the queued callers.
+    /// </summary>
+    /// <param name="estimatedTokens">Estimated tokens used by the request</param>
+    /// <returns>True if the request has been charged</returns>
+    internal bool TryAcquire(int estimatedTokens)
+    {
+        lock (this._lock)
+        {
+            if (!this._queueTail.IsCompleted) { return false; }
+
+            this.Refill();
+            double tokens = Math.Min(Math.Max(estimatedTokens, 0), this._tokens.Capacity);
+            if (Max(this._requests.TimeUntil(1), this._tokens.TimeUntil(tokens)) > TimeSpan.Zero) { return false; }
+
+            this._requests.Take(1);
+            this._tokens.Take(tokens);
+            return true;
+        }
+    }
+
+    internal TokenBucketRateLimiter(
+        int requestsPerMinute,
+        int tokensPerMinute,
+        double utilization,
+        TimeSpan? burstWindow,
+        Func<TimeSpan>? clock,
+        Func<TimeSpan, CancellationToken, Task>? delayProvider)
+    {
+        if (utilization <= 0 || utilization > 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(utilization), "The utilization must be greater than 0 and not greater than 1");
+        }
+
+        this.RequestsPerMinute = Math.Max(requestsPerMinute, 0);
+        this.TokensPerMinute = Math.Max(tokensPerMinute, 0);
+
+        TimeSpan window = burstWindow ?? DefaultBurstWindow;
+        this._requests = new Bucket(this.RequestsPerMinute * utilization, window);
+        this._tokens = new Bucket(this.TokensPerMinute * utilization, window);
+
+        if (clock == null)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            clock = () => stopwatch.Elapsed;
+        }
+
+        this._clock = clock;
+        this._lastRefill = clock();
+        this._delayProvider = delayProvider ?? Task.Delay;
+    }
+
+    #endregion
+
+    #region private ================================================================================
+
+    /// <summary>
+    /// Bucket refilled continuously at the quota rate, up to the amount allowed in the burst window.
+    /// A negative balance records usage above the estimates, and delays the next requests.
+    /// </summary>
+    private sealed class Bucket
+    {
+        internal Bucket(double perMinute, TimeSpan window)
+        {
+            this._perMillisecond = perMinute / TimeSpan.FromMinutes(1).TotalMilliseconds;
+            this.Capacity = perMinute <= 0 ? double.MaxValue : Math.Max(1, perMinute * window.TotalMinutes);
+            this._balance = this.Capacity;
+        }
+
+        internal double Capacity { get; }
+
+        internal void Refill(TimeSpan elapsed)
+        {
+            this._balance = Math.Min(this.Capacity, this._balance + (elapsed.TotalMilliseconds * this._perMillisecond));
+        }
+
+        internal void Take(double amount)
+        {
+            if (this._perMillisecond > 0) { this._balance = Math.Min(this.Capacity, this._balance - amount); }
+        }
+
+        internal TimeSpan TimeUntil(double amount)
+        {
+            if (this._perMillisecond <= 0 || this._balance >= amount) { return TimeSpan.Zero; }
+
+            // Round up, to avoid waking up just before the bucket has enough
+            return TimeSpan.FromMilliseconds(Math.Ceiling((amount - this._balance) / this._perMillisecond));
+        }
+
+        private readonly double _perMillisecond;
+        private double _balance;
+    }
+
+    private readonly object _lock = new();
+    private readonly Bucket _requests;
+    private readonly Bucket _tokens;
+    private readonly Func<TimeSpan> _clock;
+    private readonly Func<TimeSpan, CancellationToken, Task> _delayProvider;
+    private TimeSpan _lastRefill;
+    private Task _queueTail = Task.CompletedTask;
+
+    private void Refill()
+    {
+        TimeSpan now = this._clock();
+        TimeSpan elapsed = now - this._lastRefill;
+        this._lastRefill = now;
+
+        this._requests.Refill(elapsed);
+        this._tokens.Refill(elapsed);
+    }
+
+    private static TimeSpan Max(TimeSpan a, TimeSpan b)
+    {
+        return a > b ? a : b;
+    }
+
+    #endregion
+}
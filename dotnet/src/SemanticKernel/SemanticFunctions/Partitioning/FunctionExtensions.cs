@@ -1,7 +1,13 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 
+using System;
 using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.Diagnostics;
 using Microsoft.SemanticKernel.Orchestration;
 
 namespace Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
@@ -35,4 +41,210 @@ public static class FunctionExtensions
         context.Variables.Update(string.Join("\n", results));
         return context;
     }
+
+    /// <summary>
+    /// Extension method to aggregate partitioned results of a semantic function, processing
+    /// up to <paramref name="maxDegreeOfParallelism"/> partitions at the same time.
+    /// Each partition is processed with a copy of the context variables, and results are
+    /// aggregated in the same order as the input. If a partition fails, the partitions
+    /// not processed yet are skipped and the error is reported in the context returned.
+    /// </summary>
+    /// <param name="func">Semantic Kernel function</param>
+    /// <param name="partitionedInput">Input to aggregate.</param>
+    /// <param name="context">Semantic Kernel context.</param>
+    /// <param name="maxDegreeOfParallelism">Max number of partitions processed concurrently.</param>
+    /// <returns>Aggregated results.</returns>
+    public static async Task<SKContext> AggregatePartitionedResultsAsync(
+        this ISKFunction func,
+        IReadOnlyList<string> partitionedInput,
+        SKContext context,
+        int maxDegreeOfParallelism)
+    {
+        Verify.NotNull(partitionedInput, "The partitioned input cannot be NULL");
+        if (maxDegreeOfParallelism < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxDegreeOfParallelism), "The max degree of parallelism must be greater than zero");
+        }
+
+        if (maxDegreeOfParallelism == 1 || partitionedInput.Count < 2)
+        {
+            return await func.AggregatePartitionedResultsAsync(partitionedInput.ToList(), context);
+        }
+
+        (string[] results, SKContext? failure) = await InvokePartitionsAsync(func, partitionedInput, context, maxDegreeOfParallelism);
+        if (failure != null)
+        {
+            return context.Fail(failure.LastErrorDescription, failure.LastException);
+        }
+
+        context.Variables.Update(string.Join("\n", results));
+        return context;
+    }
+
+    /// <summary>
+    /// Extension method to reduce partitioned input to a single result with a tree reduction.
+    /// The function processes all partitions, then the results are grouped in batches fitting
+    /// <paramref name="maxResultTokens"/> and processed again, until the aggregated result fits
+    /// the budget. Each level processes up to <paramref name="maxDegreeOfParallelism"/> partitions
+    /// at the same time. Batches never exceed the budget, so a result that doesn't fit with the next
+    /// one is processed again on its own; the reduction stops when a level doesn't shrink the results.
+    /// </summary>
+    /// <param name="func">Semantic Kernel function, e.g. a summarization function</param>
+    /// <param name="partitionedInput">Input to reduce.</param>
+    /// <param name="context">Semantic Kernel context.</param>
+    /// <param name="tokenizer">Tokenizer used to measure the results.</param>
+    /// <param name="maxResultTokens">Max number of tokens of the result, and of each batch of intermediate results.</param>
+    /// <param name="maxDegreeOfParallelism">Max number of partitions processed concurrently.</param>
+    /// <returns>Reduced result.</returns>
+    public static async Task<SKContext> ReducePartitionedResultsAsync(
+        this ISKFunction func,
+        IReadOnlyList<string> partitionedInput,
+        SKContext context,
+        ITokenizer tokenizer,
+        int maxResultTokens,
+        int maxDegreeOfParallelism)
+    {
+        Verify.NotNull(partitionedInput, "The partitioned input cannot be NULL");
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+        if (maxResultTokens < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxResultTokens), "The max number of tokens must be greater than zero");
+        }
+
+        if (maxDegreeOfParallelism < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxDegreeOfParallelism), "The max degree of parallelism must be greater than zero");
+        }
+
+        IReadOnlyList<string> input = partitionedInput;
+        int previousTokens = int.MaxValue;
+        while (true)
+        {
+            (string[] results, SKContext? failure) = await InvokePartitionsAsync(func, input, context, maxDegreeOfParallelism);
+            if (failure != null)
+            {
+                return context.Fail(failure.LastErrorDescription, failure.LastException);
+            }
+
+            string result = string.Join("\n", results);
+            int resultTokens = tokenizer.CountTokens(result);
+            if (results.Length < 2 || resultTokens <= maxResultTokens || resultTokens >= previousTokens)
+            {
+                context.Variables.Update(result);
+                return context;
+            }
+
+            previousTokens = resultTokens;
+
+            input = GroupResults(results, tokenizer, maxResultTokens);
+        }
+    }
+
+    #region private ================================================================================
+
+    /// <summary>
+    /// Invoke the function on each partition, using a separate context for each partition.
+    /// </summary>
+    /// <returns>The results in the same order of the input, or the context of the first partition failed</returns>
+    private static async Task<(string[] Results, SKContext? Failure)> InvokePartitionsAsync(
+        ISKFunction func,
+        IReadOnlyList<string> partitionedInput,
+        SKContext context,
+        int maxDegreeOfParallelism)
+    {
+        var results = new string[partitionedInput.Count];
+        SKContext? failure = null;
+        int next = -1;
+
+        using var cancellation = CancellationTokenSource.CreateLinkedTokenSource(context.CancellationToken);
+
+        // Each worker takes the next partition to process until all partitions are done, or one fails
+        async Task ProcessPartitionsAsync()
+        {
+            int index;
+            while (!cancellation.IsCancellationRequested && (index = Interlocked.Increment(ref next)) < results.Length)
+            {
+                var partitionContext = new SKContext(
+                    context.Variables.Clone(), context.Memory, context.Skills, context.Log, cancellation.Token);
+                partitionContext.Variables.Update(partitionedInput[index]);
+
+                SKContext result;
+                try
+                {
+                    result = await func.InvokeAsync(partitionContext, cancel: cancellation.Token);
+                }
+                catch (OperationCanceledException) when (Volatile.Read(ref failure) != null)
+                {
+                    // Another partition failed
+                    return;
+                }
+#pragma warning disable CA1031 // We need to catch all exceptions to handle the execution state
+                catch (Exception e) when (e is not OperationCanceledException && !e.IsCriticalException())
+                {
+                    result = partitionContext.Fail(e.Message, e);
+                }
+#pragma warning restore CA1031
+
+                if (result.ErrorOccurred)
+                {
+                    Interlocked.CompareExchange(ref failure, result, null);
+                    cancellation.Cancel();
+                    return;
+                }
+
+                results[index] = result.Variables.ToString();
+            }
+        }
+
+        await Task.WhenAll(Enumerable
+            .Range(0, Math.Min(maxDegreeOfParallelism, partitionedInput.Count))
+            .Select(_ => ProcessPartitionsAsync()));
+
+        if (failure == null)
+        {
+            context.CancellationToken.ThrowIfCancellationRequested();
+        }
+
+        return (results, failure);
+    }
+
+    /// <summary>
+    /// Group consecutive results in batches fitting the given number of tokens.
+    /// A result that doesn't fit in a batch with other results is a batch on its own.
+    /// </summary>
+    private static List<string> GroupResults(IList<string> results, ITokenizer tokenizer, int maxTokens)
+    {
+        var batches = new List<string>();
+        var batch = new StringBuilder();
+        int batchTokens = 0;
+        int batchCount = 0;
+        foreach (string result in results)
+        {
+            int resultTokens = tokenizer.CountTokens(result);
+
+            // "+1" to account for the "new line" separating results
+            if (batchCount > 0 && batchTokens + resultTokens + 1 > maxTokens)
+            {
+                batches.Add(batch.ToString());
+                batch.Clear();
+                batchTokens = 0;
+                batchCount = 0;
+            }
+
+            if (batchCount > 0) { batch.Append('\n'); }
+
+            batch.Append(result);
+            batchTokens += resultTokens + 1;
+            batchCount++;
+        }
+
+        if (batchCount > 0)
+        {
+            batches.Add(batch.ToString());
+        }
+
+        return batches;
+    }
+
+    #endregion
 }
@@ -2,8 +2,9 @@
 
 using System;
 using System.Collections.Generic;
-using System.Linq;
 using System.Text;
+using Microsoft.SemanticKernel.AI.Tokenizers;
+using Microsoft.SemanticKernel.Diagnostics;
 
 namespace Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
 
@@ -12,6 +13,9 @@ namespace Microsoft.SemanticKernel.SemanticFunctions.Partitioning;
 /// For plain text, split looking at new lines first, then periods, and so on.
 /// For markdown, split looking at punctuation first, and so on.
 /// </summary>
+/// <remarks>
+/// Text is processed as slices of the input, and copied into new strings only once, when returning the result.
+/// </remarks>
 public static class SemanticTextPartitioner
 {
     /// <summary>
@@ -22,7 +26,20 @@ public static class SemanticTextPartitioner
     /// <returns>List of lines.</returns>
     public static List<string> SplitPlainTextLines(string text, int maxTokensPerLine)
     {
-        return InternalSplitPlaintextLines(text, maxTokensPerLine, true);
+        return ToStrings(InternalSplitLines(text, maxTokensPerLine, true, s_plaintextSplitOptions, TokenCounter.Estimate));
+    }
+
+    /// <summary>
+    /// Split plain text into lines, measuring text with the given tokenizer.
+    /// </summary>
+    /// <param name="text">Text to split</param>
+    /// <param name="maxTokensPerLine">Maximum number of tokens per line.</param>
+    /// <param name="tokenizer">Tokenizer used to count tokens.</param>
+    /// <returns>List of lines.</returns>
+    public static List<string> SplitPlainTextLines(string text, int maxTokensPerLine, ITokenizer tokenizer)
+    {
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+        return ToStrings(InternalSplitLines(text, maxTokensPerLine, true, s_plaintextSplitOptions, new TokenCounter(tokenizer)));
     }
 
     /// <summary>
@@ -33,7 +50,20 @@ public static class SemanticTextPartitioner
     /// <returns>List of lines.</returns>
     public static List<string> SplitMarkDownLines(string text, int maxTokensPerLine)
     {
-        return InternalSplitMarkdownLines(text, maxTokensPerLine, true);
+        return ToStrings(InternalSplitLines(text, maxTokensPerLine, true, s_markdownSplitOptions, TokenCounter.Estimate));
+    }
+
+    /// <summary>
+    /// Split markdown text into lines, measuring text with the given tokenizer.
+    /// </summary>
+    /// <param name="text">Text to split</param>
+    /// <param name="maxTokensPerLine">Maximum number of tokens per line.</param>
+    /// <param name="tokenizer">Tokenizer used to count tokens.</param>
+    /// <returns>List of lines.</returns>
+    public static List<string> SplitMarkDownLines(string text, int maxTokensPerLine, ITokenizer tokenizer)
+    {
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+        return ToStrings(InternalSplitLines(text, maxTokensPerLine, true, s_markdownSplitOptions, new TokenCounter(tokenizer)));
     }
 
     /// <summary>
@@ -44,7 +74,20 @@ public static class SemanticTextPartitioner
     /// <returns>List of paragraphs.</returns>
     public static List<string> SplitPlainTextParagraphs(List<string> lines, int maxTokensPerParagraph)
     {
-        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, text => InternalSplitPlaintextLines(text, maxTokensPerParagraph, false));
+        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, s_plaintextSplitOptions, TokenCounter.Estimate);
+    }
+
+    /// <summary>
+    /// Split plain text into paragraphs, measuring text with the given tokenizer.
+    /// </summary>
+    /// <param name="lines">Lines of text.</param>
+    /// <param name="maxTokensPerParagraph">Maximum number of tokens per paragraph.</param>
+    /// <param name="tokenizer">Tokenizer used to count tokens.</param>
+    /// <returns>List of paragraphs.</returns>
+    public static List<string> SplitPlainTextParagraphs(List<string> lines, int maxTokensPerParagraph, ITokenizer tokenizer)
+    {
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, s_plaintextSplitOptions, new TokenCounter(tokenizer));
     }
 
     /// <summary>
@@ -55,10 +98,55 @@ public static class SemanticTextPartitioner
     /// <returns>List of paragraphs.</returns>
     public static List<string> SplitMarkdownParagraphs(List<string> lines, int maxTokensPerParagraph)
     {
-        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, text => InternalSplitMarkdownLines(text, maxTokensPerParagraph, false));
+        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, s_markdownSplitOptions, TokenCounter.Estimate);
+    }
+
+    /// <summary>
+    /// Split markdown text into paragraphs, measuring text with the given tokenizer.
+    /// </summary>
+    /// <param name="lines">Lines of text.</param>
+    /// <param name="maxTokensPerParagraph">Maximum number of tokens per paragraph.</param>
+    /// <param name="tokenizer">Tokenizer used to count tokens.</param>
+    /// <returns>List of paragraphs.</returns>
+    public static List<string> SplitMarkdownParagraphs(List<string> lines, int maxTokensPerParagraph, ITokenizer tokenizer)
+    {
+        Verify.NotNull(tokenizer, "The tokenizer cannot be NULL");
+        return InternalSplitTextParagraphs(lines, maxTokensPerParagraph, s_markdownSplitOptions, new TokenCounter(tokenizer));
     }
 
-    private static List<string> InternalSplitTextParagraphs(List<string> lines, int maxTokensPerParagraph, Func<string, List<string>> longLinesSplitter)
+    #region private ================================================================================
+
+    // Separators used to split text, in order of preference. NULL means "split in the middle".
+    private static readonly char[]?[] s_plaintextSplitOptions =
+    {
+        new[] { '\n', '\r' },
+        new[] { '.' },
+        new[] { '?', '!' },
+        new[] { ';' },
+        new[] { ':' },
+        new[] { ',' },
+        new[] { ')', ']', '}' },
+        new[] { ' ' },
+        new[] { '-' },
+        null
+    };
+
+    private static readonly char[]?[] s_markdownSplitOptions =
+    {
+        new[] { '.' },
+        new[] { '?', '!' },
+        new[] { ';' },
+        new[] { ':' },
+        new[] { ',' },
+        new[] { ')', ']', '}' },
+        new[] { ' ' },
+        new[] { '-' },
+        new[] { '\n', '\r' },
+        null
+    };
+
+    private static List<string> InternalSplitTextParagraphs(
+        List<string> lines, int maxTokensPerParagraph, char[]?[] splitOptions, TokenCounter tokenCounter)
     {
         if (lines.Count == 0)
         {
@@ -66,28 +154,37 @@ public static class SemanticTextPartitioner
         }
 
         // Split long lines first
-        var truncatedLines = new List<string>();
+        var truncatedLines = new List<ReadOnlyMemory<char>>();
         foreach (var line in lines)
         {
-            truncatedLines.AddRange(longLinesSplitter(line));
+            truncatedLines.AddRange(InternalSplitLines(line, maxTokensPerParagraph, false, splitOptions, tokenCounter));
         }
 
-        lines = truncatedLines;
-
-        // Group lines in paragraphs
+        // Group lines in paragraphs, keeping a running count of the paragraph tokens
         var paragraphs = new List<string>();
         var currentParagraph = new StringBuilder();
-        foreach (var line in lines)
+        int currentParagraphTokens = 0;
+        foreach (var line in truncatedLines)
         {
+            int lineTokens = tokenCounter.Count(line.Span);
+
+            // The length based estimate is computed on the whole paragraph, other tokenizers are not additive
+            // and the paragraph count is approximated with the sum of the line counts.
+            int paragraphTokens = tokenCounter.IsLengthBased
+                ? tokenCounter.Count(currentParagraph.Length)
+                : currentParagraphTokens;
+
             // "+1" to account for the "new line" added by AppendLine()
-            if (TokenCount(currentParagraph.ToString()) + TokenCount(line) + 1 >= maxTokensPerParagraph &&
+            if (paragraphTokens + lineTokens + 1 >= maxTokensPerParagraph &&
                 currentParagraph.Length > 0)
             {
                 paragraphs.Add(currentParagraph.ToString().Trim());
                 currentParagraph.Clear();
+                currentParagraphTokens = 0;
             }
 
-            currentParagraph.AppendLine(line);
+            currentParagraph.Append(line).AppendLine();
+            currentParagraphTokens += lineTokens + 1;
         }
 
         if (currentParagraph.Length > 0)
@@ -102,7 +199,7 @@ public static class SemanticTextPartitioner
             var lastParagraph = paragraphs[^1];
             var secondLastParagraph = paragraphs[^2];
 
-            if (TokenCount(lastParagraph) < maxTokensPerParagraph / 4)
+            if (tokenCounter.Count(lastParagraph.AsSpan()) < maxTokensPerParagraph / 4)
             {
                 var lastParagraphTokens = lastParagraph.Split(' ', StringSplitOptions.RemoveEmptyEntries);
                 var secondLastParagraphTokens = secondLastParagraph.Split(' ', StringSplitOptions.RemoveEmptyEntries);
@@ -134,160 +231,149 @@ public static class SemanticTextPartitioner
         return paragraphs;
     }
 
-    private static List<string> InternalSplitPlaintextLines(string text, int maxTokensPerLine, bool trim)
+    private static List<ReadOnlyMemory<char>> InternalSplitLines(
+        string text, int maxTokensPerLine, bool trim, char[]?[] splitOptions, TokenCounter tokenCounter)
     {
         text = text.Replace("\r\n", "\n", StringComparison.OrdinalIgnoreCase);
 
-        var splitOptions = new List<List<char>?>
-        {
-            new List<char> { '\n', '\r' },
-            new List<char> { '.' },
-            new List<char> { '?', '!' },
-            new List<char> { ';' },
-            new List<char> { ':' },
-            new List<char> { ',' },
-            new List<char> { ')', ']', '}' },
-            new List<char> { ' ' },
-            new List<char> { '-' },
-            null
-        };
-
-        List<string>? result = null;
-        bool inputWasSplit;
-        foreach (var splitOption in splitOptions)
-        {
-            if (result is null)
-            {
-                result = Split(text, maxTokensPerLine, splitOption, trim, out inputWasSplit);
-            }
-            else
-            {
-                result = Split(result, maxTokensPerLine, splitOption, trim, out inputWasSplit);
-            }
+        var result = new List<ReadOnlyMemory<char>>();
+        bool inputWasSplit = Split(text.AsMemory(), maxTokensPerLine, splitOptions[0], trim, tokenCounter, result);
 
-            if (!inputWasSplit)
+        // Split again the chunks still too long, using the next separators
+        for (int option = 1; option < splitOptions.Length && inputWasSplit; option++)
+        {
+            var input = result;
+            result = new List<ReadOnlyMemory<char>>(input.Count);
+            inputWasSplit = false;
+            foreach (ReadOnlyMemory<char> item in input)
             {
-                break;
+                inputWasSplit |= Split(item, maxTokensPerLine, splitOptions[option], trim, tokenCounter, result);
             }
         }
 
-        return result ?? new List<string>();
+        return result;
     }
 
-    private static List<string> InternalSplitMarkdownLines(string text, int maxTokensPerLine, bool trim)
+    /// <summary>
+    /// Split the input in two, recursively, until the chunks are small enough.
+    /// </summary>
+    /// <returns>Whether the last level of recursion split the input</returns>
+    private static bool Split(
+        ReadOnlyMemory<char> input, int maxTokens, char[]? separators, bool trim, TokenCounter tokenCounter, List<ReadOnlyMemory<char>> result)
     {
-        text = text.Replace("\r\n", "\n", StringComparison.OrdinalIgnoreCase);
+        ReadOnlySpan<char> span = input.Span;
+        if (tokenCounter.Count(span) <= maxTokens)
+        {
+            result.Add(trim ? input.Trim() : input);
+            return false;
+        }
 
-        var splitOptions = new List<List<char>?>
+        int cutPoint = -1;
+        if (separators == null || separators.Length == 0)
         {
-            new List<char> { '.' },
-            new List<char> { '?', '!' },
-            new List<char> { ';', },
-            new List<char> { ':' },
-            new List<char> { ',', },
-            new List<char> { ')', ']', '}' },
-            new List<char> { ' ' },
-            new List<char> { '-' },
-            new List<char> { '\n', '\r' },
-            null
-        };
-
-        List<string>? result = null;
-        bool inputWasSplit;
-        foreach (var splitOption in splitOptions)
+            cutPoint = span.Length / 2;
+        }
+        else if (span.Length > 2)
         {
-            if (result is null)
-            {
-                result = Split(text, maxTokensPerLine, splitOption, trim, out inputWasSplit);
-            }
-            else
-            {
-                result = Split(result, maxTokensPerLine, splitOption, trim, out inputWasSplit);
-            }
+            cutPoint = FindCutPoint(span, separators);
+        }
 
-            if (!inputWasSplit)
+        if (cutPoint > 0)
+        {
+            var firstHalf = input.Slice(0, cutPoint);
+            var secondHalf = input.Slice(cutPoint);
+            if (trim)
             {
-                break;
+                firstHalf = firstHalf.Trim();
+                secondHalf = secondHalf.Trim();
             }
+
+            // Recursion
+            bool split1 = Split(firstHalf, maxTokens, separators, trim, tokenCounter, result);
+            bool split2 = Split(secondHalf, maxTokens, separators, trim, tokenCounter, result);
+
+            return split1 || split2;
         }
 
-        return result ?? new List<string>();
+        result.Add(trim ? input.Trim() : input);
+        return true;
     }
 
-    private static List<string> Split(IEnumerable<string> input, int maxTokens, List<char>? separators, bool trim, out bool inputWasSplit)
+    /// <summary>
+    /// Find the separator closest to the middle of the text, and return the position after it, or -1 if there are no separators.
+    /// </summary>
+    private static int FindCutPoint(ReadOnlySpan<char> input, char[] separators)
     {
-        inputWasSplit = false;
-        var result = new List<string>();
-        foreach (string text in input)
+        int half = input.Length / 2;
+        int cutPoint = -1;
+
+        // The last char is never a cut point
+        ReadOnlySpan<char> candidates = input.Slice(0, input.Length - 1);
+        int index = candidates.IndexOfAny(separators);
+        while (index >= 0)
         {
-            result.AddRange(Split(text, maxTokens, separators, trim, out bool split));
-            inputWasSplit = inputWasSplit || split;
+            if (Math.Abs(half - index) < Math.Abs(half - cutPoint))
+            {
+                cutPoint = index + 1;
+            }
+
+            // Separators after the middle are only going to be farther away
+            if (index >= half) { break; }
+
+            int next = candidates.Slice(index + 1).IndexOfAny(separators);
+            index = next < 0 ? -1 : index + 1 + next;
         }
 
-        return result;
+        return cutPoint;
     }
 
-    private static List<string> Split(string input, int maxTokens, List<char>? separators, bool trim, out bool inputWasSplit)
+    private static List<string> ToStrings(List<ReadOnlyMemory<char>> chunks)
     {
-        inputWasSplit = false;
-        var asIs = new List<string> { trim ? input.Trim() : input };
-        if (TokenCount(input) <= maxTokens)
+        var result = new List<string>(chunks.Count);
+        foreach (ReadOnlyMemory<char> chunk in chunks)
         {
-            return asIs;
+            result.Add(chunk.ToString());
         }
 
-        inputWasSplit = true;
-        var result = new List<string>();
+        return result;
+    }
 
-        int half = input.Length / 2;
-        int cutPoint = -1;
+    /// <summary>
+    /// Counts tokens using a tokenizer, or a rough estimate when no tokenizer is specified.
+    /// </summary>
+    private sealed class TokenCounter
+    {
+        /// <summary>
+        /// Rough estimate of 4 chars per token.
+        /// </summary>
+        internal static TokenCounter Estimate { get; } = new(null);
 
-        if (separators == null || separators.Count == 0)
+        internal TokenCounter(ITokenizer? tokenizer)
         {
-            cutPoint = half;
+            this._tokenizer = tokenizer;
         }
-        else if (input.Any(separators.Contains) && input.Length > 2)
-        {
-            for (var index = 0; index < input.Length - 1; index++)
-            {
-                if (!separators.Contains(input[index]))
-                {
-                    continue;
-                }
 
-                if (Math.Abs(half - index) < Math.Abs(half - cutPoint))
-                {
-                    cutPoint = index + 1;
-                }
-            }
-        }
+        /// <summary>
+        /// Whether the count depends only on the length of the text.
+        /// </summary>
+        internal bool IsLengthBased => this._tokenizer == null;
 
-        if (cutPoint > 0)
+        internal int Count(int length)
         {
-            var firstHalf = input[..cutPoint];
-            var secondHalf = input[cutPoint..];
-            if (trim)
-            {
-                firstHalf = firstHalf.Trim();
-                secondHalf = secondHalf.Trim();
-            }
+            return length / 4;
+        }
 
-            // Recursion
-            result.AddRange(Split(firstHalf, maxTokens, separators, trim, out bool split1));
-            result.AddRange(Split(secondHalf, maxTokens, separators, trim, out bool split2));
+        internal int Count(ReadOnlySpan<char> text)
+        {
+            if (this._tokenizer == null) { return this.Count(text.Length); }
 
-            inputWasSplit = split1 || split2;
+            if (this._tokenizer is HeuristicTokenizer) { return HeuristicTokenizer.CountTokens(text); }
 
-            return result;
+            return this._tokenizer.CountTokens(text.ToString());
         }
 
-        return asIs;
+        private readonly ITokenizer? _tokenizer;
     }
 
-    private static int TokenCount(string input)
-    {
-        // TODO: partitioning methods should be configurable to allow for different tokenization strategies
-        //       depending on the model to be called. For now, we use an extremely rough estimate.
-        return input.Length / 4;
-    }
+    #endregion
 }
@@ -137,7 +137,7 @@ public class PromptTemplateConfig
     public CompletionConfig Completion { get; set; } = new();
 
     /// <summary>
-    /// Default backends to use.
+    /// Default backends to use. The first backend is used, unless <see cref="RouteAcrossBackends"/> is enabled.
     /// </summary>
     [JsonPropertyName("default_backends")]
     [JsonPropertyOrder(5)]
@@ -152,6 +152,24 @@ public class PromptTemplateConfig
     [JsonIgnore(Condition = JsonIgnoreCondition.WhenWritingNull)]
     public InputConfig Input { get; set; } = new();
 
+    /// <summary>
+    /// Whether the function can reuse completions of similar prompts, when the kernel has a semantic completion cache.
+    /// Enable only for functions where small differences in the prompt don't change the expected result.
+    /// </summary>
+    [JsonPropertyName("semantic_cache")]
+    [JsonPropertyOrder(7)]
+    [JsonIgnore(Condition = JsonIgnoreCondition.WhenWritingDefault)]
+    public bool UseSemanticCache { get; set; } = false;
+
+    /// <summary>
+    /// Whether to spread requests across all the <see cref="DefaultBackends"/>, failing over to the next backend on errors.
+    /// Enable only when the backends host equivalent models.
+    /// </summary>
+    [JsonPropertyName("route_across_backends")]
+    [JsonPropertyOrder(8)]
+    [JsonIgnore(Condition = JsonIgnoreCondition.WhenWritingDefault)]
+    public bool RouteAcrossBackends { get; set; } = false;
+
     /// <summary>
     /// Remove some default properties to reduce the JSON complexity.
     /// </summary>
@@ -79,4 +79,10 @@ public interface IReadOnlySkillCollection
     /// <param name="includeNative">Whether to include native functions in the list</param>
     /// <returns>An object containing all the functions details</returns>
     FunctionsView GetFunctionsView(bool includeSemantic = true, bool includeNative = true);
+
+    /// <summary>
+    /// Version of the collection, incremented every time a function is added or replaced.
+    /// Data derived from the list of functions can be cached until the version changes.
+    /// </summary>
+    long Version { get; }
 }
@@ -69,4 +69,6 @@ internal class ReadOnlySkillCollection : IReadOnlySkillCollection
     {
         return this._skillCollection.GetFunctionsView(includeSemantic, includeNative);
     }
+
+    public long Version => this._skillCollection.Version;
 }
@@ -3,6 +3,7 @@
 using System;
 using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Threading;
 using Microsoft.Extensions.Logging;
 using Microsoft.Extensions.Logging.Abstractions;
 using Microsoft.SemanticKernel.Diagnostics;
@@ -44,6 +45,7 @@ public class SkillCollection : ISkillCollection
         }
 
         this._skillCollection[functionInstance.SkillName][functionInstance.Name] = functionInstance;
+        Interlocked.Increment(ref this._version);
 
         return this;
     }
@@ -59,6 +61,7 @@ public class SkillCollection : ISkillCollection
         }
 
         this._skillCollection[functionInstance.SkillName][functionInstance.Name] = functionInstance;
+        Interlocked.Increment(ref this._version);
         return this;
     }
 
@@ -130,6 +133,9 @@ public class SkillCollection : ISkillCollection
         return this.GetNativeFunction(GlobalSkill, functionName);
     }
 
+    /// <inheritdoc/>
+    public long Version => Interlocked.Read(ref this._version);
+
     /// <inheritdoc/>
     public FunctionsView GetFunctionsView(bool includeSemantic = true, bool includeNative = true)
     {
@@ -165,5 +171,7 @@ public class SkillCollection : ISkillCollection
 
     private readonly ConcurrentDictionary<string, ConcurrentDictionary<string, ISKFunction>> _skillCollection;
 
+    private long _version;
+
     #endregion
 }
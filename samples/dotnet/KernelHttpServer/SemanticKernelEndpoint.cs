@@ -1,6 +1,7 @@
 ﻿// Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT License.
 
+using System.Globalization;
 using System.Linq;
 using System.Net;
 using System.Text.Json;
@@ -15,6 +16,8 @@ namespace KernelHttpServer;
 
 public class SemanticKernelEndpoint
 {
+    private const int DefaultMaxSteps = 10;
+
     [Function("InvokeFunction")]
     public async Task<HttpResponseData> InvokeFunctionAsync(
         [HttpTrigger(AuthorizationLevel.Anonymous, "post", Route = "skills/{skillName}/invoke/{functionName}")]
@@ -67,7 +70,7 @@ public class SemanticKernelEndpoint
     public async Task<HttpResponseData> ExecutePlanAsync(
         [HttpTrigger(AuthorizationLevel.Anonymous, "post", Route = "planner/execute/{maxSteps?}")]
         HttpRequestData req,
-        FunctionContext executionContext, int? maxSteps = 10)
+        FunctionContext executionContext, int? maxSteps = DefaultMaxSteps)
     {
         var ask = await JsonSerializer.DeserializeAsync<Ask>(req.Body, new JsonSerializerOptions { PropertyNamingPolicy = JsonNamingPolicy.CamelCase });
 
@@ -92,18 +95,11 @@ public class SemanticKernelEndpoint
             contextVariables.Set(input.Key, input.Value);
         }
 
-        var planner = kernel.Skills.GetFunction("plannerskill", "executeplan");
+        // Execute the plan steps in a single call, without parsing the plan again after each step
+        contextVariables.Set("maxSteps", (maxSteps ?? DefaultMaxSteps).ToString(CultureInfo.InvariantCulture));
+        var planner = kernel.Skills.GetFunction("plannerskill", "runplan");
         var result = await kernel.RunAsync(contextVariables, planner);
-
-        var iterations = 1;
-
-        while (!result.Variables.ToPlan().IsComplete &&
-               result.Variables.ToPlan().IsSuccessful &&
-               iterations < maxSteps)
-        {
-            result = await kernel.RunAsync(result.Variables, planner);
-            iterations++;
-        }
+        result.Variables.Set("maxSteps", null);
 
         if (result.ErrorOccurred)
         {